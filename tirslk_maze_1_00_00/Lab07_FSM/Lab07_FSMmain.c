@@ -48,6 +48,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "../inc/clock.h"
 #include "../inc/LaunchPad.h"
 #include "../inc/Reflectance.h"
+#include "../inc/ReflectanceInt.h"
 #include "../inc/CortexM.h"
 #include "../inc/SysTickInts.h"
 #include "../inc/PWM.h"
@@ -94,6 +95,9 @@ State_t fsm[9]={
 State_t *Spt;  // pointer to the current state
 uint32_t Input;
 uint32_t Output;
+uint8_t LineData;    // latest 8-bit reflectance sample
+uint32_t LineTime;   // when it was taken, 2us
+uint32_t LineCount;  // its sequence number
 /*Run FSM continuously
 1) Output depends on State (display state on LED1, LED2 per slides)
 2) Wait depends on State
@@ -103,6 +107,9 @@ uint32_t Output;
 int main(void){
   Clock_Init48MHz();
   LaunchPad_Init();
+  Reflectance_Init();
+  ReflectanceInt_Init(0, 1000, 500);  // sample every 2 ms, 1 ms decay
+  EnableInterrupts();
   Spt = Center;
   while(1){
     Output = Spt->out;           // set output from FSM
@@ -110,7 +117,8 @@ int main(void){
     LaunchPad_Output(Spt -> LED2);
     Clock_Delay1ms(Spt->delay);   // wait
     //Input = LaunchPad_Input();    // read sensors
-    Input = Reflectance_Center(1000);
+    LineCount = ReflectanceInt_Get(&LineData, &LineTime);
+    Input = (LineData&0x18)>>3;   // same 2 bits as Reflectance_Center(1000)
     Spt = Spt->next[Input];       // next depends on input and current state
   }
 }
@@ -0,0 +1,1557 @@
+// Bench.c
+// Runs on a Linux host
+// Cycle-budget bench for the drivers in ../inc.  Each entry runs a
+// driver call repeatedly on the simulated MSP432 and reports the
+// virtual MCLK cycles per call (bus accesses, delays, interrupt
+// overhead; see Sim.h), how many of those cycles were spent in
+// interrupt handlers, and the host time per call.
+// Usage: Bench [name], where name selects the entries whose name
+// starts with it.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "msp.h"
+#include "Sim.h"
+#include "../inc/Clock.h"
+#include "../inc/CortexM.h"
+#include "../inc/Reflectance.h"
+#include "../inc/ReflectanceInt.h"
+#include "../inc/Motor.h"
+#include "../inc/Junction.h"
+#include "../inc/Tachometer.h"
+#include "../inc/SpeedControl.h"
+#include "../inc/Odometry.h"
+#include "../inc/FIFO.h"
+#include "../inc/FIFO0.h"
+#include "../inc/Baud.h"
+#include "../inc/UART0.h"
+#include "../inc/EUSCIA0.h"
+#include "../inc/UART1.h"
+#include "../inc/AP.h"
+#include "../inc/Telemetry.h"
+#include "../inc/Log.h"
+#include "../inc/Format.h"
+#include "../inc/TimerA2.h"
+#include "../inc/Profile.h"
+#include "../inc/Shell.h"
+#include "../inc/Nokia5110.h"
+#include "SNPSim.h"
+
+// QTR-8RC decay times in us, bit 7 (left) to bit 0 (right); a line under
+// sensors 4 and 3 holds them high much longer than the white floor
+static const uint32_t DecayTime[8] = {300, 320, 350, 2200, 2400, 380, 310, 290};
+
+static void LineUnderRobot(void){
+  int i;
+  for(i=0; i<8; i=i+1){
+    Sim_SetDecay(7, i, DecayTime[7-i]);
+  }
+}
+
+// Romi wheels: speed follows PWM duty with a 50 ms lag, 600 mm/s at
+// full duty; the encoders make 360 steps per 220 mm.  Encoder B leads
+// A by a quarter step going forward.
+#define FULLSPEED 600.0
+#define LAG 0.05
+struct wheel{
+  double position;  // steps
+  double speed;     // steps/s
+  uint64_t time;    // cycles at the last update
+};
+static struct wheel LeftWheel, RightWheel;
+static double Target(int ccr, uint8_t dirbit){
+  double v;
+  if((Sim_Port[3].OUT&0xC0) != 0xC0) return 0;   // drivers asleep
+  v = FULLSPEED*Sim_TimerA[0].CCR[ccr]/15000.0*360.0/220.0;
+  return (Sim_Port[5].OUT&dirbit)? -v : v;
+}
+// advance the wheel to now; returns A in bit 0, B in bit 1
+static uint8_t WheelAdvance(struct wheel *w, double target, uint64_t now, uint64_t *next){
+  double dt = (double)(now - w->time)/Sim_GetMCLK();
+  double frac, edge;
+  w->time = now;
+  w->position = w->position + w->speed*dt;
+  w->speed = target + (w->speed - target)*(dt/LAG < 30? exp(-dt/LAG) : 0);
+  frac = w->position - floor(w->position);
+  // time to the next quarter step, capped so duty changes are seen
+  edge = 0.0005;
+  if(w->speed > 1){
+    double q = (floor(frac*4) + 1)/4 - frac;
+    if(q/w->speed < edge) edge = q/w->speed + 1e-9;
+  }else if(w->speed < -1){
+    double q = frac - ceil(frac*4 - 1)/4;
+    if(q <= 0) q = 0.25;
+    if(q/-w->speed < edge) edge = q/-w->speed + 1e-9;
+  }
+  *next = now + (uint64_t)(edge*Sim_GetMCLK()) + 1;
+  return (frac < 0.5) | (((frac >= 0.75) || (frac < 0.25))<<1);
+}
+static uint8_t RightEncoder(uint32_t port, uint64_t now, uint64_t *next){
+  uint8_t ab = WheelAdvance(&RightWheel, Target(3, 0x20), now, next);
+  (void)port;                             // both lines are on P10
+  return ((ab&1)<<4)|((ab&2)<<4);         // P10.4 A, P10.5 B
+}
+static uint8_t LeftEncoder(uint32_t port, uint64_t now, uint64_t *next){
+  uint8_t ab = WheelAdvance(&LeftWheel, Target(4, 0x10), now, next);
+  return (port == 8)? (ab&1)<<2 : (ab&2)<<1;  // P8.2 A, P9.2 B
+}
+static void WheelsOnFloor(void){
+  memset(&LeftWheel, 0, sizeof(LeftWheel));
+  memset(&RightWheel, 0, sizeof(RightWheel));
+  LeftWheel.time = RightWheel.time = Sim_Now();
+  Sim_SetPortModel(10, 0x30, RightEncoder);
+  Sim_SetPortModel(8, 0x04, LeftEncoder);
+  Sim_SetPortModel(9, 0x04, LeftEncoder);
+}
+
+//********* benchmark bodies *********
+static volatile uint32_t Sink;  // keeps results alive
+
+static void ReflectanceInit(void){
+  Clock_Init48MHz();
+  Reflectance_Init();
+  LineUnderRobot();
+}
+static void ReflectanceRead(void){
+  Sink = Reflectance_Read(1000);
+}
+static void ReflectanceCenter(void){
+  Sink = Reflectance_Center(1000);
+}
+static void ReflectanceDecay(void){
+  uint16_t decay[8];
+  Sink = Reflectance_Decay(decay, 3000);
+}
+static void ReflectancePosition(void){
+  static uint8_t data;
+  Sink = Reflectance_Position(data);
+  data = data + 1;
+}
+// the loop Reflectance_Position() used to need, for comparison
+static int32_t PositionLoop(uint8_t data){
+  static const int32_t weight[8] = {332, 237, 142, 47, -47, -142, -237, -332};
+  int32_t sum = 0, count = 0;
+  int i;
+  for(i=0; i<8; i=i+1){
+    if(data&(1<<i)){
+      count = count + 1;
+      sum = sum + weight[i];
+    }
+  }
+  return count? sum/count : 333;
+}
+static void ReflectancePositionLoop(void){
+  static volatile uint8_t data;   // volatile keeps the loop from being hoisted
+  Sink = PositionLoop(data);
+  data = data + 1;
+}
+static void ReflectancePositionDecay(void){
+  static uint16_t decay[8] = {300, 320, 350, 2200, 2400, 380, 310, 290};
+  Sink = Reflectance_PositionDecay(decay);
+  decay[3] = decay[3] + 7;
+}
+static void ReflectanceStartEnd(void){
+  Reflectance_Start();
+  Sink = Reflectance_End();
+}
+
+static void ReflectanceIntInit(void){
+  ReflectanceInit();
+  ReflectanceInt_Init(0, 500, 250);  // 1 kHz, 500 us decay
+  EnableInterrupts();
+}
+static void ReflectanceIntGet(void){
+  uint8_t data;
+  uint32_t time;
+  Sink = ReflectanceInt_Get(&data, &time);
+}
+static void ReflectanceIntSample(void){  // one 1 ms sample period
+  Sim_Advance(48000);
+}
+
+// a line, as the sensor readings up to each distance
+struct segment{
+  int32_t end;          // mm
+  uint8_t data;
+};
+static uint8_t LineAt(const struct segment *line, int32_t mm){
+  while(line->end <= mm){
+    line = line + 1;
+  }
+  return line->data;
+}
+// a cross, a T and a dead end, repeating every 200 mm; past the T
+// the line is gone for longer than the look ahead, but it comes
+// back before a dead end would be reported
+static const struct segment MazeLine[] = {
+  {40, 0x18}, {59, 0xFF},                 // cross
+  {100, 0x18}, {119, 0xFF}, {145, 0x00},  // T
+  {160, 0x18}, {200, 0x00}                // dead end
+};
+static void JunctionInit(void){
+  Junction_Init(0);
+}
+static void JunctionSample(void){  // two samples per mm
+  static int32_t halfmm;
+  Sink = Junction_Sample(LineAt(MazeLine, (halfmm/2)%200), halfmm/2);
+  halfmm = halfmm + 1;
+}
+// each fixture must give its events, in order
+struct fixture{
+  const char *name;
+  const struct segment *line;
+  int32_t length;               // mm
+  enum JunctionType events[4];  // ends with NOJUNCTION
+  int32_t at[3];                // mm where each junction begins
+};
+static const struct segment StraightLine[] = {{300, 0x18}};
+static const struct segment TeeLine[] = {{100, 0x18}, {119, 0xFF}, {145, 0x00}, {300, 0x18}};
+static const struct segment CrossLine[] = {{40, 0x18}, {59, 0xFF}, {300, 0x18}};
+static const struct segment DeadEndLine[] = {{160, 0x18}, {300, 0x00}};
+static const struct segment GoalLine[] = {{100, 0x18}, {300, 0xFF}};
+// the robot keeps going instead of turning, so the line never comes back
+static const struct segment PastTeeLine[] = {{100, 0x18}, {119, 0xFF}, {300, 0x00}};
+static const struct segment PastLeftLine[] = {{100, 0x18}, {119, 0xF8}, {300, 0x00}};
+static const struct fixture Fixtures[] = {
+  {"straight", StraightLine, 300, {NOJUNCTION}, {0}},
+  {"T",        TeeLine,      300, {TJUNCTION, NOJUNCTION}, {100}},
+  {"cross",    CrossLine,    300, {CROSS, NOJUNCTION}, {40}},
+  {"dead end", DeadEndLine,  300, {DEADEND, NOJUNCTION}, {160}},
+  {"goal",     GoalLine,     300, {GOAL, NOJUNCTION}, {100}},
+  {"past T",   PastTeeLine,  300, {TJUNCTION, NOJUNCTION}, {100}},
+  {"past left", PastLeftLine, 300, {LEFTTURN, NOJUNCTION}, {100}},
+  {"maze",     MazeLine,     200, {CROSS, TJUNCTION, DEADEND, NOJUNCTION}, {40, 100, 160}}
+};
+#define NUMFIXTURES (sizeof(Fixtures)/sizeof(Fixtures[0]))
+// walk each fixture at two samples per mm
+static int JunctionCheck(void){
+  const struct fixture *f;
+  enum JunctionType type;
+  uint32_t i, n, confidence;
+  int32_t halfmm, distance;
+  for(i=0; i<NUMFIXTURES; i=i+1){
+    f = &Fixtures[i];
+    Junction_Init(0);
+    n = 0;
+    for(halfmm=0; halfmm<2*f->length; halfmm=halfmm+1){
+      if(Junction_Sample(LineAt(f->line, halfmm/2), halfmm/2) == NOJUNCTION) continue;
+      Junction_Get(&type, &confidence, &distance);
+      if((type != f->events[n]) || (distance < f->at[n] - 1) || (distance > f->at[n] + 1) || (confidence < 50)){
+        printf("Junction %s event %u is %d at %d mm, confidence %u\n", f->name,
+               (unsigned)n, (int)type, (int)distance, (unsigned)confidence);
+        return 1;
+      }
+      n = n + 1;
+    }
+    if(f->events[n] != NOJUNCTION){
+      printf("Junction %s gave %u events, missed %d\n", f->name, (unsigned)n, (int)f->events[n]);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void MotorInit(void){
+  Clock_Init48MHz();
+  Motor_Init();
+}
+static void MotorForward(void){
+  Motor_Forward(3000, 3000);
+}
+
+static void TachometerInit(void){
+  MotorInit();
+  WheelsOnFloor();
+  Tachometer_Init();
+  EnableInterrupts();
+  Motor_Forward(5000, 5000);    // 200 mm/s, 327 steps/s
+}
+static void TachometerGet(void){
+  uint32_t leftTach, rightTach;
+  enum TachDirection leftDir, rightDir;
+  int32_t leftSteps, rightSteps;
+  Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+  Sink = leftTach + rightTach;
+}
+static void Tachometer10ms(void){  // edge interrupts in 10 ms
+  Sim_Advance(480000);
+}
+
+static void SpeedControlInit(void){
+  Clock_Init48MHz();
+  WheelsOnFloor();
+  SpeedControl_Init(0);
+  EnableInterrupts();
+  SpeedControl_Set(200, 200);
+}
+static void SpeedControl10ms(void){  // one control tick and its edges
+  Sim_Advance(480000);
+}
+// run the loop for ticks periods; 0 if both wheels end within 5% of
+// the target and stay there for the last settle periods
+static int SpeedControlSettle(int32_t target, uint32_t ticks, uint32_t settle){
+  int32_t leftSpeed, rightSpeed;
+  uint32_t i;
+  for(i=1; i<=ticks; i=i+1){
+    Sim_Advance(480000);          // 10 ms
+    SpeedControl_Get(&leftSpeed, &rightSpeed);
+    if((i > ticks - settle) && ((leftSpeed < target*95/100) || (leftSpeed > target*105/100) ||
+       (rightSpeed < target*95/100) || (rightSpeed > target*105/100))){
+      printf("SpeedControl at %d mm/s read %d %d after %u periods\n", (int)target,
+             (int)leftSpeed, (int)rightSpeed, (unsigned)i);
+      return 1;
+    }
+  }
+  return 0;
+}
+// run a move that was just started, checking the profile speed each
+// period: it starts at PROFILE_MINSPEED, rises by at most
+// PROFILE_ACCEL, falls by at most that plus 2 mm/s for the encoder
+// steps (below 2*PROFILE_MINSPEED one step is too coarse to tell),
+// and stays at least PROFILE_MINSPEED and at most the cruise speed
+// until the move is done.  It must reach cruise if reach is 1
+// and not if 0.  Then the wheels stop within 1% + 2 steps of the
+// requested distance.
+static int ProfileMove(const char *name, int32_t cruise, int reach, int32_t leftExpect, int32_t rightExpect){
+  uint32_t leftTach, rightTach, i;
+  enum TachDirection leftDir, rightDir;
+  int32_t leftSteps, rightSteps, leftSpeed, rightSpeed, speed, last = 0, top = 0;
+  int32_t leftStart, rightStart;
+  Tachometer_Get(&leftTach, &leftDir, &leftStart, &rightTach, &rightDir, &rightStart);
+  for(i=0; (i<3000) && Profile_Busy(); i=i+1){
+    Sim_Advance(480000);          // one 10 ms period
+    speed = Profile_Speed();
+    if(Profile_Busy() && (((speed > last + PROFILE_ACCEL/SPEED_RATE) && (speed > PROFILE_MINSPEED)) ||
+       ((speed < last - PROFILE_ACCEL/SPEED_RATE - 2) && (last >= 2*PROFILE_MINSPEED)) ||
+       (speed < PROFILE_MINSPEED) || (speed > cruise))){
+      printf("Profile %s speed went from %d to %d mm/s in period %u\n", name, (int)last, (int)speed, (unsigned)i);
+      return 1;
+    }
+    if(speed > top) top = speed;
+    last = speed;
+  }
+  Sim_Advance(48000000);          // 1 s to coast to a stop
+  Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+  SpeedControl_Get(&leftSpeed, &rightSpeed);
+  leftSteps = leftSteps - leftStart;
+  rightSteps = rightSteps - rightStart;
+  if(Profile_Busy() || (Profile_Speed() != 0) || ((top == cruise) != reach) || (leftSpeed != 0) || (rightSpeed != 0) ||
+     (abs(leftSteps - leftExpect) > abs(leftExpect)/100 + 2) || (abs(rightSteps - rightExpect) > abs(rightExpect)/100 + 2)){
+    printf("Profile %s went %d %d steps, expected %d %d; top speed %d, end speed %d %d\n", name,
+           (int)leftSteps, (int)rightSteps, (int)leftExpect, (int)rightExpect, (int)top, (int)leftSpeed, (int)rightSpeed);
+    return 1;
+  }
+  return 0;
+}
+static int ProfileCheck(void){
+  Sim_Init();
+  Clock_Init48MHz();
+  WheelsOnFloor();
+  Profile_Init(0);
+  EnableInterrupts();
+  Profile_Straight(300, 300);     // 490 steps
+  if(ProfileMove("straight 300 mm", 300, 1, 490, 490)){
+    return 1;
+  }
+  Profile_Straight(-50, 300);     // too short to reach cruise speed
+  if(ProfileMove("back 50 mm", 300, 0, -81, -81)){
+    return 1;
+  }
+  Profile_Turn(90, 200);          // 179 steps of each wheel
+  if(ProfileMove("turn 90", 200, 1, -179, 179)){
+    return 1;
+  }
+  Profile_Straight(12000, 500);   // 19636 steps, the braking limit needs 64 bits
+  if(ProfileMove("straight 12 m", 500, 1, 19636, 19636)){
+    return 1;
+  }
+  SpeedControl_Stop();
+  return 0;
+}
+// from rest the wheels reach the target within 30 periods; held
+// saturated for half a second, the integrator does not wind up, so
+// the duty leaves saturation on the first period after the target
+// drops and the wheels settle as fast as they did from rest
+static int SpeedControlCheck(void){
+  Sim_Init();
+  SpeedControlInit();             // 200 mm/s
+  if(SpeedControlSettle(200, 100, 70)){
+    return 1;
+  }
+  SpeedControl_Set(900, 900);     // more than the 600 mm/s the wheels can do
+  Sim_Advance(50*480000);
+  if((Sim_TimerA[0].CCR[3] < 14998) || (Sim_TimerA[0].CCR[4] < 14998)){
+    printf("SpeedControl at 900 mm/s gave duty %u %u\n", (unsigned)Sim_TimerA[0].CCR[3],
+           (unsigned)Sim_TimerA[0].CCR[4]);
+    return 1;
+  }
+  SpeedControl_Set(200, 200);
+  Sim_Advance(2*480000);
+  if((Sim_TimerA[0].CCR[3] >= 14998) || (Sim_TimerA[0].CCR[4] >= 14998)){
+    printf("SpeedControl wound up, duty %u %u two periods after the target dropped\n",
+           (unsigned)Sim_TimerA[0].CCR[3], (unsigned)Sim_TimerA[0].CCR[4]);
+    return 1;
+  }
+  if(SpeedControlSettle(200, 100, 60)){
+    return 1;
+  }
+  SpeedControl_Stop();
+  return 0;
+}
+
+static void OdometryInit(void){
+  Odometry_Init();
+}
+static void OdometryUpdate(void){  // a gentle left arc
+  static int32_t left, right;
+  int32_t x, y, heading;
+  left = left + 3;
+  right = right + 4;
+  Odometry_Update(left, right);
+  Sink = Odometry_Get(&x, &y, &heading);
+}
+
+static void FifoInit(void){
+  TxFifo0_Init();
+}
+static void FifoPutGet(void){
+  char data;
+  TxFifo0_Put('a');
+  TxFifo0_Get(&data);
+  Sink = data;
+}
+
+static void FifoPutGetString(void){  // 16 characters each way
+  char data[16];
+  TxFifo0_PutString("0123456789ABCDEF");
+  Sink = TxFifo0_GetBlock(data, 16);
+}
+
+// fill TxFifo0 with strings until it wraps the buffer several times,
+// checking that the characters come out in order, that those that
+// did not fit are counted in TxFifo0Lost, and that TxFifo0_Room
+// gives the free space
+static int FifoCheck(void){
+  static const char text[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  static char shadow[20*sizeof(text)];            // everything that went in
+  char data[TX0FIFOSIZE];
+  uint32_t i, j, length, room, leave, put, in = 0, out = 0, lost = 0;
+  TxFifo0_Init();
+  for(i=0; i<20; i=i+1){
+    length = strlen(&text[i%10]);                   // 27 to 36 characters
+    room = TxFifo0_Room();
+    if(room != (TX0FIFOSIZE - 1) - TxFifo0_Size()){
+      printf("TxFifo0_Room %u with %u in TxFifo0\n", (unsigned)room, (unsigned)TxFifo0_Size());
+      return 1;
+    }
+    put = TxFifo0_PutString(&text[i%10]);
+    if(room > length) room = length;
+    lost = lost + length - room;
+    if((put != room) || (TxFifo0Lost != lost)){
+      printf("TxFifo0_PutString %u put %u, expected %u, lost %u, expected %u\n",
+             (unsigned)i, (unsigned)put, (unsigned)room, (unsigned)TxFifo0Lost, (unsigned)lost);
+      return 1;
+    }
+    memcpy(&shadow[in], &text[i%10], put);
+    in = in + put;
+    // leave 0 to 36 behind, so the next string wraps the buffer
+    // and every fourth one does not fit
+    leave = (i%4)*12;
+    if(leave > TxFifo0_Size()) leave = TxFifo0_Size();
+    put = TxFifo0_GetBlock(data, TxFifo0_Size() - leave);
+    for(j=0; j<put; j=j+1){
+      if(data[j] != shadow[out]){
+        printf("TxFifo0 gave '%c', expected '%c'\n", data[j], shadow[out]);
+        return 1;
+      }
+      out = out + 1;
+    }
+  }
+  if((lost == 0) || (in < 4*TX0FIFOSIZE)){
+    printf("TxFifo0 check lost %u and put %u, it did not fill and wrap\n", (unsigned)lost, (unsigned)in);
+    return 1;
+  }
+  return 0;
+}
+
+// a queue of structs from the same generator
+struct sample{
+  uint8_t data;
+  uint32_t time;
+};
+AddIndexFifo(SampleFifo, 16, struct sample)
+static void SampleFifoInit(void){
+  SampleFifo_Init();
+}
+static void SampleFifoPutGet(void){
+  static struct sample s;
+  s.time = s.time + 1;
+  SampleFifo_Put(s);
+  SampleFifo_Get(&s);
+  Sink = s.time;
+}
+
+// number formatting; the values are spread over all digit counts
+static char FormatBuf[FORMAT_SIZE];
+static volatile uint32_t FormatValue = 1;  // volatile keeps the work in the loop
+static uint32_t FormatNext(void){
+  uint32_t n = FormatValue;
+  FormatValue = n*1664525 + 1013904223;
+  return n>>(n&0x1F);
+}
+static void FormatUDec(void){
+  Sink = Format_UDec(FormatBuf, FormatNext(), 0);
+}
+static void FormatUFix2(void){
+  Sink = Format_UFix(FormatBuf, FormatNext(), 2, 0);
+}
+// the recursion UART0_OutUDec() used to do, into a buffer for comparison
+static uint32_t UDecLoop(char *buf, uint32_t n){
+  uint32_t i = 0;
+  if(n >= 10){
+    i = UDecLoop(buf, n/10);
+    n = n%10;
+  }
+  buf[i] = n + '0';
+  buf[i+1] = 0;
+  return i + 1;
+}
+static void FormatUDecLoop(void){
+  Sink = UDecLoop(FormatBuf, FormatNext());
+}
+static void FormatUFix2Loop(void){
+  uint32_t n = FormatNext(), i;
+  i = UDecLoop(FormatBuf, n/100);
+  FormatBuf[i] = '.';
+  n = n%100;
+  UDecLoop(&FormatBuf[i+1], n/10);
+  Sink = UDecLoop(&FormatBuf[i+2], n%10);
+}
+// every formatter against the C library
+static int FormatCheck(void){
+  static const uint32_t edge[] = {0, 9, 10, 99, 100, 999, 1000, 9999, 10000, 99999, 100000,
+    999999999, 1000000000, 2147483647, 2147483648u, 4294967295u};
+  char expect[32];
+  uint32_t i, n;
+  int32_t m;
+  for(i=0; i<100000; i=i+1){
+    n = (i < sizeof(edge)/sizeof(edge[0]))? edge[i] : FormatNext();
+    m = (int32_t)n;
+    Format_UDec(FormatBuf, n, 0); snprintf(expect, sizeof(expect), "%u", (unsigned)n);
+    if(strcmp(FormatBuf, expect)) break;
+    Format_UDec(FormatBuf, n, 5);
+    snprintf(expect, sizeof(expect), (n > 99999)? "*****" : "%5u", (unsigned)n);
+    if(strcmp(FormatBuf, expect)) break;
+    Format_SDec(FormatBuf, m, 0); snprintf(expect, sizeof(expect), "%d", (int)m);
+    if(strcmp(FormatBuf, expect)) break;
+    Format_SDec(FormatBuf, (int16_t)m, 6); snprintf(expect, sizeof(expect), "%6d", (int)(int16_t)m);
+    if(strcmp(FormatBuf, expect)) break;
+    Format_UFix(FormatBuf, n, 1, 0); snprintf(expect, sizeof(expect), "%u.%u", (unsigned)(n/10), (unsigned)(n%10));
+    if(strcmp(FormatBuf, expect)) break;
+    Format_UFix(FormatBuf, n, 2, 0); snprintf(expect, sizeof(expect), "%u.%02u", (unsigned)(n/100), (unsigned)(n%100));
+    if(strcmp(FormatBuf, expect)) break;
+    Format_UFix(FormatBuf, n%1000, 1, 4); snprintf(expect, sizeof(expect), (n%1000 > 999)? "****" : "%2u.%u",
+                                                   (unsigned)(n%1000/10), (unsigned)(n%10));
+    if(strcmp(FormatBuf, expect)) break;
+    Format_UFix(FormatBuf, n, 5, 0); snprintf(expect, sizeof(expect), "%u.%05u", (unsigned)(n/100000), (unsigned)(n%100000));
+    if(strcmp(FormatBuf, expect)) break;
+    Format_UHex(FormatBuf, n, 0); snprintf(expect, sizeof(expect), "%X", (unsigned)n);
+    if(strcmp(FormatBuf, expect)) break;
+    Format_UHex(FormatBuf, n, 2); snprintf(expect, sizeof(expect), "%02X", (unsigned)(n&0xFF));
+    if(strcmp(FormatBuf, expect)) break;
+  }
+  if(i < 100000){
+    printf("Format of %u gave \"%s\", expected \"%s\"\n", (unsigned)n, FormatBuf, expect);
+    return 1;
+  }
+  return 0;
+}
+
+// the settings from Baud.h must match the manual's table, and
+// the edges of a frame must stay within a few percent of a bit
+static int BaudCheck(void){
+  static const uint32_t baud[8] = {9600, 19200, 38400, 57600, 115200, 230400, 460800, 1000000};
+  int32_t error;
+  int i;
+  if((BAUD_BRW(9600) != 78) || (BAUD_MCTLW(9600) != 0x0021) ||
+     (BAUD_BRW(57600) != 13) || (BAUD_MCTLW(57600) != 0x2501) ||
+     (BAUD_BRW(115200) != 6) || (BAUD_MCTLW(115200) != 0x2081) ||
+     (BAUD_BRW(230400) != 3) || (BAUD_MCTLW(230400) != 0x0241)){
+    printf("Baud settings for 115200 are %u 0x%04X\n", (unsigned)BAUD_BRW(115200), (unsigned)BAUD_MCTLW(115200));
+    return 1;
+  }
+  for(i=0; i<8; i=i+1){
+    error = Baud_Error(baud[i], BAUD_BRW(baud[i]), BAUD_MCTLW(baud[i]));
+    if((error > 250) || (error < -250)){
+      printf("Baud %u has an edge %d.%02d%% of a bit off\n", (unsigned)baud[i], (int)(error/100), (int)((error < 0? -error : error)%100));
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void Uart0Init(void){
+  Clock_Init48MHz();
+  UART0_Init();
+}
+static void Uart0Init1M(void){
+  Clock_Init48MHz();
+  UART0_InitBaud(1000000);
+}
+static void Uart0OutUDec(void){
+  UART0_OutUDec(4294967295u);
+}
+static void Uart0OutUFix2(void){
+  UART0_OutUFix2(9999);
+}
+
+static void Euscia0Init(void){
+  Clock_Init48MHz();
+  EUSCIA0_Init();
+  EnableInterrupts();
+}
+// each call is sized to fit TxFifo0 and then drained, so the
+// benches time the formatting and the put, not the line
+static void Euscia0Drain(void){
+  while(TxFifo0_Size()){
+    Sim_Advance(4800);            // 100 us
+  }
+}
+static void Euscia0OutUDec(void){
+  EUSCIA0_OutUDec(4294967295u);
+  Euscia0Drain();
+}
+
+static void Euscia0OutString(void){
+  EUSCIA0_OutString("0123456789");
+  Euscia0Drain();
+}
+// a string and then single characters, each much longer than TxFifo0:
+// the output waits for room, so every character arrives in order and
+// neither TxFifo0Lost nor TxHistogram counts the waiting
+extern uint32_t TxHistogram[TX0FIFOSIZE];   // FIFO0.c
+static char Euscia0Text[201];
+static uint32_t Euscia0Seen, Euscia0Wrong;
+static void Euscia0Sink(uint8_t data){
+  if(data != (uint8_t)Euscia0Text[Euscia0Seen%200]){
+    Euscia0Wrong = Euscia0Wrong + 1;
+  }
+  Euscia0Seen = Euscia0Seen + 1;
+}
+static int Euscia0Check(void){
+  uint32_t i, puts = 0;
+  for(i=0; i<200; i=i+1){
+    Euscia0Text[i] = 'A' + i%26;
+  }
+  Euscia0Text[200] = 0;
+  Sim_Init();
+  Euscia0Init();
+  Sim_SetUartSink(0, &Euscia0Sink);
+  Euscia0Seen = Euscia0Wrong = 0;
+  for(i=0; i<TX0FIFOSIZE; i=i+1){
+    puts = puts - TxHistogram[i];
+  }
+  EUSCIA0_OutString(Euscia0Text);
+  for(i=0; i<200; i=i+1){
+    EUSCIA0_OutChar(Euscia0Text[i]);
+  }
+  Euscia0Drain();
+  Sim_Advance(48000);             // 1 ms for the last character
+  for(i=0; i<TX0FIFOSIZE; i=i+1){
+    puts = puts + TxHistogram[i];
+  }
+  Sim_SetUartSink(0, 0);
+  if(TxFifo0Lost || (Euscia0Seen != 400) || Euscia0Wrong || (puts > 200 + 200)){
+    printf("EUSCIA0 sent %u of 400 characters, %u wrong, TxFifo0Lost %u, %u puts\n",
+           (unsigned)Euscia0Seen, (unsigned)Euscia0Wrong, (unsigned)TxFifo0Lost, (unsigned)puts);
+    return 1;
+  }
+  return 0;
+}
+
+static void Uart1Init(void){
+  Clock_Init48MHz();
+  UART1_Init();
+  EnableInterrupts();
+}
+static void Uart1OutString(void){
+  UART1_OutString((uint8_t *)"0123456789");
+  UART1_FinishOutput();
+}
+// a 20-byte NPI frame, queued at once; the isr column is the
+// CPU time the transmit interrupt takes from the main program
+static void Uart1OutBuffer(void){
+  static const uint8_t frame[20] = {0xFE,15,0x00,0x55,0x89,0,0,0x1E,0,0,0x01,1,2,3,4,5,6,7,8,0};
+  UART1_OutBuffer(frame, 20);
+  UART1_FinishOutput();
+}
+
+// the TxDone task must run once each time the output drains, after
+// the last byte, even when a byte is queued just as the one before it
+// finishes; the second byte is queued at every cycle across the end of
+// the first, and an empty block must not report a completion
+static uint32_t Uart1Queued, Uart1Sent, Uart1Done, Uart1Early;
+static void Uart1Sink(uint8_t data){
+  (void)data;
+  Uart1Sent = Uart1Sent + 1;
+}
+static void Uart1DoneTask(void){
+  Uart1Done = Uart1Done + 1;
+  if(Uart1Sent != Uart1Queued){
+    Uart1Early = Uart1Early + 1;   // bytes still to go
+  }
+}
+// a block and then single bytes, each longer than the 256-byte
+// TxFifo: the output waits for room, so every byte arrives and
+// TxFifoLost stays 0
+extern uint32_t TxFifoLost;       // UART1.c
+static int Uart1LongCheck(void){
+  static uint8_t block[600];
+  uint32_t i;
+  for(i=0; i<sizeof(block); i=i+1){
+    block[i] = (uint8_t)i;
+  }
+  Sim_Init();
+  Uart1Init();
+  Sim_SetUartSink(2, &Uart1Sink);
+  Uart1Sent = 0;
+  UART1_OutBuffer(block, sizeof(block));
+  for(i=0; i<300; i=i+1){
+    UART1_OutChar(block[i]);
+  }
+  UART1_FinishOutput();
+  if(TxFifoLost || (Uart1Sent != sizeof(block) + 300)){
+    printf("UART1 sent %u of %u bytes, TxFifoLost %u\n", (unsigned)Uart1Sent,
+           (unsigned)(sizeof(block) + 300), (unsigned)TxFifoLost);
+    return 1;
+  }
+  return 0;
+}
+static int Uart1DoneCheck(void){
+  static const uint8_t none[1];
+  uint32_t wait, done;
+  for(wait=0; wait<6000; wait=wait+1){
+    Sim_Init();
+    Uart1Init();
+    Sim_SetUartSink(2, &Uart1Sink);
+    UART1_SetTxDone(&Uart1DoneTask);
+    Uart1Queued = Uart1Sent = Uart1Done = Uart1Early = 0;
+    Uart1Queued = 1;
+    UART1_OutChar('a');
+    while(UART1_OutStatus() != 0x0008);  // 'a' is shifting out
+    Sim_Advance(wait);
+    done = Uart1Done;
+    Uart1Queued = 2;
+    UART1_OutChar('b');
+    UART1_FinishOutput();
+    UART1_OutBlock(none, 0);
+    Sim_Advance(10000);
+    if(Uart1Early || (Uart1Done != done + 1) || (Uart1Sent != 2)){
+      printf("UART1 TxDone ran %u times, %u before the output drained, with 'b' queued %u cycles into 'a'\n",
+             (unsigned)Uart1Done, (unsigned)Uart1Early, (unsigned)wait);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// binary log over UART0; an 8-byte record is 17 bytes on the line,
+// 1.5 ms at 115,200 baud and 0.17 ms at 1,000,000 baud
+static uint32_t LogBaud;
+static int16_t LogRecord[4];
+static struct LogDecoder LogDecoder;
+static uint32_t LogPuts, LogReceived, LogLostSeen, LogWrong;
+static uint32_t LogTime;        // of the last frame received
+static void LogSet(int16_t t){
+  LogRecord[0] = t;
+  LogRecord[1] = -t;
+  LogRecord[2] = 3*t;
+  LogRecord[3] = 7;
+}
+static void LogCheckFrame(uint32_t time, uint8_t id, const uint8_t *data, uint32_t size, uint32_t lost){
+  int16_t t = (int16_t)(LogReceived + LogLostSeen + lost);  // puts before this one
+  LogSet(t);
+  // frames are put every 1 ms by Timer A2, and Timer32 counts 3000 per ms
+  if(id != 5 || size != 8 || memcmp(data, LogRecord, 8) ||
+     (LogReceived && ((time - LogTime) < 2990*(lost + 1) || (time - LogTime) > 3010*(lost + 1)))){
+    LogWrong = LogWrong + 1;
+  }
+  LogTime = time;
+  LogReceived = LogReceived + 1;
+  LogLostSeen = LogLostSeen + lost;
+}
+static void LogSink(uint8_t data){
+  Log_Decode(&LogDecoder, &data, 1, &LogCheckFrame);
+}
+static void LogInit(void){
+  Clock_Init48MHz();
+  Log_Init(LogBaud);
+  Log_DecodeInit(&LogDecoder);
+  LogPuts = LogReceived = LogLostSeen = LogWrong = 0;
+  Sim_SetUartSink(0, &LogSink);
+  EnableInterrupts();
+}
+static void LogInit115200(void){
+  LogBaud = 115200;
+  LogInit();
+}
+static void LogInit1M(void){
+  LogBaud = 1000000;
+  LogInit();
+}
+static void LogTask(void){       // 1 kHz producer
+  LogSet((int16_t)LogPuts);
+  LogPuts = LogPuts + 1;
+  Log_Put(5, LogRecord, 8);
+}
+static void Log2ms(void){        // one record and the time to send it
+  LogTask();
+  Sim_Advance(96000);
+}
+
+// the BLE application processor against the CC2650 model
+static uint32_t BleData;        // read/write characteristic 0xFFF1
+static uint16_t BleNotify;      // notify characteristic 0xFFF2
+static uint8_t BleSeen[20];     // last data the central got
+static uint32_t BleSeenLength;
+static uint16_t BleSeenHandle;
+static void BleTask(uint16_t handle, const uint8_t *data, uint32_t length){
+  memcpy(BleSeen, data, length);
+  BleSeenLength = length;
+  BleSeenHandle = handle;
+}
+static void BleNothing(void){
+}
+// the main loop of a program that uses AP.c
+static void BleRun(void){
+  AP_BackgroundProcess();
+  Clock_Delay1us(1);
+}
+static void BleBoot(void){
+  AP_Init();
+  while(!AP_Ready()){
+    BleRun();
+  }
+}
+static void BleInit(void){
+  Clock_Init48MHz();
+  SNPSim_Init();
+  SNPSim_SetTask(&BleTask);
+  EnableInterrupts();
+}
+static void BleService(void){
+  BleInit();
+  BleBoot();
+  AP_AddService(0xFFF0);
+  AP_AddCharacteristic(0xFFF1, 4, &BleData, 0x03, 0x0A, "Data", &BleNothing, &BleNothing);
+  AP_AddNotifyCharacteristic(0xFFF2, 2, &BleNotify, "Notify", &BleNothing);
+  AP_RegisterService();
+  AP_StartAdvertisement();
+  SNPSim_Subscribe(SNPSim_Handle(0xFFF2), 1);
+  while(AP_GetNotifyCCCD(0) == 0){
+    BleRun();
+  }
+}
+#define BLEMANY 24
+static uint32_t BleMany[BLEMANY];   // read/write characteristics 0xFF01 to 0xFF01+BLEMANY-1
+static void BleManyService(void){
+  uint32_t i;
+  BleInit();
+  BleBoot();
+  AP_AddService(0xFFF0);
+  for(i=0; i<BLEMANY; i=i+1){
+    BleMany[i] = 0x1000 + i;
+    AP_AddCharacteristic(0xFF01 + i, 4, &BleMany[i], 0x03, 0x0A, "Many", &BleNothing, &BleNothing);
+  }
+  AP_RegisterService();
+}
+static void ApInit(void){      // reset to ready, two power-ups
+  BleBoot();
+}
+static void ApGetVersion(void){  // one request and its response
+  Sink = AP_GetVersion();
+}
+static void ApBackgroundProcess(void){
+  AP_BackgroundProcess();
+}
+static void ApSendNotification(void){  // queue, then run until it is out
+  uint32_t sent = SNPSim_GetStats()->notifications;
+  BleNotify = BleNotify + 1;
+  AP_SendNotification(0);
+  while(SNPSim_GetStats()->notifications == sent){
+    BleRun();
+  }
+}
+static void ApWriteIndication(void){  // central writes, AP confirms
+  static const uint8_t data[4] = {0x12, 0x34, 0x56, 0x78};
+  uint32_t confirms = SNPSim_GetStats()->confirms;
+  SNPSim_Write(SNPSim_Handle(0xFFF1), data, 4);
+  while(SNPSim_GetStats()->confirms == confirms){
+    BleRun();
+  }
+}
+
+// telemetry of a robot on a slow arc, sample t is at t ms:
+// time, x, y, heading in 0.01 degree, left and right speed
+#define TELEFIELDS 6
+static int32_t TeleSample[TELEFIELDS];
+static int32_t BleField;        // notify characteristic 0xFFF2, one field per notification
+static struct TelemetryDecoder TeleDecoder;
+static uint32_t TeleFieldBytes, TeleSamples, TeleBad;
+static int32_t TeleTime;
+static void TeleSet(int32_t t){
+  TeleSample[0] = t;
+  TeleSample[1] = t/5;
+  TeleSample[2] = t/8;
+  TeleSample[3] = (t*9)%36000;
+  TeleSample[4] = 200 + (t/100)%7;
+  TeleSample[5] = 210 - (t/150)%5;
+}
+static void TeleCheckSample(const int32_t *fields, uint32_t skip){
+  TeleSet(fields[0]);
+  if(memcmp(fields, TeleSample, sizeof(TeleSample)) || (skip && (fields[0] != TeleTime + (int32_t)skip))){
+    TeleBad = TeleBad + 1;
+  }
+  TeleTime = fields[0];
+  TeleSamples = TeleSamples + 1;
+}
+static void TeleTask(uint16_t handle, const uint8_t *data, uint32_t length){
+  if(handle == SNPSim_Handle(0xFFF3)){
+    Telemetry_Decode(&TeleDecoder, data, length, &TeleCheckSample);
+  }else{
+    TeleFieldBytes = TeleFieldBytes + length;
+  }
+}
+static void TelemetryInit(void){  // connected at 30 ms, both subscribed
+  BleInit();
+  BleBoot();
+  AP_AddService(0xFFF0);
+  AP_AddNotifyCharacteristic(0xFFF2, 4, &BleField, "Field", &BleNothing);
+  Telemetry_Init(0xFFF3, "Telemetry", TELEFIELDS, 1000);
+  AP_RegisterService();
+  AP_StartAdvertisement();
+  SNPSim_Connect(24);
+  SNPSim_Subscribe(SNPSim_Handle(0xFFF2), 1);
+  SNPSim_Subscribe(SNPSim_Handle(0xFFF3), 1);
+  while((AP_GetNotifyCCCD(0) == 0) || (AP_GetNotifyCCCD(1) == 0)){
+    BleRun();
+  }
+  SNPSim_SetTask(&TeleTask);
+  Telemetry_DecodeInit(&TeleDecoder, TELEFIELDS);
+  TeleFieldBytes = TeleSamples = TeleBad = 0;
+  TeleTime = 0;
+}
+static void BleRunFor(uint32_t us){
+  uint64_t end = Sim_Now() + (uint64_t)us*48;
+  while(Sim_Now() < end){
+    BleRun();
+  }
+}
+static void Telemetry1ms(void){  // one sample and the main loop until the next
+  TeleTime = TeleTime + 1;
+  TeleSet(TeleTime);
+  Telemetry_Put(TeleSample);
+  BleRunFor(1000);
+}
+
+// one second of 1 kHz samples over a 30 ms connection, first as
+// one notification per field, then as a telemetry stream
+static int TelemetryCheck(void){
+  uint32_t t, i, fieldBytes, teleBytes, samples, packets, skip;
+  uint64_t end;
+  Sim_Init();
+  TelemetryInit();
+  end = Sim_Now() + 48000000;
+  for(t=1; Sim_Now()<end; t=t+1){
+    TeleSet(t);
+    for(i=0; i<TELEFIELDS; i=i+1){
+      BleField = TeleSample[i];
+      AP_SendNotification(0);   // fails while the queue is full
+    }
+    BleRunFor(1000);
+  }
+  fieldBytes = TeleFieldBytes;
+  end = Sim_Now() + 48000000;
+  for(t=1; Sim_Now()<end; t=t+1){
+    TeleSet(t);
+    Telemetry_Put(TeleSample);
+    BleRunFor(1000);
+  }
+  teleBytes = TeleSamples*TELEFIELDS*4;
+  // per field, even a perfect AP fits SNPSIM_PERINTERVAL 4-byte notifications in 30 ms
+  if(TeleBad || (teleBytes < 10*fieldBytes) || (teleBytes < 10*SNPSIM_PERINTERVAL*4*1000/30)){
+    Telemetry_Stats(&samples, &packets, &skip);
+    printf("BLE telemetry %u useful bytes/s (%u wrong) in %u notifications, per field %u bytes/s\n",
+           (unsigned)teleBytes, (unsigned)TeleBad, (unsigned)packets, (unsigned)fieldBytes);
+    return 1;
+  }
+  return 0;
+}
+static void ApReadIndication(void){  // central reads the last of BLEMANY, AP confirms
+  uint32_t confirms = SNPSim_GetStats()->confirms;
+  SNPSim_Read(SNPSim_Handle(0xFF01 + BLEMANY - 1));
+  while(SNPSim_GetStats()->confirms == confirms){
+    BleRun();
+  }
+}
+
+// GATT traffic both ways, a read of a handle the AP does not
+// own, then a bad FCS, a lost response and line noise, each seen
+// by the AP; the lost response times out after 40 to 50 ms
+static int BleCheck(void){
+  static uint8_t getVersion[] = {SOF,0x00,0x00,0x35,0x03,0x36};
+  static const uint8_t data[4] = {0x00, 0x00, 0x01, 0x02};
+  uint8_t response[32];
+  uint32_t confirms;
+  uint64_t wait;
+  int r[3];
+  Sim_Init();
+  BleService();
+  BleNotify = 0x1234;
+  ApSendNotification();
+  if(BleSeenLength != 2 || BleSeen[0] != 0x12 || BleSeen[1] != 0x35){
+    printf("BLE notification %u bytes %02X %02X\n", (unsigned)BleSeenLength, BleSeen[0], BleSeen[1]);
+    return 1;
+  }
+  SNPSim_Write(SNPSim_Handle(0xFFF1), data, 4);
+  confirms = SNPSim_GetStats()->confirms;
+  SNPSim_Read(SNPSim_Handle(0xFFF1));
+  while(SNPSim_GetStats()->confirms < confirms + 2){
+    BleRun();
+  }
+  if(BleData != 0x0102 || BleSeenLength != 4 || BleSeen[3] != 0x02){
+    printf("BLE write/read %08X, %u bytes\n", (unsigned)BleData, (unsigned)BleSeenLength);
+    return 1;
+  }
+  confirms = SNPSim_GetStats()->confirms;
+  SNPSim_Read(SNPSim_Handle(0xFFF1) + 100);
+  while(SNPSim_GetStats()->confirms == confirms){
+    BleRun();
+  }
+  if(BleSeenHandle != SNPSim_Handle(0xFFF1) + 100 || BleSeenLength != 1 || BleSeen[0] != 0){
+    printf("BLE read of a foreign handle %04X, %u bytes\n", (unsigned)BleSeenHandle, (unsigned)BleSeenLength);
+    return 1;
+  }
+  SNPSim_Fault(SNPSIM_BADFCS);
+  r[0] = AP_SendMessageResponse(getVersion, response, sizeof(response));
+  SNPSim_Fault(SNPSIM_NORESPONSE);
+  wait = Sim_Now();
+  r[1] = AP_SendMessageResponse(getVersion, response, sizeof(response));
+  wait = Sim_Now() - wait;
+  SNPSim_Fault(SNPSIM_JUNK);
+  r[2] = AP_SendMessageResponse(getVersion, response, sizeof(response));
+  if(r[0] != APFAIL || r[1] != APFAIL || r[2] != APOK ||
+     fcserr != 1 || TimeOutErr != 2 || NoSOFErr != 1 || wait < 40*48000 || wait > 50*48000){
+    printf("BLE errors %d %d %d, fcserr %u TimeOutErr %u NoSOFErr %u, timeout %u us\n", r[0], r[1], r[2],
+           (unsigned)fcserr, (unsigned)TimeOutErr, (unsigned)NoSOFErr, (unsigned)(wait/48));
+    return 1;
+  }
+  Sim_Init();
+  BleManyService();
+  ApReadIndication();
+  if(BleSeenLength != 4 || BleSeen[2] != 0x10 || BleSeen[3] != BLEMANY - 1){
+    printf("BLE read of characteristic %d, %u bytes %02X %02X\n", BLEMANY, (unsigned)BleSeenLength,
+           BleSeen[2], BleSeen[3]);
+    return 1;
+  }
+  return 0;
+}
+
+// command shell on UART0; keys arrive at 115,200 baud, 87 us apart,
+// while the speed control tick runs in its interrupt.  A reply must
+// fit TxFifo0, since the output spin loop does not advance virtual time.
+static char ShellReply[256];
+static uint32_t ShellReplySize;
+static void ShellSink(uint8_t data){
+  if(ShellReplySize < sizeof(ShellReply) - 1){
+    ShellReply[ShellReplySize] = data;
+    ShellReplySize = ShellReplySize + 1;
+    ShellReply[ShellReplySize] = 0;
+  }
+}
+static void ShellInit(void){
+  Clock_Init48MHz();
+  WheelsOnFloor();
+  Profile_Init(0);
+  Shell_Init();
+  Sim_SetUartSink(0, &ShellSink);
+  EnableInterrupts();
+  Sim_Advance(48000);             // 1 ms to send the prompt
+}
+static uint32_t ShellType(const char *keys){  // returns commands run
+  uint32_t i, ran = 0, n = strlen(keys);
+  ShellReplySize = 0;
+  Sim_UartReceive(0, (const uint8_t *)keys, n);
+  for(i=0; i<n+50; i=i+1){        // polled every 100 us, and 5 ms to send the reply
+    Sim_Advance(4800);
+    ran = ran + Shell_Poll();
+  }
+  return ran;
+}
+static void ShellGains(void){
+  ShellType("gains 1600 640 256\r");
+}
+
+// one second of 1 kHz records from an interrupt, faster than 115,200
+// baud can carry; every frame that arrives must be right, and the
+// ones dropped must show up as gaps in the sequence numbers.  At
+// 1,000,000 baud the line has room for all of them.
+static int LogCheck(uint32_t baud){
+  uint32_t frames, lost;
+  Sim_Init();
+  LogBaud = baud;
+  LogInit();
+  TimerA2_Init(&LogTask, 500);    // 1 ms
+  Sim_Advance(48000000);
+  TimerA2_Stop();
+  Sim_Advance(9600000);           // 200 ms, sends the rest
+  Log_Stats(&frames, &lost);
+  // back to back frames fill the line, baud/10 bytes/s, unless all fit
+  if(LogWrong || LogDecoder.bad || (frames != LogReceived) || (LogLostSeen > lost) ||
+     (frames + lost != LogPuts) || (LogReceived < baud/10*95/100/17 && LogReceived < LogPuts)){
+    printf("Log at %u baud, %u frames received (%u wrong, %u bad), %u lost, %u seen lost, of %u\n",
+           (unsigned)baud, (unsigned)LogReceived, (unsigned)LogWrong, (unsigned)LogDecoder.bad,
+           (unsigned)lost, (unsigned)LogLostSeen, (unsigned)LogPuts);
+    return 1;
+  }
+  return 0;
+}
+// a typed line changes the gains, drives and reports, and bad lines
+// are answered without running anything
+static int ShellCheck(void){
+  int32_t kff, kp, ki, leftSpeed, rightSpeed, leftSteps, rightSteps, start;
+  uint32_t leftTach, rightTach, i;
+  enum TachDirection leftDir, rightDir;
+  Sim_Init();
+  ShellInit();
+  if((ShellType("gains 1500 600 -20\r") != 1) || strcmp(ShellReply, "gains 1500 600 -20\r\n1500 600 -20\r\n> ")){
+    printf("Shell gains replied \"%s\"\n", ShellReply);
+    return 1;
+  }
+  SpeedControl_GetGains(&kff, &kp, &ki);
+  if((kff != 1500) || (kp != 600) || (ki != -20)){
+    printf("Shell gains set %d %d %d\n", (int)kff, (int)kp, (int)ki);
+    return 1;
+  }
+  if((ShellType("gainz\b\bns 1 2\r") != 0) || (strstr(ShellReply, "usage: gains [kff kp ki]") == 0) ||
+     (ShellType("fly 1\r\n") != 0) || (strstr(ShellReply, "? fly 1\r\n> ") == 0) ||
+     (ShellType("speed 1 x\r") != 0) || (ShellType("speed 1 2 3 4 5\r") != 0) ||
+     (ShellType("gains 1600 640 256\r") != 1) || (ShellType("speed 150 150\r\n") != 1)){
+    printf("Shell ran a bad line, replied \"%s\"\n", ShellReply);
+    return 1;
+  }
+  Sim_Advance(48000000);          // 1 s to reach speed
+  SpeedControl_Get(&leftSpeed, &rightSpeed);
+  if((leftSpeed < 140) || (leftSpeed > 160) || (rightSpeed < 140) || (rightSpeed > 160)){
+    printf("Shell speed 150 150 gave %d %d\n", (int)leftSpeed, (int)rightSpeed);
+    return 1;
+  }
+  ShellType("stop\r");
+  Sim_Advance(48000000);
+  Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+  start = leftSteps + rightSteps;
+  if((ShellType("run 220 200\r") != 1) || (Profile_Busy() == 0)){
+    printf("Shell run replied \"%s\"\n", ShellReply);
+    return 1;
+  }
+  for(i=0; (i<300) && Profile_Busy(); i=i+1){
+    Sim_Advance(480000);          // 10 ms
+  }
+  Sim_Advance(48000000);          // coast to a stop
+  Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+  if((ShellType("count\r") != 1) || (leftSteps + rightSteps - start < 2*355) || (leftSteps + rightSteps - start > 2*380) ||
+     (strncmp(ShellReply, "count\r\nsteps ", 13) != 0) || (strstr(ShellReply, " busy 0 lost 0\r\n> ") == 0)){
+    printf("Shell run 220 200 went %d steps, count replied \"%s\"\n", (int)(leftSteps + rightSteps - start), ShellReply);
+    return 1;
+  }
+  Sim_SetUartSink(0, 0);
+  return 0;
+}
+// the tachometer period must be right at crawl speed, where
+// it is several times the 16-bit range of the timer
+static int TachometerCheck(void){
+  static const uint16_t duty[3] = {250, 500, 14000};  // 10, 20 and 560 mm/s
+  uint32_t leftTach, rightTach, expect;
+  enum TachDirection leftDir, rightDir;
+  int32_t leftSteps, rightSteps;
+  int i;
+  for(i=0; i<3; i=i+1){
+    Sim_Init();
+    TachometerInit();
+    Motor_Forward(duty[i], duty[i]);
+    Sim_Advance(48000000);        // 1 s
+    Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+    // period in 1/12 us of FULLSPEED*duty/15000 mm/s
+    expect = (uint32_t)(12000000.0*220.0/360.0/(FULLSPEED*duty[i]/15000.0));
+    if(leftTach < expect*99/100 || leftTach > expect*101/100 ||
+       rightTach < expect*99/100 || rightTach > expect*101/100 || leftDir != FORWARD){
+      printf("Tachometer period %u %u, expected %u\n", (unsigned)leftTach, (unsigned)rightTach, (unsigned)expect);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// PCD8544 on UCA3; DC (P9.6) is sampled with the eighth bit.
+// With H = 0, commands 0x80|x and 0x40|y set the address, and
+// data bytes fill the banks across and wrap back to (0,0).
+extern uint8_t Screen[504];       // Nokia5110.c
+static uint8_t LcdRam[504];
+static uint32_t LcdX, LcdY, LcdH, LcdData, LcdCommands;
+static void LcdSink(uint8_t data){
+  if(Sim_Port[9].OUT&0x40){
+    LcdRam[84*LcdY + LcdX] = data;
+    LcdData = LcdData + 1;
+    LcdX = LcdX + 1;
+    if(LcdX == 84){
+      LcdX = 0;
+      LcdY = (LcdY + 1)%6;
+    }
+  }else{
+    LcdCommands = LcdCommands + 1;
+    if((data&0xF8) == 0x20){
+      LcdH = data&0x01;           // function set
+    }else if(LcdH){
+      // extended instruction set
+    }else if(data&0x80){
+      LcdX = (data&0x7F)%84;
+    }else if((data&0xF8) == 0x40){
+      LcdY = (data&0x07)%6;
+    }
+  }
+}
+static void NokiaDrain(void){
+  while(Nokia5110_Busy()){
+    Sim_Advance(480);             // 10 us
+  }
+}
+static void NokiaInit(void){
+  Clock_Init48MHz();
+  memset(LcdRam, 0xAA, sizeof(LcdRam));   // random after reset
+  LcdX = LcdY = LcdH = LcdData = LcdCommands = 0;
+  Sim_SetUartSink(3, &LcdSink);
+  Nokia5110_Init();
+  NokiaDrain();
+}
+// a dashboard drawn from scratch: a pattern in every byte, and
+// with digit 1 a 5x8 digit in bank 2, columns 40 to 44
+static void NokiaDraw(int digit){
+  uint32_t i, j;
+  Nokia5110_ClearBuffer();
+  for(j=0; j<84; j=j+1){
+    for(i=j%8; i<48; i=i+8){
+      Nokia5110_SetPxl(i, j);
+    }
+  }
+  for(j=40; digit && (j<45); j=j+1){
+    for(i=16; i<24; i=i+1){
+      if(i%8 == j%8){
+        Nokia5110_ClrPxl(i, j);
+      }else{
+        Nokia5110_SetPxl(i, j);
+      }
+    }
+  }
+}
+static void NokiaFrameInit(void){
+  NokiaInit();
+  NokiaDraw(0);
+  Nokia5110_DisplayBuffer();
+  NokiaDrain();
+}
+static void NokiaFrame(void){     // every byte changes
+  static int blank;
+  blank = !blank;
+  if(blank){
+    Nokia5110_ClearBuffer();
+  }else{
+    NokiaDraw(0);
+  }
+  Nokia5110_DisplayBuffer();
+  NokiaDrain();
+}
+static void NokiaDigit(void){     // one digit changes
+  static int digit;
+  digit = !digit;
+  NokiaDraw(digit);
+  Nokia5110_DisplayBuffer();
+  NokiaDrain();
+}
+static void NokiaOutString(void){
+  Nokia5110_SetCursor(0, 0);
+  Nokia5110_OutString("RSLK maze 42");
+  NokiaDrain();
+}
+// flush the buffer, then check the LCD against it and count what was sent
+static int NokiaFlush(const char *what, uint32_t data, uint32_t commands){
+  uint32_t startData = LcdData, startCommands = LcdCommands;
+  Nokia5110_DisplayBuffer();
+  NokiaDrain();
+  if(memcmp(LcdRam, Screen, sizeof(LcdRam)) || (LcdData - startData != data) ||
+     (LcdCommands - startCommands > commands)){
+    printf("Nokia5110_DisplayBuffer %s sent %u bytes and %u commands, expected %u and %u, LCD %s Screen\n",
+           what, (unsigned)(LcdData - startData), (unsigned)(LcdCommands - startCommands),
+           (unsigned)data, (unsigned)commands, memcmp(LcdRam, Screen, sizeof(LcdRam))? "differs from" : "matches");
+    return 1;
+  }
+  return 0;
+}
+// Init clears the LCD, a frame reaches it intact while the CPU
+// is free, a flush sends only the bytes that changed, and text
+// lands at the cursor until the next flush puts the buffer back
+static int NokiaCheck(void){
+  static const uint8_t glyphs[5][5] = {   // "maze!" in the driver's font
+    {0x7c, 0x04, 0x18, 0x04, 0x78}, {0x20, 0x54, 0x54, 0x54, 0x78},
+    {0x44, 0x64, 0x54, 0x4c, 0x44}, {0x38, 0x54, 0x54, 0x54, 0x18},
+    {0x00, 0x00, 0x5f, 0x00, 0x00}
+  };
+  uint64_t start, call, frame;
+  uint32_t i;
+  Sim_Init();
+  NokiaInit();
+  for(i=0; i<504; i=i+1){
+    if(LcdRam[i] != 0){
+      printf("Nokia5110_Init left 0x%02X at %u\n", LcdRam[i], (unsigned)i);
+      return 1;
+    }
+  }
+  NokiaDraw(0);
+  start = Sim_Now();
+  Nokia5110_DisplayBuffer();
+  call = Sim_Now() - start;
+  NokiaDrain();
+  frame = Sim_Now() - start;
+  // 504 bytes at 4 MHz take 48,384 cycles; the caller gets all but a few
+  if((call > 2000) || (frame < 504*96)){
+    printf("Nokia5110_DisplayBuffer took %u cycles of a %u cycle frame\n", (unsigned)call, (unsigned)frame);
+    return 1;
+  }
+  LcdData = 0;
+  if(NokiaFlush("unchanged", 0, 0)){
+    return 1;
+  }
+  // the digit, redrawing the same, and taking it away again
+  NokiaDraw(1);
+  if(NokiaFlush("with the digit", 5, 2) || NokiaFlush("again", 0, 0)){
+    return 1;
+  }
+  NokiaDraw(1);
+  if(NokiaFlush("redrawn the same", 0, 0)){
+    return 1;
+  }
+  NokiaDraw(0);
+  if(NokiaFlush("without the digit", 5, 2)){
+    return 1;
+  }
+  Nokia5110_Clear();
+  Nokia5110_SetCursor(3, 2);
+  Nokia5110_OutString("maze");
+  Nokia5110_OutChar('!');
+  NokiaDrain();
+  for(i=0; i<504; i=i+1){
+    uint32_t x = i%84, y = i/84;
+    uint8_t expect = 0;
+    if((y == 2) && (x >= 21) && (x < 56) && ((x - 21)%7 > 0) && ((x - 21)%7 < 6)){
+      expect = glyphs[(x - 21)/7][(x - 21)%7 - 1];
+    }
+    if(LcdRam[i] != expect){
+      printf("Nokia5110_OutString column %u row %u is 0x%02X, expected 0x%02X\n",
+             (unsigned)x, (unsigned)y, LcdRam[i], expect);
+      return 1;
+    }
+  }
+  if(NokiaFlush("after Clear", 504, 2)){
+    return 1;
+  }
+  Nokia5110_SetCursor(3, 2);
+  Nokia5110_OutString("maze!");
+  NokiaDrain();
+  if(NokiaFlush("after text", 35, 2)){
+    return 1;
+  }
+  Nokia5110_SetCursor(11, 5);     // wraps to the top left corner
+  Nokia5110_OutString("ab");
+  NokiaDrain();
+  if((LcdRam[84*5 + 78] != glyphs[1][0]) || (LcdRam[0] != 0) || (LcdRam[1] == 0) ||
+     NokiaFlush("after wrapped text", 14, 4)){
+    printf("Nokia5110_OutString did not wrap\n");
+    return 1;
+  }
+  Sim_SetUartSink(3, 0);
+  return 0;
+}
+
+struct bench{
+  const char *name;
+  void (*init)(void);   // runs once on a freshly reset simulator
+  void (*run)(void);    // the call being measured
+  uint32_t calls;
+};
+static const struct bench Benches[] = {
+  {"Reflectance_Read",     ReflectanceInit, ReflectanceRead,     1000},
+  {"Reflectance_Center",   ReflectanceInit, ReflectanceCenter,   1000},
+  {"Reflectance_Decay",    ReflectanceInit, ReflectanceDecay,    100},
+  {"Reflectance_Position", ReflectanceInit, ReflectancePosition, 100000},
+  {"Reflectance_PositionLoop", ReflectanceInit, ReflectancePositionLoop, 100000},
+  {"Reflectance_PositionDecay", ReflectanceInit, ReflectancePositionDecay, 100000},
+  {"Reflectance_StartEnd", ReflectanceInit, ReflectanceStartEnd, 1000},
+  {"ReflectanceInt_Get",   ReflectanceIntInit, ReflectanceIntGet, 100000},
+  {"ReflectanceInt_1ms",   ReflectanceIntInit, ReflectanceIntSample, 1000},
+  {"Junction_Sample",      JunctionInit,    JunctionSample,      100000},
+  {"Motor_Forward",        MotorInit,       MotorForward,        10000},
+  {"Tachometer_Get",       TachometerInit,  TachometerGet,       100000},
+  {"Tachometer_10ms",      TachometerInit,  Tachometer10ms,      100},
+  {"SpeedControl_10ms",    SpeedControlInit, SpeedControl10ms,   100},
+  {"Odometry_UpdateGet",   OdometryInit,    OdometryUpdate,      100000},
+  {"TxFifo0_PutGet",       FifoInit,        FifoPutGet,          100000},
+  {"TxFifo0_PutGetString",  FifoInit,       FifoPutGetString,    100000},
+  {"SampleFifo_PutGet",    SampleFifoInit,  SampleFifoPutGet,    100000},
+  {"Format_UDec",          FifoInit,        FormatUDec,          1000000},
+  {"Format_UDecLoop",      FifoInit,        FormatUDecLoop,      1000000},
+  {"Format_UFix2",         FifoInit,        FormatUFix2,         1000000},
+  {"Format_UFix2Loop",     FifoInit,        FormatUFix2Loop,     1000000},
+  {"UART0_OutUDec",        Uart0Init,       Uart0OutUDec,        100},
+  {"UART0_OutUFix2",       Uart0Init,       Uart0OutUFix2,       100},
+  {"UART0_OutUDec_1M",     Uart0Init1M,     Uart0OutUDec,        100},
+  {"EUSCIA0_OutUDec",      Euscia0Init,     Euscia0OutUDec,      1000},
+  {"EUSCIA0_OutString",    Euscia0Init,     Euscia0OutString,    1000},
+  {"UART1_OutString",      Uart1Init,       Uart1OutString,      100},
+  {"UART1_OutBuffer",      Uart1Init,       Uart1OutBuffer,      100},
+  {"Log_2ms",              LogInit115200,   Log2ms,              1000},
+  {"Log_2ms_1M",           LogInit1M,       Log2ms,              1000},
+  {"Shell_gains_line",     ShellInit,       ShellGains,          100},
+  {"Nokia5110_DisplayBuffer", NokiaFrameInit, NokiaFrame,       100},
+  {"Nokia5110_DisplayBuffer_digit", NokiaFrameInit, NokiaDigit,   100},
+  {"Nokia5110_OutString",  NokiaInit,       NokiaOutString,      100},
+  {"AP_Init",              BleInit,         ApInit,              10},
+  {"AP_GetVersion",        BleService,      ApGetVersion,        100},
+  {"AP_BackgroundProcess", BleService,      ApBackgroundProcess, 100000},
+  {"AP_SendNotification",  BleService,      ApSendNotification,  100},
+  {"AP_WriteIndication",   BleService,      ApWriteIndication,   100},
+  {"AP_ReadIndication",    BleManyService,  ApReadIndication,    100},
+  {"Telemetry_1ms",        TelemetryInit,   Telemetry1ms,        1000}
+};
+#define NUMBENCHES (sizeof(Benches)/sizeof(Benches[0]))
+
+static uint64_t HostNs(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)t.tv_sec*1000000000u + t.tv_nsec;
+}
+
+int main(int argc, char **argv){
+  uint32_t i, n;
+  for(i=0; i<256; i=i+1){
+    if(Reflectance_Position(i) != PositionLoop(i)){
+      printf("Reflectance_Position(0x%02X) = %d, expected %d\n", (unsigned)i,
+             (int)Reflectance_Position(i), (int)PositionLoop(i));
+      return 1;
+    }
+  }
+  if(JunctionCheck()){
+    return 1;
+  }
+  if(FifoCheck()){
+    return 1;
+  }
+  if(FormatCheck()){
+    return 1;
+  }
+  if(BaudCheck()){
+    return 1;
+  }
+  if(ShellCheck()){
+    return 1;
+  }
+  if(NokiaCheck()){
+    return 1;
+  }
+  if(TachometerCheck()){
+    return 1;
+  }
+  if(SpeedControlCheck()){
+    return 1;
+  }
+  if(ProfileCheck()){
+    return 1;
+  }
+  if(Euscia0Check()){
+    return 1;
+  }
+  if(Uart1LongCheck() || Uart1DoneCheck()){
+    return 1;
+  }
+  if(BleCheck()){
+    return 1;
+  }
+  if(TelemetryCheck()){
+    return 1;
+  }
+  if(LogCheck(115200) || LogCheck(1000000)){
+    return 1;
+  }
+  printf("%-28s %12s %12s %12s\n", "call", "cycles/call", "isr cyc/call", "host ns/call");
+  for(i=0; i<NUMBENCHES; i=i+1){
+    const struct bench *b = &Benches[i];
+    uint64_t cycles, isr, ns;
+    if(argc > 1 && strncmp(b->name, argv[1], strlen(argv[1])) != 0) continue;
+    Sim_Init();
+    b->init();
+    cycles = Sim_Now();
+    isr = Sim_HandlerCycles();
+    ns = HostNs();
+    for(n=0; n<b->calls; n=n+1){
+      b->run();
+    }
+    ns = HostNs() - ns;
+    cycles = Sim_Now() - cycles;
+    isr = Sim_HandlerCycles() - isr;
+    printf("%-28s %12.1f %12.1f %12.1f\n", b->name, (double)cycles/b->calls,
+           (double)isr/b->calls, (double)ns/b->calls);
+  }
+  return 0;
+}
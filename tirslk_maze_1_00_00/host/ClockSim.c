@@ -0,0 +1,91 @@
+// ClockSim.c
+// Runs on a Linux host
+// Replacement for ../inc/Clock.c in the host build.  The clock
+// configuration is applied to the simulator, and the busy-wait delays
+// advance virtual time by exactly the requested amount instead of
+// spinning a tuned loop.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#include <stdint.h>
+#include "msp.h"
+#include "Sim.h"
+
+uint32_t ClockFrequency = 3000000; // cycles/second
+
+// ------------Clock_Init48MHz------------
+// Configure MCLK for 48 MHz from the crystal, with SMCLK at 12 MHz.
+// Input: none
+// Output: none
+void Clock_Init48MHz(void){
+  Sim_SetClocks(48000000, 12000000);
+  ClockFrequency = 48000000;
+}
+
+// ------------Clock_GetFreq------------
+// Return the current system clock frequency.
+// Input: none
+// Output: system clock frequency in cycles/second
+uint32_t Clock_GetFreq(void){
+  return ClockFrequency;
+}
+
+// delay function
+// which delays 6*ulCount cycles, as the assembly loop in Clock.c
+void delay(unsigned long ulCount){
+  Sim_Advance(6*(uint64_t)ulCount);
+}
+
+// ------------Clock_Delay1us------------
+// Delay n microseconds of virtual time.
+// Inputs: n, number of us to wait
+// Outputs: none
+void Clock_Delay1us(uint32_t n){
+  Sim_Advance(((uint64_t)ClockFrequency/1000000)*n);
+}
+
+// ------------Clock_Delay1ms------------
+// Delay n milliseconds of virtual time.
+// Inputs: n, number of msec to wait
+// Outputs: none
+void Clock_Delay1ms(uint32_t n){
+  Sim_Advance(((uint64_t)ClockFrequency/1000)*n);
+}
@@ -0,0 +1,91 @@
+// CortexMSim.c
+// Runs on a Linux host
+// Replacement for ../inc/CortexM.c in the host build.  The I bit is
+// kept in Sim_Primask, and WFI lets virtual time run to the next event.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#include <stdint.h>
+#include "Sim.h"
+
+//*********** DisableInterrupts ***************
+// disable interrupts
+// inputs:  none
+// outputs: none
+void DisableInterrupts(void){
+  Sim_Primask = 1;
+}
+
+//*********** EnableInterrupts ***************
+// enable interrupts, and take any that are pending
+// inputs:  none
+// outputs: none
+void EnableInterrupts(void){
+  Sim_Primask = 0;
+  Sim_Dispatch();
+}
+
+//*********** StartCritical ************************
+// make a copy of previous I bit, disable interrupts
+// inputs:  none
+// outputs: previous I bit
+long StartCritical(void){
+  long sr = Sim_Primask;
+  Sim_Primask = 1;
+  return sr;
+}
+
+//*********** EndCritical ************************
+// using the copy of previous I bit, restore I bit to previous value
+// inputs:  previous I bit
+// outputs: none
+void EndCritical(long sr){
+  Sim_Primask = (uint32_t)sr;
+  Sim_Dispatch();
+}
+
+//*********** WaitForInterrupt ************************
+// let virtual time run until the next peripheral event
+// inputs:  none
+// outputs: none
+void WaitForInterrupt(void){
+  Sim_Idle();
+}
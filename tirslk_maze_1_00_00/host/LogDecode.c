@@ -0,0 +1,104 @@
+// LogDecode.c
+// Runs on a Linux host
+// Decode the binary log that Log.c sends over UART0 and print one
+// line per frame: time in us, id, frames lost before it, then the
+// data as bytes, or as little endian 16- or 32-bit signed numbers.
+// Usage: LogDecode [-16|-32] [file]
+// Reads the file, such as a serial port already set up with stty,
+// or standard input.  Prints totals at the end of the input.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "../inc/Log.h"
+
+static uint32_t Width = 1;       // bytes per printed number
+static uint32_t Frames, Lost;
+static uint64_t Wraps;           // 2^32 time units since the first frame
+static uint32_t Last;            // time of the previous frame
+
+static void print(uint32_t time, uint8_t id, const uint8_t *data, uint32_t size, uint32_t lost){
+  uint32_t i;
+  if(Frames && (time < Last)){
+    Wraps = Wraps + 1;           // timer wrapped, every 1431 s
+  }
+  Last = time;
+  Frames = Frames + 1;
+  Lost = Lost + lost;
+  printf("%llu %u %u", (unsigned long long)(((Wraps<<32) + time)/3), (unsigned)id, (unsigned)lost);
+  for(i=0; i+Width<=size; i=i+Width){
+    if(Width == 4){
+      printf(" %d", (int)(int32_t)(data[i]|(data[i+1]<<8)|(data[i+2]<<16)|((uint32_t)data[i+3]<<24)));
+    }else if(Width == 2){
+      printf(" %d", (int)(int16_t)(data[i]|(data[i+1]<<8)));
+    }else{
+      printf(" %02X", (unsigned)data[i]);
+    }
+  }
+  printf("\n");
+}
+
+int main(int argc, char *argv[]){
+  struct LogDecoder d;
+  uint8_t buffer[256];
+  size_t n;
+  FILE *in = stdin;
+  int i;
+  for(i=1; i<argc; i=i+1){
+    if(strcmp(argv[i], "-16") == 0){
+      Width = 2;
+    }else if(strcmp(argv[i], "-32") == 0){
+      Width = 4;
+    }else if((in = fopen(argv[i], "rb")) == 0){
+      perror(argv[i]);
+      return 1;
+    }
+  }
+  Log_DecodeInit(&d);
+  while((n = fread(buffer, 1, sizeof(buffer), in)) > 0){
+    Log_Decode(&d, buffer, (uint32_t)n, &print);
+    fflush(stdout);
+  }
+  fprintf(stderr, "%u frames, %u lost, %u bad\n", (unsigned)Frames, (unsigned)Lost, (unsigned)d.bad);
+  return 0;
+}
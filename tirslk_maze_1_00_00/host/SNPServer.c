@@ -0,0 +1,78 @@
+// SNPServer.c
+// Runs on a Linux host
+// Serve the SimpleNP model in SNPSim.c on a pseudo-terminal, so a
+// program that talks NPI to a CC2650 over a serial port can be run
+// without the booster.  Prints the terminal name, then the data of
+// each notification and read confirmation it gets.
+// Usage: SNPServer
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+#include "SNPSim.h"
+
+static void print(uint16_t handle, const uint8_t *data, uint32_t length){
+  uint32_t i;
+  printf("handle 0x%04X:", (unsigned)handle);
+  for(i=0; i<length; i=i+1){
+    printf(" %02X", (unsigned)data[i]);
+  }
+  printf("\n");
+  fflush(stdout);
+}
+
+int main(void){
+  char name[64];
+  if(SNPSim_OpenPty(name, sizeof(name)) < 0){
+    perror("SNPServer");
+    return 1;
+  }
+  SNPSim_SetTask(&print);
+  printf("%s\n", name);
+  fflush(stdout);
+  while(SNPSim_PollPty() == 0){
+    usleep(1000);
+  }
+  perror("SNPServer");
+  return 1;
+}
@@ -0,0 +1,635 @@
+// SNPSim.c
+// Runs on a Linux host
+// Model of the CC2650 BoosterPack running SimpleNP, for the
+// application processor in ../inc/AP.c.  Attached to the simulated
+// MSP432 it does the MRDY/SRDY handshake in virtual time; on a
+// pseudo-terminal it exchanges NPI frames without handshake lines.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+// MRDY P6.0 (MSP432 out), SRDY P2.5 (MSP432 in), RESET P6.7 (MSP432 out)
+// NPI UART on eUSCI_A2 (UART1.c)
+
+#define _DEFAULT_SOURCE       // cfmakeraw
+#define _XOPEN_SOURCE 600     // posix_openpt
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include "msp.h"
+#include "Sim.h"
+#include "SNPSim.h"
+
+#define SOF 0xFE
+#define FRAMESIZE 262         // SOF, length, command, payload, FCS
+#define OUTQUEUESIZE 16       // power of 2
+#define MAXATTRIBUTES 32
+#define NEVER UINT64_MAX
+#define SNPFAILURE 0x01       // status of a request the model does not know
+#define SRDYHIGH 10           // least time SRDY stays high between handshakes, us
+
+// frames to the AP, each ready to go at a time
+struct outframe{
+  uint8_t data[FRAMESIZE+16]; // room for SNPSIM_JUNK
+  uint32_t size;
+  uint64_t ready;
+};
+static struct outframe Out[OUTQUEUESIZE];
+static uint32_t OutPut, OutGet;
+
+// characteristics added by the AP
+struct attribute{
+  uint16_t uuid;
+  uint16_t handle;            // value handle
+  uint16_t cccd;              // CCCD handle, 0 if none
+  uint16_t enabled;           // CCCD value written by the central
+};
+static struct attribute Attribute[MAXATTRIBUTES];
+static uint32_t NumAttributes;
+static uint16_t NextHandle;
+static uint16_t ServiceHandle;
+static uint8_t Advertising;
+static uint16_t Interval;     // connection interval in 1.25 ms units, 0 if not connected
+static uint64_t Event;        // connection event of the last notification
+static uint32_t EventCount;   // notifications sent in that connection event
+
+// frame from the AP
+static uint8_t In[FRAMESIZE];
+static uint32_t InCount;
+static int InReady;           // In holds a complete frame
+
+enum SNPState{
+  SNPRESET,     // RESET pin low
+  SNPBOOTING,   // waiting to send the power-up indication
+  SNPIDLE,      // SRDY high
+  SNPWAKING,    // MRDY fell, SRDY falls soon
+  SNPRECEIVING, // SRDY low, AP sending
+  SNPASKING,    // SRDY low, waiting for MRDY to fall
+  SNPSENDING    // frame on its way, waiting for MRDY to rise
+};
+static enum SNPState State;
+static uint64_t Timer;        // end of SNPBOOTING, SNPWAKING or SRDY high time
+static uint32_t Faults;
+static struct SNPSim_Stats Stats;
+static void (*Task)(uint16_t handle, const uint8_t *data, uint32_t length);
+static int Pty = -1, PtySlave = -1;
+
+static uint64_t cycles(uint32_t us){
+  return (uint64_t)us*Sim_GetMCLK()/1000000;
+}
+static uint64_t device(uint64_t now);
+static void wake(void){
+  if(Pty < 0){
+    Sim_SetDevice(&device);   // runs at the next event
+  }
+}
+
+// queue a frame to the AP
+static void reply(uint8_t cmd0, uint8_t cmd1, const uint8_t *payload, uint32_t length, uint64_t ready){
+  struct outframe *f;
+  uint8_t *pt, fcs;
+  uint32_t i;
+  if((OutPut - OutGet) >= OUTQUEUESIZE) return;   // the AP is not listening
+  f = &Out[OutPut&(OUTQUEUESIZE-1)];
+  pt = f->data;
+  if(Faults&SNPSIM_JUNK){
+    Faults &= ~SNPSIM_JUNK;
+    for(i=0; i<16; i=i+1){
+      *pt++ = 0x5A;           // line noise, never SOF
+    }
+  }
+  *pt++ = SOF;
+  *pt++ = length&0xFF;
+  *pt++ = length>>8;
+  *pt++ = cmd0;
+  *pt++ = cmd1;
+  fcs = (length&0xFF)^(length>>8)^cmd0^cmd1;
+  for(i=0; i<length; i=i+1){
+    *pt++ = payload[i];
+    fcs = fcs^payload[i];
+  }
+  if(Faults&SNPSIM_BADFCS){
+    Faults &= ~SNPSIM_BADFCS;
+    fcs = fcs^0xFF;
+  }
+  *pt++ = fcs;
+  f->size = (uint32_t)(pt - f->data);
+  f->ready = ready;
+  OutPut = OutPut + 1;
+}
+
+static struct attribute *find(uint16_t handle){
+  uint32_t i;
+  for(i=0; i<NumAttributes; i=i+1){
+    if(Attribute[i].handle == handle) return &Attribute[i];
+  }
+  return 0;
+}
+
+// forget the GATT table, as the CC2650 does when it resets
+static void clear(void){
+  NumAttributes = 0;
+  NextHandle = 0x001E;
+  ServiceHandle = 0;
+  Advertising = 0;
+  Interval = 0;
+  OutPut = OutGet = 0;
+  InCount = 0;
+  InReady = 0;
+}
+
+// answer the complete frame in In
+static void process(uint64_t now){
+  uint32_t length = In[1] + (In[2]<<8);
+  uint8_t cmd0 = In[3], cmd1 = In[4];
+  uint8_t *p = &In[5];
+  uint8_t r[16];
+  uint64_t ready = now + cycles(SNPSIM_TURNAROUND);
+  struct attribute *a;
+  if(Faults&SNPSIM_NORESPONSE){
+    if(!(cmd0 == 0x55 && (cmd1 == 0x87 || cmd1 == 0x88 || cmd1 == 0x8B))){
+      Faults &= ~SNPSIM_NORESPONSE;   // confirmations have no response anyway
+      return;
+    }
+  }
+  r[0] = 0;                   // success
+  switch((cmd0<<8)|cmd1){
+    case 0x5504:              // HCI_EXT_ResetSystemCmd
+      clear();
+      State = SNPBOOTING;
+      Timer = now + cycles(SNPSIM_BOOT);
+      break;
+    case 0x5506:              // SNP Get Status
+      r[0] = Advertising? 0x02 : 0x01;    // GAPRole started, advertising
+      r[1] = Advertising;
+      r[2] = r[3] = 0;
+      reply(0x55, 0x06, r, 4, ready);
+      break;
+    case 0x3503:              // SNP Get Version
+      r[1] = 0x02; r[2] = 0x02; // SimpleNP 2.2
+      reply(0x75, 0x03, r, 3, ready);
+      break;
+    case 0x3581:              // SNP Add Service
+      ServiceHandle = NextHandle;
+      NextHandle = NextHandle + 1;
+      r[1] = ServiceHandle&0xFF; r[2] = ServiceHandle>>8;
+      reply(0x75, 0x81, r, 3, ready);
+      break;
+    case 0x3582:              // SNP Add Characteristic Value Declaration
+      if(NumAttributes >= MAXATTRIBUTES || length < 8){
+        r[0] = SNPFAILURE;
+        reply(0x75, 0x82, r, 1, ready);
+        break;
+      }
+      a = &Attribute[NumAttributes];
+      NumAttributes = NumAttributes + 1;
+      a->uuid = p[6] + (p[7]<<8);
+      a->handle = NextHandle + 1;   // after the declaration
+      a->cccd = 0;
+      a->enabled = 0;
+      NextHandle = NextHandle + 2;
+      r[1] = a->handle&0xFF; r[2] = a->handle>>8;
+      reply(0x75, 0x82, r, 3, ready);
+      break;
+    case 0x3583:              // SNP Add Characteristic Descriptor Declaration
+      r[1] = p[0];            // header, then a handle for each descriptor
+      length = 2;
+      if((p[0]&0x04) && NumAttributes){   // CCCD of the last value
+        Attribute[NumAttributes-1].cccd = NextHandle;
+        r[length] = NextHandle&0xFF; r[length+1] = NextHandle>>8;
+        length = length + 2;
+        NextHandle = NextHandle + 1;
+      }
+      if(p[0]&0x80){          // user description
+        r[length] = NextHandle&0xFF; r[length+1] = NextHandle>>8;
+        length = length + 2;
+        NextHandle = NextHandle + 1;
+      }
+      reply(0x75, 0x83, r, length, ready);
+      break;
+    case 0x3584:              // SNP Register Service
+      r[1] = ServiceHandle&0xFF; r[2] = ServiceHandle>>8;
+      r[3] = (NextHandle-1)&0xFF; r[4] = (NextHandle-1)>>8;
+      reply(0x75, 0x84, r, 5, ready);
+      break;
+    case 0x358C:              // SNP Set GATT Parameter
+      reply(0x75, 0x8C, r, 1, ready);
+      break;
+    case 0x5543:              // SNP Set Advertisement Data
+      reply(0x55, 0x43, r, 1, ready);
+      break;
+    case 0x5542:              // SNP Start Advertisement, answered by an event
+      Advertising = 1;
+      r[0] = 0x08; r[1] = 0x00; r[2] = 0x00;  // advertising started, success
+      reply(0x55, 0x05, r, 3, ready);
+      break;
+    case 0x5589:              // SNP Send Notification Indication
+      a = find(p[2] + (p[3]<<8));
+
+      if(Interval && (Pty < 0)){  // room for SNPSIM_PERINTERVAL each connection event
+        uint64_t event = now/cycles(1250*Interval);
+        if(event != Event){
+          Event = event;
+          EventCount = 0;
+        }
+        if(EventCount >= SNPSIM_PERINTERVAL){
+          a = 0;
+          Stats.refused = Stats.refused + 1;
+        }else{
+          EventCount = EventCount + 1;
+        }
+      }
+      if(a && a->enabled && length >= 6){
+        Stats.notifications = Stats.notifications + 1;
+        Stats.notifyBytes = Stats.notifyBytes + length - 6;
+        if(Task){
+          (*Task)(a->handle, &p[6], length - 6);
+        }
+      }else{
+        r[0] = SNPFAILURE;    // not subscribed, or no buffer
+      }
+      r[1] = p[0]; r[2] = p[1];   // connection handle
+      reply(0x55, 0x89, r, 3, ready);
+      break;
+    case 0x5587:              // SNP Characteristic Read Confirmation
+      Stats.confirms = Stats.confirms + 1;
+      if(Task && length >= 7){
+        (*Task)(p[3] + (p[4]<<8), &p[7], length - 7);
+      }
+      break;
+    case 0x5588:              // SNP Characteristic Write Confirmation
+    case 0x558B:              // SNP CCCD Updated Confirmation
+      Stats.confirms = Stats.confirms + 1;
+      break;
+    default:
+      if(cmd0 == 0x35){       // synchronous request, always answered
+        r[0] = SNPFAILURE;
+        reply(0x75, cmd1, r, 1, ready);
+      }
+      break;
+  }
+}
+
+// collect one byte from the AP; frames with a wrong FCS are dropped
+static void receive(uint8_t data){
+  uint32_t i, size;
+  uint8_t fcs;
+  if(InReady) return;         // still answering the last one
+  if(InCount == 0 && data != SOF) return;
+  In[InCount] = data;
+  InCount = InCount + 1;
+  if(InCount < 5) return;
+  size = In[1] + (In[2]<<8) + 6;
+  if(size > FRAMESIZE){
+    InCount = 0;              // not a frame
+    return;
+  }
+  if(InCount < size) return;
+  InCount = 0;
+  fcs = 0;
+  for(i=1; i<size; i=i+1){
+    fcs = fcs^In[i];
+  }
+  if(fcs){
+    Stats.fcsErrors = Stats.fcsErrors + 1;
+    return;
+  }
+  Stats.framesIn = Stats.framesIn + 1;
+  InReady = 1;
+}
+
+static void srdy(int level){
+  Sim_SetInput(2, 0x20, level? 0x20 : 0x00);
+}
+
+// the handshake, run by the simulator after pin changes and at Timer
+static uint64_t device(uint64_t now){
+  DIO_PORT_Interruptable_Type *p6 = &Sim_Port[6];
+  int mrdy = !(p6->DIR&0x01) || (p6->OUT&0x01);   // pulled up if not driven
+  enum SNPState last;
+  if(!(p6->DIR&0x80) || !(p6->OUT&0x80)){         // held in reset
+    if(State != SNPRESET){
+      clear();
+      State = SNPRESET;
+      srdy(1);
+    }
+    return NEVER;
+  }
+  if(InReady){
+    process(now);
+    InReady = 0;
+    if(State == SNPBOOTING){
+      srdy(1);                // system reset lets go of SRDY
+    }
+  }
+  do{
+    last = State;
+    switch(State){
+      case SNPRESET:
+        State = SNPBOOTING;
+        Timer = now + cycles(SNPSIM_BOOT);
+        break;
+      case SNPBOOTING:
+        if(now >= Timer){
+          reply(0x55, 0x01, 0, 0, now);   // power-up indication
+          State = SNPIDLE;
+        }
+        break;
+      case SNPIDLE:
+        if(!mrdy){
+          State = SNPWAKING;
+          Timer = now + cycles(SNPSIM_WAKE);
+        }else if(OutGet != OutPut && Out[OutGet&(OUTQUEUESIZE-1)].ready <= now && Timer <= now){
+          srdy(0);
+          State = SNPASKING;
+        }
+        break;
+      case SNPWAKING:
+        if(mrdy){
+          State = SNPIDLE;    // the AP gave up
+        }else if(now >= Timer){
+          srdy(0);
+          State = SNPRECEIVING;
+        }
+        break;
+      case SNPRECEIVING:
+        if(mrdy){             // bytes came in through sink()
+          srdy(1);
+          Timer = now + cycles(SRDYHIGH);
+          State = SNPIDLE;
+        }
+        break;
+      case SNPASKING:
+        if(!mrdy){
+          struct outframe *f = &Out[OutGet&(OUTQUEUESIZE-1)];
+          Sim_UartReceive(2, f->data, f->size);
+          OutGet = OutGet + 1;
+          Stats.framesOut = Stats.framesOut + 1;
+          State = SNPSENDING;
+        }
+        break;
+      case SNPSENDING:
+        if(mrdy){             // the AP has the whole frame
+          srdy(1);
+          Timer = now + cycles(SRDYHIGH);
+          State = SNPIDLE;
+        }
+        break;
+    }
+  }while(State != last);
+  if(State == SNPBOOTING || State == SNPWAKING) return Timer;
+  if(State == SNPIDLE && OutGet != OutPut){
+    uint64_t ready = Out[OutGet&(OUTQUEUESIZE-1)].ready;
+    return (ready > Timer)? ready : Timer;
+  }
+  return NEVER;
+}
+
+static void sink(uint8_t data){
+  receive(data);
+}
+
+//------------SNPSim_Init------------
+// Reset the model and attach it to UART1 and the
+// MRDY, SRDY and RESET pins of the simulator.
+// Input: none
+// Output: none
+void SNPSim_Init(void){
+  clear();
+  memset(&Stats, 0, sizeof(Stats));
+  Faults = 0;
+  Task = 0;
+  State = SNPRESET;
+  srdy(1);
+  Sim_SetUartSink(2, &sink);
+  Sim_SetDevice(&device);
+}
+
+//------------SNPSim_Fault------------
+// Use each fault once on the coming traffic.
+// Input: faults is SNPSIM_BADFCS, SNPSIM_NORESPONSE and/or SNPSIM_JUNK
+// Output: none
+void SNPSim_Fault(uint32_t faults){
+  Faults |= faults;
+}
+
+//------------SNPSim_Handle------------
+// Find the characteristic value handle of a UUID.
+// Input: uuid of the characteristic
+// Output: handle, 0 if not found
+uint16_t SNPSim_Handle(uint16_t uuid){
+  uint32_t i;
+  for(i=NumAttributes; i>0; i=i-1){
+    if(Attribute[i-1].uuid == uuid) return Attribute[i-1].handle;
+  }
+  return 0;
+}
+
+//------------SNPSim_Write------------
+// Send a write indication, as if the central wrote.
+// Input: handle of the characteristic value
+//        data and length of the value, 1 to 8 bytes
+// Output: none
+void SNPSim_Write(uint16_t handle, const uint8_t *data, uint32_t length){
+  uint8_t p[15];
+  uint32_t i;
+  if(length > 8) length = 8;
+  p[0] = p[1] = 0;            // connection handle
+  p[2] = handle&0xFF; p[3] = handle>>8;
+  p[4] = 1;                   // response needed
+  p[5] = p[6] = 0;            // offset
+  for(i=0; i<length; i=i+1){
+    p[7+i] = data[i];
+  }
+  reply(0x55, 0x88, p, 7 + length, 0);
+  wake();
+}
+
+//------------SNPSim_Read------------
+// Send a read indication, as if the central read.
+// Input: handle of the characteristic value
+// Output: none
+void SNPSim_Read(uint16_t handle){
+  uint8_t p[8];
+  p[0] = p[1] = 0;            // connection handle
+  p[2] = handle&0xFF; p[3] = handle>>8;
+  p[4] = p[5] = 0;            // offset
+  p[6] = 20; p[7] = 0;        // maximum size
+  reply(0x55, 0x87, p, 8, 0);
+  wake();
+}
+
+//------------SNPSim_Subscribe------------
+// Send a CCCD updated indication, as if the central
+// turned notifications on or off.
+// Input: handle of the characteristic value
+//        value 1 for notifications, 0 for none
+// Output: none
+void SNPSim_Subscribe(uint16_t handle, uint16_t value){
+  struct attribute *a = find(handle);
+  uint8_t p[7];
+  if(a == 0 || a->cccd == 0) return;
+  a->enabled = value;
+  p[0] = p[1] = 0;            // connection handle
+  p[2] = a->cccd&0xFF; p[3] = a->cccd>>8;
+  p[4] = 1;                   // response needed
+  p[5] = value&0xFF; p[6] = value>>8;
+  reply(0x55, 0x8B, p, 7, 0);
+  wake();
+}
+
+//------------SNPSim_Connect------------
+// Send a connection established or terminated event,
+// as if a central connected or went away.
+// Input: interval is the connection interval in 1.25 ms units, 0 to disconnect
+// Output: none
+void SNPSim_Connect(uint16_t interval){
+  uint8_t p[17];
+  uint32_t i;
+  if(interval){
+    p[0] = 0x01; p[1] = 0x00; // SNP_CONN_EST_EVT
+    p[2] = p[3] = 0;          // connection handle
+    p[4] = interval&0xFF; p[5] = interval>>8;
+    p[6] = p[7] = 0;          // slave latency
+    p[8] = 0xF4; p[9] = 0x01; // supervision timeout, 5 s
+    p[10] = 0;                // public address
+    for(i=0; i<6; i=i+1){
+      p[11+i] = 0x10 + i;
+    }
+    Advertising = 0;
+    reply(0x55, 0x05, p, 17, 0);
+  }else{
+    p[0] = 0x02; p[1] = 0x00; // SNP_CONN_TERM_EVT
+    p[2] = p[3] = 0;          // connection handle
+    p[4] = 0x13;              // remote user terminated
+    for(i=0; i<NumAttributes; i=i+1){
+      Attribute[i].enabled = 0;   // CCCDs of an unbonded central
+    }
+    reply(0x55, 0x05, p, 5, 0);
+  }
+  Interval = interval;
+  EventCount = 0;
+  wake();
+}
+
+//------------SNPSim_SetTask------------
+// Set the function that gets notification and read data.
+// Input: task is a pointer to a user function (0 for none)
+// Output: none
+void SNPSim_SetTask(void (*task)(uint16_t handle, const uint8_t *data, uint32_t length)){
+  Task = task;
+}
+
+//------------SNPSim_GetStats------------
+// Return the counts kept by the model.
+// Input: none
+// Output: pointer to the counts
+const struct SNPSim_Stats *SNPSim_GetStats(void){
+  return &Stats;
+}
+
+//------------SNPSim_OpenPty------------
+// Create a pseudo-terminal and serve the model on it.
+// Input: name is a buffer for the path of the terminal
+//        size of the buffer
+// Output: master file descriptor, -1 on error
+int SNPSim_OpenPty(char *name, uint32_t size){
+  struct termios t;
+  const char *slave;
+  int fd = posix_openpt(O_RDWR|O_NOCTTY);
+  if(fd < 0) return -1;
+  if(grantpt(fd) || unlockpt(fd) || (slave = ptsname(fd)) == 0 || strlen(slave) >= size){
+    close(fd);
+    return -1;
+  }
+  strcpy(name, slave);
+  // keep one slave open, so reads do not fail while no client is attached
+  PtySlave = open(slave, O_RDWR|O_NOCTTY);
+  if(PtySlave < 0 || tcgetattr(PtySlave, &t)){
+    close(fd);
+    return -1;
+  }
+  cfmakeraw(&t);
+  cfsetspeed(&t, B115200);
+  tcsetattr(PtySlave, TCSANOW, &t);
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL)|O_NONBLOCK);
+  Pty = fd;
+  clear();
+  memset(&Stats, 0, sizeof(Stats));
+  Faults = 0;
+  reply(0x55, 0x01, 0, 0, 0); // power-up indication
+  State = SNPIDLE;
+  return fd;
+}
+
+//------------SNPSim_PollPty------------
+// Read frames from the pseudo-terminal, answer them,
+// and write out any frames for the AP.
+// Input: none
+// Output: -1 if the terminal failed, 0 otherwise
+int SNPSim_PollPty(void){
+  uint8_t buf[256];
+  ssize_t i, n;
+  if(Pty < 0) return -1;
+  n = read(Pty, buf, sizeof(buf));
+  if(n < 0 && errno != EAGAIN && errno != EINTR) return -1;
+  for(i=0; i<n; i=i+1){
+    receive(buf[i]);
+    if(InReady){
+      process(0);
+      InReady = 0;
+      if(State == SNPBOOTING){    // system reset, no boot time on a pty
+        reply(0x55, 0x01, 0, 0, 0);
+        State = SNPIDLE;
+      }
+    }
+  }
+  while(OutGet != OutPut){
+    struct outframe *f = &Out[OutGet&(OUTQUEUESIZE-1)];
+    if(write(Pty, f->data, f->size) != (ssize_t)f->size) return -1;
+    OutGet = OutGet + 1;
+    Stats.framesOut = Stats.framesOut + 1;
+  }
+  return 0;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file      SNPSim.h
+ * @brief     Host model of the CC2650 running SimpleNP
+ * @details   Answers the NPI frames that ../inc/AP.c sends to the CC2650
+ * booster, so the BLE application processor can be run and timed on
+ * a Linux host.  In the simulator the model is attached to UART1
+ * (eUSCI_A2) and to the MRDY (P6.0), SRDY (P2.5) and RESET (P6.7)
+ * pins, and does the MRDY/SRDY handshake of the power-save mode in
+ * virtual time.  Outside the simulator the same model can serve a
+ * pseudo-terminal, which has no handshake lines, so an NPI host
+ * program can be tried against it over a serial port name.<br>
+ * Modelled: reset and power-up indication, HCI system reset, add
+ * service, add characteristic value and descriptors, register service,
+ * GATT set parameter, get status and version, advertisement commands,
+ * notifications, and read, write and CCCD indications started from the
+ * central side with SNPSim_Read(), SNPSim_Write() and SNPSim_Subscribe().
+ * Not modelled: connections, security, and the radio.
+ * @version   V1.0
+ * @author    Daniel and Jonathan Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ ******************************************************************************/
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef __SNPSIM_H__
+#define __SNPSIM_H__
+#include <stdint.h>
+
+/**
+ * \brief time from RESET going high to the power-up indication, in us
+ */
+#define SNPSIM_BOOT 20000
+
+/**
+ * \brief time from MRDY falling to SRDY falling, in us
+ */
+#define SNPSIM_WAKE 50
+
+/**
+ * \brief time from the end of a request to its response, in us
+ */
+#define SNPSIM_TURNAROUND 200
+
+/**
+ * \brief notifications the model takes in each connection event while connected
+ */
+#define SNPSIM_PERINTERVAL 4
+
+/**
+ * \brief fault for SNPSim_Fault: the next frame to the AP has a wrong FCS
+ */
+#define SNPSIM_BADFCS     0x01
+
+/**
+ * \brief fault for SNPSim_Fault: the next request gets no response
+ */
+#define SNPSIM_NORESPONSE 0x02
+
+/**
+ * \brief fault for SNPSim_Fault: 16 bytes of noise come before the next frame to the AP
+ */
+#define SNPSIM_JUNK       0x04
+
+/**
+ * \brief counts kept by the model since SNPSim_Init or SNPSim_OpenPty
+ */
+struct SNPSim_Stats{
+  uint32_t framesIn;      /**< good frames from the AP */
+  uint32_t fcsErrors;     /**< frames from the AP with a wrong FCS */
+  uint32_t framesOut;     /**< frames sent to the AP */
+  uint32_t notifications; /**< notifications sent to the central */
+  uint32_t notifyBytes;   /**< user data bytes in those notifications */
+  uint32_t confirms;      /**< read, write and CCCD confirmations from the AP */
+  uint32_t refused;       /**< notifications refused for lack of room in the connection event */
+};
+
+/**
+ * Reset the model and attach it to the simulator.  Call after Sim_Init().
+ * The CC2650 stays in reset until AP_Init() releases the RESET pin.
+ * @param none
+ * @return none
+ */
+void SNPSim_Init(void);
+
+/**
+ * Inject faults into the traffic; each fault is used once.
+ * @param faults SNPSIM_BADFCS, SNPSIM_NORESPONSE and/or SNPSIM_JUNK
+ * @return none
+ */
+void SNPSim_Fault(uint32_t faults);
+
+/**
+ * Find the characteristic value handle given to a UUID by the
+ * last AP_AddCharacteristic or AP_AddNotifyCharacteristic.
+ * @param uuid 16-bit UUID of the characteristic
+ * @return handle, 0 if not found
+ */
+uint16_t SNPSim_Handle(uint16_t uuid);
+
+/**
+ * Central writes a characteristic: sends a write indication to the AP.
+ * @param handle characteristic value handle
+ * @param data bytes to write, in the order they go over the air
+ * @param length number of bytes, 1 to 8
+ * @return none
+ */
+void SNPSim_Write(uint16_t handle, const uint8_t *data, uint32_t length);
+
+/**
+ * Central reads a characteristic: sends a read indication to the AP.
+ * The data arrives at the task set by SNPSim_SetTask().
+ * @param handle characteristic value handle
+ * @return none
+ */
+void SNPSim_Read(uint16_t handle);
+
+/**
+ * Central writes the CCCD of a notify characteristic: sends a CCCD
+ * indication to the AP.  Notifications are counted only while enabled.
+ * @param handle characteristic value handle
+ * @param value 1 to enable notifications, 0 to disable
+ * @return none
+ */
+void SNPSim_Subscribe(uint16_t handle, uint16_t value);
+
+/**
+ * Central connects or disconnects: sends a connection established or
+ * terminated event to the AP.  While connected, the model takes at most
+ * SNPSIM_PERINTERVAL notifications in each connection interval and
+ * refuses the rest with a failure status.  Disconnecting clears every CCCD.
+ * @param interval connection interval in 1.25 ms units, 0 to disconnect
+ * @return none
+ */
+void SNPSim_Connect(uint16_t interval);
+
+/**
+ * Set a function called with the data of each notification and read
+ * confirmation sent by the AP, as the central would receive it.
+ * @param task function called from the model, or 0 for none
+ * @return none
+ */
+void SNPSim_SetTask(void (*task)(uint16_t handle, const uint8_t *data, uint32_t length));
+
+/**
+ * Return the counts kept by the model.
+ * @param none
+ * @return pointer to the counts
+ */
+const struct SNPSim_Stats *SNPSim_GetStats(void);
+
+/**
+ * Serve the model on a new pseudo-terminal instead of the simulator.
+ * Frames go straight over the line, without MRDY and SRDY, and the
+ * model starts as if just powered up.
+ * @param name buffer for the path of the terminal to open, such as /dev/pts/3
+ * @param size size of the buffer
+ * @return file descriptor of the master side, -1 on error
+ */
+int SNPSim_OpenPty(char *name, uint32_t size);
+
+/**
+ * Exchange bytes with the pseudo-terminal, never waits.  Call it often.
+ * @param none
+ * @return -1 if the terminal is gone, otherwise 0
+ */
+int SNPSim_PollPty(void);
+
+#endif // __SNPSIM_H__
@@ -0,0 +1,1012 @@
+// Sim.c
+// Runs on a Linux host
+// Virtual-time model of the MSP432 peripherals behind msp.h, so the
+// drivers in ../inc can be built, run and timed without hardware.
+// See Sim.h for what is and is not modelled.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include "msp.h"
+#include "Sim.h"
+
+DIO_PORT_Interruptable_Type Sim_Port[12];
+Timer_A_Type Sim_TimerA[4];
+EUSCI_A_Type Sim_EUSCIA[4];
+ADC14_Type Sim_ADC14;
+Timer32_Type Sim_Timer32[2];
+DMA_Control_Type Sim_DMAControl;
+DMA_Channel_Type Sim_DMAChannel;
+SysTick_Type Sim_SysTick;
+NVIC_Type Sim_NVIC;
+SCB_Type Sim_SCB;
+PCM_Type Sim_PCM;
+CS_Type Sim_CS;
+FLCTL_Type Sim_FLCTL;
+WDT_A_Type Sim_WDT_A;
+uint32_t Sim_Primask;
+
+#define NEVER UINT64_MAX
+#define ACLK 32768
+#define TXBUFIDLE 0xA5A5     // TXBUF value meaning "not written since last look"
+#define RXQUEUESIZE 4096     // power of 2
+
+// writes to read-only fields of the register file
+#define SETRO8(f,v)  (*(uint8_t *)&(f) = (uint8_t)(v))
+#define SETRO16(f,v) (*(uint16_t *)&(f) = (uint16_t)(v))
+#define SETRO32(f,v) (*(uint32_t *)&(f) = (uint32_t)(v))
+
+static uint64_t Now;          // virtual time in MCLK cycles
+static uint32_t MCLK, SMCLK;
+static int InHandler;         // no nesting: handlers run to completion
+static uint64_t HandlerCycles;   // total time spent in exception handlers
+
+//********* GPIO *********
+struct port{
+  uint8_t out, dir;           // values at last look, to detect writes
+  uint8_t drive, level;       // Sim_SetInput()
+  uint8_t modelMask, modelLevel;
+  uint64_t modelNext;
+  Sim_PortModel_t model;
+  uint32_t decayCycles[8];
+  uint64_t release[8];        // RC pin reads 1 until this time
+};
+static struct port Port[12];
+
+//********* external device *********
+static Sim_Device_t Device;   // Sim_SetDevice()
+static uint64_t DeviceNext;   // time the device asked to run
+
+// Timer_A capture inputs CCIxA reachable from a pin
+static const struct capturepin{
+  uint8_t port, pin, timer, ccr;
+} CapturePins[] = {
+  {7,3, 0,0}, {2,4, 0,1}, {2,5, 0,2}, {2,6, 0,3}, {2,7, 0,4},
+  {8,0, 1,0}, {7,7, 1,1}, {7,6, 1,2}, {7,5, 1,3}, {7,4, 1,4},
+  {8,1, 2,0}, {5,6, 2,1}, {5,7, 2,2}, {6,6, 2,3}, {6,7, 2,4},
+  {10,4, 3,0}, {10,5, 3,1}, {8,2, 3,2}, {9,2, 3,3}, {9,3, 3,4}
+};
+#define NUMCAPTUREPINS (sizeof(CapturePins)/sizeof(CapturePins[0]))
+
+//********* Timer_A *********
+struct timer{
+  uint64_t t0;                // time of last change of clock configuration
+  uint64_t ticks;             // timer clock ticks counted since t0
+  uint16_t clock;             // TASSEL, ID and EX0 at last look
+  uint16_t r;                 // R at last look, to detect writes
+  int down;                   // up/down mode is counting down
+};
+static struct timer Timer[4];
+
+//********* eUSCI_A *********
+struct uart{
+  uint16_t ctlw0;
+  int txShifting, txPending;
+  uint8_t txShift, txBuf;
+  uint64_t txEnd;
+  void (*sink)(uint8_t data);
+  uint8_t rxQueue[RXQUEUESIZE];
+  uint32_t rxPut, rxGet;
+  uint64_t rxNext;
+  uint32_t rxAccesses;        // accesses while UCRXIFG set, polled mode
+  uint32_t rxCount;           // bytes delivered into RXBUF
+};
+static struct uart Uart[4];
+
+//********* SysTick, Timer32, ADC14 *********
+static uint64_t SysTickZero;  // time the counter next reaches 0
+static uint32_t SysTickCtrl, SysTickVal, SysTickLoad;
+static int SysTickPending;
+static uint64_t T32Zero[2];
+static uint32_t T32Control[2], T32Load[2];
+static uint64_t AdcDone;
+static uint16_t Analog[32];
+static uint32_t NvicEnabled[2];
+
+//********* uDMA *********
+// channel control structure at CTLBASE, laid out as the drivers do,
+// with pointer-wide end addresses so it also works on the host
+struct dmacontrol{
+  const volatile void *srcEnd;
+  volatile void *dstEnd;
+  uint32_t control;
+  uint32_t spare;
+};
+#define NUMDMA 8
+static uint32_t DmaEnabled;   // ENASET
+static uint32_t DmaRequest;   // software requests not yet served
+
+//------------Divide------------
+// ceil(a*b/c) without overflow
+static uint64_t MulDivUp(uint64_t a, uint64_t b, uint64_t c){
+  unsigned __int128 p = (unsigned __int128)a*b;
+  return (uint64_t)((p + c - 1)/c);
+}
+static uint64_t MulDiv(uint64_t a, uint64_t b, uint64_t c){
+  return (uint64_t)(((unsigned __int128)a*b)/c);
+}
+
+//============ Timer_A ============
+static uint32_t TimerClock(const Timer_A_Type *t){
+  switch((t->CTL>>8)&0x03){
+    case 1: return ACLK;
+    case 2: return SMCLK;
+    default: return SMCLK;    // TACLK/INCLK pins not modelled
+  }
+}
+static uint32_t TimerDivide(const Timer_A_Type *t){
+  return (1u<<((t->CTL>>6)&0x03))*((t->EX0&0x07) + 1);
+}
+// position of the counter within its cycle, and the cycle length
+static uint32_t TimerLength(const Timer_A_Type *t){
+  switch((t->CTL>>4)&0x03){
+    case 1: return (uint32_t)t->CCR[0] + 1;
+    case 2: return 65536;
+    case 3: return 2*(uint32_t)t->CCR[0];
+    default: return 0;
+  }
+}
+static uint32_t TimerPosition(int n){
+  Timer_A_Type *t = &Sim_TimerA[n];
+  if(((t->CTL>>4)&0x03) == 3 && Timer[n].down){
+    return 2*(uint32_t)t->CCR[0] - t->R;
+  }
+  return t->R;
+}
+// ticks until the counter next reaches value, 0 if never
+static uint32_t TimerDistance(int n, uint32_t value){
+  Timer_A_Type *t = &Sim_TimerA[n];
+  uint32_t length = TimerLength(t);
+  uint32_t pos = TimerPosition(n);
+  uint32_t d, d2;
+  if(length == 0) return 0;
+  if(((t->CTL>>4)&0x03) == 3){
+    if(value > t->CCR[0]) return 0;
+    d = (value + length - pos)%length;
+    if(d == 0) d = length;
+    d2 = (length - value + length - pos)%length;
+    if(d2 == 0) d2 = length;
+    return (d2 < d)? d2 : d;
+  }
+  if(value >= length) return 0;
+  d = (value + length - pos)%length;
+  return (d == 0)? length : d;
+}
+static void TimerSetPosition(int n, uint32_t pos){
+  Timer_A_Type *t = &Sim_TimerA[n];
+  if(((t->CTL>>4)&0x03) == 3){
+    Timer[n].down = (pos > t->CCR[0]);
+    t->R = Timer[n].down? (uint16_t)(2*(uint32_t)t->CCR[0] - pos) : (uint16_t)pos;
+  }else{
+    t->R = (uint16_t)pos;
+  }
+  Timer[n].r = t->R;
+}
+// count k ticks, setting every flag the counter passes
+static void TimerCount(int n, uint64_t k){
+  Timer_A_Type *t = &Sim_TimerA[n];
+  uint32_t length = TimerLength(t);
+  int i;
+  if(length == 0 || k == 0) return;
+  if(TimerPosition(n) >= length){
+    TimerSetPosition(n, 0);   // period shortened below the count
+  }
+  for(i=0; i<7; i=i+1){
+    if((t->CCTL[i]&0x0100) == 0){   // compare mode
+      uint32_t d = TimerDistance(n, t->CCR[i]);
+      if(d && d <= k) t->CCTL[i] |= 0x0001;
+    }
+  }
+  if(TimerDistance(n, 0) <= k) t->CTL |= 0x0001;  // TAIFG at zero
+  TimerSetPosition(n, (uint32_t)((TimerPosition(n) + k)%length));
+}
+static void TimerRebase(int n){
+  Timer_A_Type *t = &Sim_TimerA[n];
+  Timer[n].t0 = Now;
+  Timer[n].ticks = 0;
+  Timer[n].clock = (t->CTL&0x03C0)|(t->EX0&0x07);
+}
+static void TimerUpdate(int n){
+  Timer_A_Type *t = &Sim_TimerA[n];
+  uint64_t total;
+  if(((t->CTL>>4)&0x03) == 0){
+    TimerRebase(n);
+    return;
+  }
+  total = MulDiv(Now - Timer[n].t0, TimerClock(t), (uint64_t)MCLK*TimerDivide(t));
+  TimerCount(n, total - Timer[n].ticks);
+  Timer[n].ticks = total;
+}
+static uint64_t TimerNext(int n){
+  Timer_A_Type *t = &Sim_TimerA[n];
+  uint32_t k = 0, d;
+  int i;
+  if(((t->CTL>>4)&0x03) == 0) return NEVER;
+  for(i=0; i<7; i=i+1){
+    if((t->CCTL[i]&0x0110) == 0x0010){  // compare with interrupt
+      d = TimerDistance(n, t->CCR[i]);
+      if(d && (k == 0 || d < k)) k = d;
+    }
+  }
+  if(t->CTL&0x0002){
+    d = TimerDistance(n, 0);
+    if(d && (k == 0 || d < k)) k = d;
+  }
+  if(k == 0) return NEVER;
+  return Timer[n].t0 + MulDivUp(Timer[n].ticks + k, (uint64_t)MCLK*TimerDivide(t), TimerClock(t));
+}
+static void TimerCommit(int n){
+  Timer_A_Type *t = &Sim_TimerA[n];
+  if(t->CTL&0x0004){          // TACLR
+    t->CTL &= ~0x0004;
+    t->R = 0;
+    Timer[n].down = 0;
+    Timer[n].r = 0;
+    TimerRebase(n);
+  }
+  if(t->R != Timer[n].r){
+    Timer[n].r = t->R;
+  }
+  if(((t->CTL&0x03C0)|(t->EX0&0x07)) != Timer[n].clock){
+    TimerRebase(n);
+  }
+}
+static void TimerCapture(int n, int ccr, int rising){
+  Timer_A_Type *t = &Sim_TimerA[n];
+  uint16_t cctl = t->CCTL[ccr];
+  if((cctl&0x0100) == 0 || (cctl&0x3000) != 0) return;   // not capturing CCIxA
+  if(((cctl&0x4000) && rising) || ((cctl&0x8000) && !rising)){
+    TimerUpdate(n);
+    t->CCR[ccr] = t->R;
+    if(cctl&0x0001) cctl |= 0x0002;                        // COV
+    t->CCTL[ccr] = cctl|0x0001;
+  }
+}
+
+//============ GPIO ============
+static uint8_t PortLevel(int n){
+  DIO_PORT_Interruptable_Type *p = &Sim_Port[n];
+  struct port *s = &Port[n];
+  uint8_t in = 0, external;
+  int i;
+  external = (s->level&s->drive)|(p->OUT&p->REN&~s->drive);
+  external = (external&~s->modelMask)|(s->modelLevel&s->modelMask);
+  for(i=0; i<8; i=i+1){
+    uint8_t bit = 1<<i;
+    if(p->DIR&bit){
+      in |= p->OUT&bit;
+    }else if(s->decayCycles[i] && Now < s->release[i]){
+      in |= bit;
+    }else{
+      in |= external&bit;
+    }
+  }
+  return in;
+}
+static void PortUpdate(int n){
+  DIO_PORT_Interruptable_Type *p = &Sim_Port[n];
+  struct port *s = &Port[n];
+  uint8_t old = p->IN, in, rise, fall;
+  uint32_t i;
+  if(s->model && s->modelNext <= Now){
+    s->modelLevel = s->model(n, Now, &s->modelNext);
+  }
+  in = PortLevel(n);
+  SETRO8(p->IN, in);
+  rise = in&~old;
+  fall = old&~in;
+  if((rise|fall) == 0) return;
+  if(n <= 6){
+    p->IFG |= (rise&~p->IES)|(fall&p->IES);
+  }
+  for(i=0; i<NUMCAPTUREPINS; i=i+1){
+    const struct capturepin *c = &CapturePins[i];
+    uint8_t bit = 1<<c->pin;
+    if(c->port == n && ((rise|fall)&bit) && (p->SEL0&bit) && !(p->SEL1&bit) && !(p->DIR&bit)){
+      TimerCapture(c->timer, c->ccr, (rise&bit) != 0);
+    }
+  }
+}
+static void PortCommit(int n){
+  DIO_PORT_Interruptable_Type *p = &Sim_Port[n];
+  struct port *s = &Port[n];
+  uint8_t discharge = s->dir&~p->DIR&s->out;  // driven high, now input
+  int i;
+  if(Device && (s->out != p->OUT || s->dir != p->DIR)){
+    DeviceNext = Now;         // let the device see the new outputs
+  }
+  for(i=0; i<8; i=i+1){
+    if((discharge&(1<<i)) && s->decayCycles[i]){
+      s->release[i] = Now + s->decayCycles[i];
+    }
+  }
+  s->out = p->OUT;
+  s->dir = p->DIR;
+  PortUpdate(n);
+}
+static uint64_t PortNext(int n){
+  struct port *s = &Port[n];
+  uint64_t next = s->model? s->modelNext : NEVER;
+  int i;
+  for(i=0; i<8; i=i+1){
+    if(s->decayCycles[i] && s->release[i] > Now && s->release[i] < next){
+      next = s->release[i];
+    }
+  }
+  return next;
+}
+
+//============ eUSCI_A ============
+static uint64_t UartFrame(int n){
+  EUSCI_A_Type *u = &Sim_EUSCIA[n];
+  uint32_t clock = (((u->CTLW0>>6)&0x03) == 1)? ACLK : SMCLK;
+  uint64_t bits, i, clocks, brw = u->BRW? u->BRW : 1;
+  if(u->CTLW0&0x0100){        // UCSYNC, SPI
+    return MulDivUp(8*brw, MCLK, clock);
+  }
+  bits = 1 + ((u->CTLW0&0x1000)? 7 : 8) + ((u->CTLW0&0x8000)? 1 : 0) + ((u->CTLW0&0x0800)? 2 : 1);
+  if(u->MCTLW&0x0001){        // UCOS16, UCBRFx of the 16 BITCLK16 are one longer
+    brw = 16*brw + ((u->MCTLW>>4)&0x0F);
+  }
+  clocks = bits*brw;
+  for(i=0; i<bits; i=i+1){    // UCBRSx adds one BRCLK to a bit per 1, bit 0 first
+    clocks = clocks + ((u->MCTLW>>(8 + (i&7)))&1);
+  }
+  return MulDivUp(clocks, MCLK, clock);
+}
+static void UartCommit(int n){
+  EUSCI_A_Type *u = &Sim_EUSCIA[n];
+  struct uart *s = &Uart[n];
+  if((u->CTLW0^s->ctlw0)&0x0001){
+    if(u->CTLW0&0x0001){      // entering reset
+      s->txShifting = s->txPending = 0;
+    }
+    u->IFG = 0x0002;          // UCTXIFG set, UCRXIFG clear
+    u->STATW = 0;
+  }
+  s->ctlw0 = u->CTLW0;
+  if(u->TXBUF != TXBUFIDLE){
+    uint8_t data = (uint8_t)u->TXBUF;
+    u->TXBUF = TXBUFIDLE;
+    if(u->CTLW0&0x0001) return;
+    if(s->txShifting){
+      s->txBuf = data;
+      s->txPending = 1;
+      u->IFG &= ~0x0002;
+    }else{
+      s->txShift = data;
+      s->txShifting = 1;
+      s->txEnd = Now + UartFrame(n);
+      u->IFG |= 0x0002;
+    }
+    u->STATW |= 0x0001;       // UCBUSY
+  }
+}
+static void UartUpdate(int n){
+  EUSCI_A_Type *u = &Sim_EUSCIA[n];
+  struct uart *s = &Uart[n];
+  while(s->txShifting && s->txEnd <= Now){
+    if(s->sink) s->sink(s->txShift);
+    if(s->txPending){
+      s->txShift = s->txBuf;
+      s->txPending = 0;
+      s->txEnd = s->txEnd + UartFrame(n);
+      u->IFG |= 0x0002;
+    }else{
+      s->txShifting = 0;
+      u->STATW &= ~0x0001;
+      u->IFG |= 0x0008;       // UCTXCPTIFG, last bit is out
+    }
+  }
+  while(s->rxGet != s->rxPut && s->rxNext <= Now && (u->CTLW0&0x0001) == 0){
+    if(u->IFG&0x0001) u->STATW |= 0x0020;  // UCOE overrun
+    SETRO16(u->RXBUF, s->rxQueue[s->rxGet&(RXQUEUESIZE-1)]);
+    s->rxGet = s->rxGet + 1;
+    s->rxCount = s->rxCount + 1;
+    s->rxAccesses = 0;
+    u->IFG |= 0x0001;
+    s->rxNext = s->rxNext + UartFrame(n);
+  }
+}
+static uint64_t UartNext(int n){
+  struct uart *s = &Uart[n];
+  uint64_t next = s->txShifting? s->txEnd : NEVER;
+  if(s->rxGet != s->rxPut && s->rxNext < next) next = s->rxNext;
+  return next;
+}
+
+//============ SysTick ============
+static void SysTickCommit(void){
+  uint32_t ctrl = Sim_SysTick.CTRL;
+  if(Sim_SysTick.VAL != SysTickVal){     // any write clears the counter
+    Sim_SysTick.VAL = 0;
+    Sim_SysTick.CTRL = ctrl = ctrl&~0x00010000;
+    SysTickZero = Now + 1 + (Sim_SysTick.LOAD&0x00FFFFFF);
+  }else if((ctrl&0x01) && !(SysTickCtrl&0x01)){
+    SysTickZero = Now + (Sim_SysTick.VAL? Sim_SysTick.VAL : 1 + (Sim_SysTick.LOAD&0x00FFFFFF));
+  }
+  SysTickCtrl = ctrl;
+  SysTickLoad = Sim_SysTick.LOAD&0x00FFFFFF;
+  SysTickVal = Sim_SysTick.VAL;
+}
+static void SysTickUpdate(void){
+  uint64_t period = (uint64_t)SysTickLoad + 1, d;
+  if((Sim_SysTick.CTRL&0x01) == 0) return;
+  if(SysTickZero <= Now){
+    SysTickZero = SysTickZero + ((Now - SysTickZero)/period + 1)*period;
+    Sim_SysTick.CTRL |= 0x00010000;       // COUNTFLAG
+    SysTickCtrl = Sim_SysTick.CTRL;
+    if(Sim_SysTick.CTRL&0x02) SysTickPending = 1;
+  }
+  d = SysTickZero - Now;
+  Sim_SysTick.VAL = SysTickVal = (d >= period)? 0 : (uint32_t)d;
+}
+static uint64_t SysTickNext(void){
+  if((Sim_SysTick.CTRL&0x03) == 0x03) return SysTickZero;
+  return NEVER;
+}
+
+//============ Timer32 ============
+static uint64_t T32Period(int n){
+  static const uint32_t prescale[4] = {1, 16, 256, 256};
+  uint64_t load = Sim_Timer32[n].LOAD;
+  if((Sim_Timer32[n].CONTROL&0x02) == 0) load = load&0xFFFF;
+  return (load + 1)*prescale[(Sim_Timer32[n].CONTROL>>2)&0x03];
+}
+static void T32Commit(int n){
+  Timer32_Type *t = &Sim_Timer32[n];
+  if(t->INTCLR){
+    t->INTCLR = 0;
+    SETRO32(t->RIS, 0);
+    SETRO32(t->MIS, 0);
+  }
+  if(t->LOAD != T32Load[n] || ((t->CONTROL^T32Control[n])&0x80)){
+    T32Zero[n] = Now + T32Period(n);
+  }
+  T32Load[n] = t->LOAD;
+  T32Control[n] = t->CONTROL;
+}
+static void T32Update(int n){
+  Timer32_Type *t = &Sim_Timer32[n];
+  uint64_t period = T32Period(n);
+  if((t->CONTROL&0x80) == 0) return;
+  if(T32Zero[n] <= Now){
+    if(t->CONTROL&0x01){      // one shot
+      t->CONTROL &= ~0x80;
+      T32Control[n] = t->CONTROL;
+    }else{
+      T32Zero[n] = T32Zero[n] + ((Now - T32Zero[n])/period + 1)*period;
+    }
+    SETRO32(t->RIS, 1);
+    SETRO32(t->MIS, (t->CONTROL&0x20)? 1 : 0);
+  }
+  SETRO32(t->VALUE, MulDiv(T32Zero[n] - Now, (uint64_t)t->LOAD + 1, period));
+}
+static uint64_t T32Next(int n){
+  if((Sim_Timer32[n].CONTROL&0xA0) == 0xA0) return T32Zero[n];
+  return NEVER;
+}
+
+//============ ADC14 ============
+static void AdcCommit(void){
+  if((Sim_ADC14.CTL0&0x00000003) == 0x00000003 && AdcDone == NEVER){
+    Sim_ADC14.CTL0 = (Sim_ADC14.CTL0&~0x00000001)|0x00010000;  // BUSY
+    SETRO32(Sim_ADC14.IFGR0, 0);
+    AdcDone = Now + MulDivUp(48, MCLK, SMCLK);  // 32 SHM + 16 conversion
+  }
+}
+static void AdcUpdate(void){
+  uint32_t i, flags = 0;
+  if(AdcDone > Now) return;
+  AdcDone = NEVER;
+  i = (Sim_ADC14.CTL1>>16)&0x1F;
+  do{
+    Sim_ADC14.MEM[i] = Analog[Sim_ADC14.MCTL[i]&0x1F];
+    flags |= 1u<<i;
+    if(Sim_ADC14.MCTL[i]&0x80) break;                // end of sequence
+    if(((Sim_ADC14.CTL0>>17)&0x03) == 0) break;      // single channel
+    i = (i + 1)&0x1F;
+  }while(i != ((Sim_ADC14.CTL1>>16)&0x1F));
+  SETRO32(Sim_ADC14.IFGR0, Sim_ADC14.IFGR0|flags);
+  Sim_ADC14.CTL0 &= ~0x00010000;
+}
+
+//============ uDMA ============
+static void DmaCommit(void){
+  DmaEnabled = (DmaEnabled|Sim_DMAControl.ENASET)&~Sim_DMAControl.ENACLR;
+  Sim_DMAControl.ENACLR = 0;
+  Sim_DMAControl.ENASET = DmaEnabled;
+  DmaRequest = DmaRequest|Sim_DMAControl.SWREQ|Sim_DMAChannel.SW_CHTRIG;
+  Sim_DMAControl.SWREQ = 0;
+  Sim_DMAChannel.SW_CHTRIG = 0;
+  SETRO32(Sim_DMAChannel.INT0_SRCFLG, Sim_DMAChannel.INT0_SRCFLG&~Sim_DMAChannel.INT0_CLRFLG);
+  Sim_DMAChannel.INT0_CLRFLG = 0;
+}
+// move one item; a write to an eUSCI_A TXBUF starts the transmitter
+static void DmaMove(struct dmacontrol *d){
+  uint32_t left = ((d->control>>4)&0x3FF) + 1;   // items still to move
+  uint32_t size = 1u<<((d->control>>24)&0x03);
+  uint32_t srcInc = (d->control>>26)&0x03, dstInc = (d->control>>30)&0x03;
+  const volatile uint8_t *src = (const volatile uint8_t *)d->srcEnd;
+  volatile uint8_t *dst = (volatile uint8_t *)d->dstEnd;
+  uint32_t value = 0;
+  int n;
+  if(srcInc != 3) src = src - (left - 1)*(1u<<srcInc);
+  if(dstInc != 3) dst = dst - (left - 1)*(1u<<dstInc);
+  memcpy(&value, (const void *)src, size);
+  for(n=0; n<4; n=n+1){
+    if(dst == (volatile uint8_t *)&Sim_EUSCIA[n].TXBUF){
+      Sim_EUSCIA[n].TXBUF = (uint8_t)value;
+      UartCommit(n);
+      break;
+    }
+  }
+  if(n == 4) memcpy((void *)dst, &value, size);
+  if(left == 1){
+    d->control = d->control&~0x3FF7;   // N_MINUS_1 0 and CYCLE_CTRL stop
+  }else{
+    d->control = d->control - 0x10;
+  }
+}
+// serve each enabled channel while it is requested: by software, or
+// for source 1 of an even channel by UCAxTXIFG of eUSCI_A(channel/2)
+static void DmaUpdate(void){
+  struct dmacontrol *d;
+  uint32_t items;
+  int c;
+  if(((Sim_DMAControl.CFG&0x01) == 0) || (DmaEnabled == 0)) return;
+  for(c=0; c<NUMDMA; c=c+1){
+    while(((DmaEnabled>>c)&1) && (((DmaRequest>>c)&1) ||
+          (((c&1) == 0) && (Sim_DMAChannel.CH_SRCCFG[c] == 1) && (Sim_EUSCIA[c/2].IFG&0x0002)))){
+      DmaRequest = DmaRequest&~(1u<<c);
+      d = &((struct dmacontrol *)Sim_DMAControl.CTLBASE)[c];
+      for(items = 1u<<((d->control>>14)&0x0F); items && (d->control&0x07); items=items-1){
+        DmaMove(d);           // 2^R_POWER items per request
+      }
+      if((d->control&0x07) == 0){
+        DmaEnabled = DmaEnabled&~(1u<<c);   // done, the channel disables itself
+        Sim_DMAControl.ENASET = DmaEnabled;
+        SETRO32(Sim_DMAChannel.INT0_SRCFLG, Sim_DMAChannel.INT0_SRCFLG|(1u<<c));
+      }
+    }
+  }
+}
+
+//============ NVIC ============
+static void NvicCommit(void){
+  int i;
+  for(i=0; i<2; i=i+1){
+    NvicEnabled[i] = (NvicEnabled[i]|Sim_NVIC.ISER[i])&~Sim_NVIC.ICER[i];
+    Sim_NVIC.ICER[i] = 0;
+    Sim_NVIC.ISER[i] = NvicEnabled[i];
+  }
+}
+
+//============ scheduler ============
+static void *LastBlock;       // register block returned by the last access
+static uint32_t LastSize;
+static uint8_t LastCopy[sizeof(NVIC_Type)];   // its contents at that time (largest block)
+static uint64_t NextTime;     // time of the next peripheral event
+static int NextValid;         // NextTime is up to date
+
+// Drivers write a register right after Sim_Access() returns its block,
+// so only that block can have changed since the last access.
+static void Commit(void){
+  uint8_t *reg = LastBlock;
+  if(reg == 0) return;
+  LastBlock = 0;
+  if(LastSize == 0 || memcmp(reg, LastCopy, LastSize) == 0) return;  // only read
+  NextValid = 0;
+  if(reg >= (uint8_t *)&Sim_Port[1] && reg < (uint8_t *)&Sim_Port[12]){
+    PortCommit((int)((DIO_PORT_Interruptable_Type *)reg - Sim_Port));
+  }else if(reg >= (uint8_t *)&Sim_TimerA[0] && reg < (uint8_t *)&Sim_TimerA[4]){
+    TimerCommit((int)((Timer_A_Type *)reg - Sim_TimerA));
+  }else if(reg >= (uint8_t *)&Sim_EUSCIA[0] && reg < (uint8_t *)&Sim_EUSCIA[4]){
+    UartCommit((int)((EUSCI_A_Type *)reg - Sim_EUSCIA));
+  }else if(reg == (uint8_t *)&Sim_SysTick){
+    SysTickCommit();
+  }else if(reg >= (uint8_t *)&Sim_Timer32[0] && reg < (uint8_t *)&Sim_Timer32[2]){
+    T32Commit((int)((Timer32_Type *)reg - Sim_Timer32));
+  }else if(reg == (uint8_t *)&Sim_ADC14){
+    AdcCommit();
+  }else if(reg == (uint8_t *)&Sim_NVIC){
+    NvicCommit();
+  }else if(reg == (uint8_t *)&Sim_DMAControl || reg == (uint8_t *)&Sim_DMAChannel){
+    DmaCommit();
+  }
+  DmaUpdate();                // a write may have enabled, requested or fed a channel
+}
+// bring the time-dependent fields of one block up to date before it is read
+static void Refresh(void *reg){
+  uint8_t *r = reg;
+  if(r >= (uint8_t *)&Sim_TimerA[0] && r < (uint8_t *)&Sim_TimerA[4]){
+    TimerUpdate((int)((Timer_A_Type *)r - Sim_TimerA));
+  }else if(r == (uint8_t *)&Sim_SysTick){
+    SysTickUpdate();
+  }else if(r >= (uint8_t *)&Sim_Timer32[0] && r < (uint8_t *)&Sim_Timer32[2]){
+    T32Update((int)((Timer32_Type *)r - Sim_Timer32));
+  }
+}
+// size of the modelled register block at reg, 0 if not modelled
+static uint32_t BlockSize(void *reg){
+  uint8_t *r = reg;
+  if(r >= (uint8_t *)&Sim_Port[1] && r < (uint8_t *)&Sim_Port[12]) return sizeof(Sim_Port[0]);
+  if(r >= (uint8_t *)&Sim_TimerA[0] && r < (uint8_t *)&Sim_TimerA[4]) return sizeof(Sim_TimerA[0]);
+  if(r >= (uint8_t *)&Sim_EUSCIA[0] && r < (uint8_t *)&Sim_EUSCIA[4]) return sizeof(Sim_EUSCIA[0]);
+  if(r >= (uint8_t *)&Sim_Timer32[0] && r < (uint8_t *)&Sim_Timer32[2]) return sizeof(Sim_Timer32[0]);
+  if(r == (uint8_t *)&Sim_SysTick) return sizeof(Sim_SysTick);
+  if(r == (uint8_t *)&Sim_ADC14) return sizeof(Sim_ADC14);
+  if(r == (uint8_t *)&Sim_NVIC) return sizeof(Sim_NVIC);
+  if(r == (uint8_t *)&Sim_DMAControl) return sizeof(Sim_DMAControl);
+  if(r == (uint8_t *)&Sim_DMAChannel) return sizeof(Sim_DMAChannel);
+  return 0;
+}
+static uint64_t NextEvent(void){
+  uint64_t next = NEVER, t;
+  int i;
+  for(i=1; i<12; i=i+1){ t = PortNext(i); if(t < next) next = t; }
+  for(i=0; i<4; i=i+1){ t = TimerNext(i); if(t < next) next = t; }
+  for(i=0; i<4; i=i+1){ t = UartNext(i); if(t < next) next = t; }
+  t = SysTickNext(); if(t < next) next = t;
+  for(i=0; i<2; i=i+1){ t = T32Next(i); if(t < next) next = t; }
+  if(AdcDone < next) next = AdcDone;
+  if(Device && DeviceNext < next) next = DeviceNext;
+  return next;
+}
+static void Update(void){
+  int i;
+  for(i=0; i<4; i=i+1) TimerUpdate(i);
+  SysTickUpdate();
+  for(i=0; i<2; i=i+1) T32Update(i);
+  AdcUpdate();
+  for(i=0; i<4; i=i+1) UartUpdate(i);
+  DmaUpdate();
+  for(i=1; i<12; i=i+1) PortUpdate(i);
+}
+// Between events only the clock moves; peripherals are updated at
+// each event and any block is refreshed when it is accessed.
+static void Run(uint64_t until){
+  while(Now < until){
+    if(!NextValid){
+      NextTime = NextEvent();
+      NextValid = 1;
+    }
+    if(NextTime > until){
+      Now = until;
+      return;
+    }
+    Now = (NextTime > Now)? NextTime : Now + 1;
+    Update();
+    if(Device && DeviceNext <= Now){
+      uint64_t next;
+      DeviceNext = NEVER;
+      next = Device(Now);     // may commit a write that reschedules it
+      if(next < DeviceNext) DeviceNext = next;
+    }
+    NextValid = 0;
+    Sim_Dispatch();
+  }
+}
+
+//============ interrupts ============
+extern void TA0_0_IRQHandler(void) __attribute__((weak));
+extern void TA0_N_IRQHandler(void) __attribute__((weak));
+extern void TA1_0_IRQHandler(void) __attribute__((weak));
+extern void TA1_N_IRQHandler(void) __attribute__((weak));
+extern void TA2_0_IRQHandler(void) __attribute__((weak));
+extern void TA2_N_IRQHandler(void) __attribute__((weak));
+extern void TA3_0_IRQHandler(void) __attribute__((weak));
+extern void TA3_N_IRQHandler(void) __attribute__((weak));
+extern void EUSCIA0_IRQHandler(void) __attribute__((weak));
+extern void EUSCIA1_IRQHandler(void) __attribute__((weak));
+extern void EUSCIA2_IRQHandler(void) __attribute__((weak));
+extern void EUSCIA3_IRQHandler(void) __attribute__((weak));
+extern void ADC14_IRQHandler(void) __attribute__((weak));
+extern void T32_INT1_IRQHandler(void) __attribute__((weak));
+extern void T32_INT2_IRQHandler(void) __attribute__((weak));
+extern void PORT1_IRQHandler(void) __attribute__((weak));
+extern void PORT2_IRQHandler(void) __attribute__((weak));
+extern void PORT3_IRQHandler(void) __attribute__((weak));
+extern void PORT4_IRQHandler(void) __attribute__((weak));
+extern void PORT5_IRQHandler(void) __attribute__((weak));
+extern void PORT6_IRQHandler(void) __attribute__((weak));
+extern void SysTick_Handler(void) __attribute__((weak));
+
+#define NUMIRQ 41
+#define SYSTICKIRQ (-1)
+static void (*const Handler[NUMIRQ])(void) = {
+  [8]  = TA0_0_IRQHandler,   [9]  = TA0_N_IRQHandler,
+  [10] = TA1_0_IRQHandler,   [11] = TA1_N_IRQHandler,
+  [12] = TA2_0_IRQHandler,   [13] = TA2_N_IRQHandler,
+  [14] = TA3_0_IRQHandler,   [15] = TA3_N_IRQHandler,
+  [16] = EUSCIA0_IRQHandler, [17] = EUSCIA1_IRQHandler,
+  [18] = EUSCIA2_IRQHandler, [19] = EUSCIA3_IRQHandler,
+  [24] = ADC14_IRQHandler,
+  [25] = T32_INT1_IRQHandler, [26] = T32_INT2_IRQHandler,
+  [35] = PORT1_IRQHandler,   [36] = PORT2_IRQHandler,
+  [37] = PORT3_IRQHandler,   [38] = PORT4_IRQHandler,
+  [39] = PORT5_IRQHandler,   [40] = PORT6_IRQHandler
+};
+
+// is the peripheral requesting interrupt n
+static int Asserted(int n){
+  if(n >= 8 && n <= 15){
+    Timer_A_Type *t = &Sim_TimerA[(n - 8)/2];
+    int i;
+    if((n&1) == 0) return (t->CCTL[0]&0x0011) == 0x0011;
+    if((t->CTL&0x0003) == 0x0003) return 1;
+    for(i=1; i<7; i=i+1){
+      if((t->CCTL[i]&0x0011) == 0x0011) return 1;
+    }
+    return 0;
+  }
+  if(n >= 16 && n <= 19) return (Sim_EUSCIA[n-16].IE&Sim_EUSCIA[n-16].IFG&0x000F) != 0;
+  if(n == 24) return (Sim_ADC14.IER0&Sim_ADC14.IFGR0) != 0;
+  if(n == 25 || n == 26) return Sim_Timer32[n-25].MIS != 0;
+  if(n >= 35 && n <= 40) return (Sim_Port[n-34].IE&Sim_Port[n-34].IFG) != 0;
+  return 0;
+}
+static uint32_t Priority(int n){
+  if(n == SYSTICKIRQ) return Sim_SCB.SHP[11]>>5;
+  return ((Sim_NVIC.IP[n/4]>>(8*(n%4)))&0xFF)>>5;
+}
+static int Highest(void){
+  int n, best = SYSTICKIRQ - 1;
+  uint32_t bestPriority = 8, enabled;
+  if(SysTickPending){
+    best = SYSTICKIRQ;
+    bestPriority = Priority(SYSTICKIRQ);
+  }
+  for(n=0; n<NUMIRQ; n=n+1){
+    enabled = NvicEnabled[n/32]>>(n%32);
+    if(enabled == 0){
+      n = (n|31);             // nothing else enabled in this word
+    }else if((enabled&1) && Handler[n] && Asserted(n) && Priority(n) < bestPriority){
+      best = n;
+      bestPriority = Priority(n);
+    }
+  }
+  return best;
+}
+
+//------------Sim_Dispatch------------
+// Run pending interrupts in priority order until none are left.
+// Input: none
+// Output: none
+void Sim_Dispatch(void){
+  uint64_t start;
+  int n;
+  while(!Sim_Primask && !InHandler){
+    uint32_t rxCount = 0;
+    n = Highest();
+    if(n < SYSTICKIRQ) return;
+    InHandler = 1;
+    start = Now;
+    Run(Now + SIM_EXCEPTIONCYCLES);
+    if(n == SYSTICKIRQ){
+      SysTickPending = 0;
+      if(SysTick_Handler) SysTick_Handler();
+    }else{
+      if(n >= 8 && n <= 15 && (n&1) == 0){
+        Sim_TimerA[(n - 8)/2].CCTL[0] &= ~0x0001;  // CCR0 CCIFG clears on service
+      }
+      if(n >= 16 && n <= 19) rxCount = Uart[n-16].rxCount;
+      Handler[n]();
+    }
+    Commit();
+    Run(Now + SIM_EXCEPTIONCYCLES);
+    if(n >= 16 && n <= 19 && Uart[n-16].rxCount == rxCount){
+      Sim_EUSCIA[n-16].IFG &= ~0x0001;  // the handler read RXBUF
+    }
+    HandlerCycles = HandlerCycles + (Now - start);
+    InHandler = 0;
+  }
+}
+
+//============ public ============
+//------------Sim_Access------------
+// Called by the peripheral macros in msp.h for every register access.
+// Input: register block about to be read or written
+// Output: the same pointer
+void *Sim_Access(void *reg){
+  int i;
+  Commit();
+  Run(Now + SIM_ACCESSCYCLES);
+  Refresh(reg);
+  Sim_Dispatch();
+  if(reg >= (void *)&Sim_EUSCIA[0] && reg < (void *)&Sim_EUSCIA[4]){
+    i = (int)((EUSCI_A_Type *)reg - Sim_EUSCIA);
+    if((Sim_EUSCIA[i].IFG&0x0001) && (Sim_EUSCIA[i].IE&0x0001) == 0){
+      Uart[i].rxAccesses = Uart[i].rxAccesses + 1;
+      if(Uart[i].rxAccesses > 2){  // flag seen, then RXBUF read
+        Sim_EUSCIA[i].IFG &= ~0x0001;
+      }
+    }
+  }
+  LastBlock = reg;
+  LastSize = BlockSize(reg);
+  memcpy(LastCopy, reg, LastSize);
+  return reg;
+}
+
+void Sim_Init(void){
+  int i;
+  memset(Sim_Port, 0, sizeof(Sim_Port));
+  memset(Sim_TimerA, 0, sizeof(Sim_TimerA));
+  memset(Sim_EUSCIA, 0, sizeof(Sim_EUSCIA));
+  memset(&Sim_ADC14, 0, sizeof(Sim_ADC14));
+  memset(Sim_Timer32, 0, sizeof(Sim_Timer32));
+  memset(&Sim_SysTick, 0, sizeof(Sim_SysTick));
+  memset(&Sim_NVIC, 0, sizeof(Sim_NVIC));
+  memset(&Sim_SCB, 0, sizeof(Sim_SCB));
+  memset(&Sim_PCM, 0, sizeof(Sim_PCM));
+  memset(&Sim_CS, 0, sizeof(Sim_CS));
+  memset(&Sim_FLCTL, 0, sizeof(Sim_FLCTL));
+  memset(&Sim_WDT_A, 0, sizeof(Sim_WDT_A));
+  memset(Port, 0, sizeof(Port));
+  memset(Timer, 0, sizeof(Timer));
+  memset(Uart, 0, sizeof(Uart));
+  memset(Analog, 0, sizeof(Analog));
+  memset(NvicEnabled, 0, sizeof(NvicEnabled));
+  memset(&Sim_DMAControl, 0, sizeof(Sim_DMAControl));
+  memset(&Sim_DMAChannel, 0, sizeof(Sim_DMAChannel));
+  DmaEnabled = DmaRequest = 0;
+  Now = 0;
+  MCLK = SMCLK = 3000000;
+  InHandler = 0;
+  HandlerCycles = 0;
+  Sim_Primask = 0;
+  for(i=0; i<4; i=i+1){
+    Sim_EUSCIA[i].CTLW0 = Uart[i].ctlw0 = 0x0001;  // held in reset
+    Sim_EUSCIA[i].IFG = 0x0002;
+    Sim_EUSCIA[i].TXBUF = TXBUFIDLE;
+    Timer[i].clock = 0;
+  }
+  for(i=1; i<12; i=i+1){
+    Port[i].modelNext = NEVER;
+  }
+  Sim_SysTick.LOAD = SysTickLoad = 0;
+  SysTickVal = SysTickCtrl = 0;
+  SysTickZero = NEVER;
+  SysTickPending = 0;
+  for(i=0; i<2; i=i+1){
+    Sim_Timer32[i].LOAD = T32Load[i] = 0xFFFFFFFF;
+    Sim_Timer32[i].CONTROL = T32Control[i] = 0x20;
+    T32Zero[i] = NEVER;
+  }
+  AdcDone = NEVER;
+  Device = 0;
+  DeviceNext = NEVER;
+  LastBlock = 0;
+  NextValid = 0;
+}
+
+uint64_t Sim_Now(void){
+  Commit();
+  return Now;
+}
+
+uint64_t Sim_HandlerCycles(void){
+  return HandlerCycles;
+}
+
+void Sim_Advance(uint64_t cycles){
+  Commit();
+  Sim_Dispatch();             // the last write may have made an interrupt pending
+  Run(Now + cycles);
+}
+
+void Sim_Idle(void){
+  uint64_t next;
+  Commit();
+  next = NextEvent();
+  if(next != NEVER && next > Now){
+    Run(next);
+  }
+  Sim_Dispatch();
+}
+
+void Sim_SetClocks(uint32_t mclk, uint32_t smclk){
+  int i;
+  Commit();
+  for(i=0; i<4; i=i+1) TimerUpdate(i);
+  MCLK = mclk;
+  SMCLK = smclk;
+  for(i=0; i<4; i=i+1) TimerRebase(i);
+  NextValid = 0;
+}
+
+uint32_t Sim_GetMCLK(void){
+  return MCLK;
+}
+
+void Sim_SetInput(uint32_t port, uint8_t mask, uint8_t value){
+  Port[port].drive |= mask;
+  Port[port].level = (Port[port].level&~mask)|(value&mask);
+  Commit();
+  PortUpdate(port);
+  NextValid = 0;
+}
+
+void Sim_SetPortModel(uint32_t port, uint8_t mask, Sim_PortModel_t model){
+  Port[port].model = model;
+  Port[port].modelMask = model? mask : 0;
+  Port[port].modelNext = model? Now : NEVER;
+  Commit();
+  PortUpdate(port);
+  NextValid = 0;
+}
+
+void Sim_SetDevice(Sim_Device_t device){
+  Commit();
+  Device = device;
+  DeviceNext = device? Now : NEVER;
+  NextValid = 0;
+}
+
+void Sim_SetDecay(uint32_t port, uint32_t pin, uint32_t us){
+  Port[port].decayCycles[pin] = (uint32_t)MulDivUp(us, MCLK, 1000000);
+}
+
+void Sim_SetAnalog(uint32_t channel, uint16_t value){
+  Analog[channel&0x1F] = value;
+}
+
+uint32_t Sim_UartReceive(uint32_t module, const uint8_t *data, uint32_t length){
+  struct uart *s = &Uart[module];
+  uint32_t n = 0;
+  Commit();
+  if(s->rxGet == s->rxPut){
+    s->rxNext = Now + UartFrame(module);
+  }
+  while(n < length && (s->rxPut - s->rxGet) < RXQUEUESIZE){
+    s->rxQueue[s->rxPut&(RXQUEUESIZE-1)] = data[n];
+    s->rxPut = s->rxPut + 1;
+    n = n + 1;
+  }
+  NextValid = 0;
+  return n;
+}
+
+void Sim_SetUartSink(uint32_t module, void (*sink)(uint8_t data)){
+  Uart[module].sink = sink;
+}
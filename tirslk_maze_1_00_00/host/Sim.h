@@ -0,0 +1,267 @@
+/**
+ * @file      Sim.h
+ * @brief     Virtual-time model of the MSP432 peripherals used by ../inc
+ * @details   The host build compiles the unmodified drivers in ../inc
+ * against msp.h in this directory.  Each time a driver touches a
+ * peripheral, Sim_Access() charges SIM_ACCESSCYCLES bus cycles to a
+ * 64-bit virtual clock (counted in MCLK cycles), lets the peripheral
+ * models catch up to the new time, and dispatches any interrupt that
+ * became pending.  Register writes are noticed on the following access.<br>
+ * Modelled: GPIO input levels with pull resistors, edge interrupts and
+ * capture inputs, Timer_A (up, continuous, up/down, compare and capture),
+ * eUSCI_A in UART and SPI mode with real shift times, SysTick, Timer32,
+ * single-sequence ADC14 conversions, NVIC enables and priorities,
+ * basic-mode uDMA transfers on channels 0-7 started by software or by
+ * UCAxTXIFG, and one external device attached to the pins and UARTs
+ * (Sim_SetDevice).  A DMA transfer takes no CPU or bus time.
+ * Not modelled: DMA interrupts, flash, low-power modes, interrupt
+ * nesting, and the cost of plain CPU instructions (only bus accesses,
+ * delays and exception entry/exit advance virtual time).<br>
+ * A receive flag (UCRXIFG) is cleared when the eUSCI interrupt handler
+ * returns; in polled mode it is cleared by the second access to the
+ * module after the flag was set, which matches the
+ * "wait for UCRXIFG, then read RXBUF" sequence used by the drivers.
+ * The transmit complete flag (UCTXCPTIFG) is set when the shift
+ * register empties with nothing waiting in TXBUF, and is cleared only
+ * by software.
+ * @version   V1.0
+ * @author    Daniel and Jonathan Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ ******************************************************************************/
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef __SIM_H__
+#define __SIM_H__
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * \brief bus cycles charged for each peripheral register access
+ */
+#define SIM_ACCESSCYCLES 2
+
+/**
+ * \brief cycles charged for exception entry and again for exception return
+ */
+#define SIM_EXCEPTIONCYCLES 12
+
+/**
+ * \brief index of port J in Sim_Port[]
+ */
+#define SIM_PJ 11
+
+// register files, reached through the macros in msp.h
+extern DIO_PORT_Interruptable_Type Sim_Port[12];
+extern Timer_A_Type Sim_TimerA[4];
+extern EUSCI_A_Type Sim_EUSCIA[4];
+extern ADC14_Type Sim_ADC14;
+extern Timer32_Type Sim_Timer32[2];
+extern DMA_Control_Type Sim_DMAControl;
+extern DMA_Channel_Type Sim_DMAChannel;
+extern SysTick_Type Sim_SysTick;
+extern NVIC_Type Sim_NVIC;
+extern SCB_Type Sim_SCB;
+extern PCM_Type Sim_PCM;
+extern CS_Type Sim_CS;
+extern FLCTL_Type Sim_FLCTL;
+extern WDT_A_Type Sim_WDT_A;
+
+/**
+ * Account for one peripheral access and return the register block.
+ * Used by the peripheral macros in msp.h; drivers never call it directly.
+ * @param reg pointer to a register block in the simulated register file
+ * @return reg
+ */
+void *Sim_Access(void *reg);
+
+/**
+ * Reset the register file, all peripheral models and the virtual clock.
+ * MCLK and SMCLK start at 3 MHz and ACLK at 32,768 Hz, as after a reset.
+ * @param none
+ * @return none
+ */
+void Sim_Init(void);
+
+/**
+ * Return the current virtual time.
+ * @param none
+ * @return time in MCLK cycles since Sim_Init()
+ */
+uint64_t Sim_Now(void);
+
+/**
+ * Return the virtual time spent in interrupt handlers, including
+ * exception entry and return.  Used to measure background CPU load.
+ * @param none
+ * @return MCLK cycles since Sim_Init()
+ */
+uint64_t Sim_HandlerCycles(void);
+
+/**
+ * Let virtual time pass, running peripherals and interrupts on the way.
+ * @param cycles number of MCLK cycles to advance
+ * @return none
+ */
+void Sim_Advance(uint64_t cycles);
+
+/**
+ * Advance virtual time to the next peripheral event, as the core would
+ * in WFI.  Returns immediately if no event is scheduled.
+ * @param none
+ * @return none
+ */
+void Sim_Idle(void);
+
+/**
+ * Set the processor and subsystem clocks.
+ * @param mclk MCLK frequency in Hz (the unit of virtual time)
+ * @param smclk SMCLK frequency in Hz
+ * @return none
+ */
+void Sim_SetClocks(uint32_t mclk, uint32_t smclk);
+
+/**
+ * Return the MCLK frequency.
+ * @param none
+ * @return MCLK in Hz
+ */
+uint32_t Sim_GetMCLK(void);
+
+/**
+ * Drive input pins of a port from outside the chip.  Pins never driven
+ * float, and read their pull resistor when REN is set, otherwise 0.
+ * @param port 1 to 10, or SIM_PJ
+ * @param mask pins to drive
+ * @param value levels for the pins in mask
+ * @return none
+ */
+void Sim_SetInput(uint32_t port, uint8_t mask, uint8_t value);
+
+/**
+ * Function that computes external pin levels from the virtual time.
+ * It returns the levels and stores in *next the time at which they
+ * will next change (UINT64_MAX if never).  It must not access peripherals.
+ */
+typedef uint8_t (*Sim_PortModel_t)(uint32_t port, uint64_t now, uint64_t *next);
+
+/**
+ * Attach a time-dependent model to a set of pins, for example a wheel
+ * encoder.  The model overrides Sim_SetInput() on those pins.
+ * @param port 1 to 10, or SIM_PJ
+ * @param mask pins driven by the model
+ * @param model function computing the levels, or 0 to detach
+ * @return none
+ */
+void Sim_SetPortModel(uint32_t port, uint8_t mask, Sim_PortModel_t model);
+
+/**
+ * Function that models a chip outside the MSP432, for example the
+ * CC2650 on the BLE booster.  It is called at the time it last asked
+ * for and soon after any write that changes a port output or direction,
+ * and returns the next time it wants to run (UINT64_MAX if only pin
+ * changes matter).  It reads MSP432 outputs from Sim_Port[] and may call
+ * Sim_SetInput() and Sim_UartReceive(), but must not access peripherals.
+ */
+typedef uint64_t (*Sim_Device_t)(uint64_t now);
+
+/**
+ * Attach an external device; there is at most one.  It first runs at
+ * the next event.
+ * @param device function modelling the device, or 0 to detach
+ * @return none
+ */
+void Sim_SetDevice(Sim_Device_t device);
+
+/**
+ * Model a QTR-style RC sensor on a pin: after the pin has been driven
+ * high and then turned into an input, it reads 1 for the given time and
+ * then falls to its external level.
+ * @param port 1 to 10, or SIM_PJ
+ * @param pin pin number 0 to 7
+ * @param us decay time in microseconds (0 removes the model)
+ * @return none
+ */
+void Sim_SetDecay(uint32_t port, uint32_t pin, uint32_t us);
+
+/**
+ * Set the result of an ADC14 channel.
+ * @param channel analog input 0 to 31
+ * @param value 14-bit result
+ * @return none
+ */
+void Sim_SetAnalog(uint32_t channel, uint16_t value);
+
+/**
+ * Queue bytes on the receive line of an eUSCI_A module.  They arrive one
+ * frame time apart at the configured baud rate.
+ * @param module 0 to 3
+ * @param data bytes to receive
+ * @param length number of bytes
+ * @return number of bytes queued (less than length if the queue is full)
+ */
+uint32_t Sim_UartReceive(uint32_t module, const uint8_t *data, uint32_t length);
+
+/**
+ * Register a function called with each byte as its last bit leaves the
+ * transmit shift register of an eUSCI_A module.
+ * @param module 0 to 3
+ * @param sink function called from the simulator, or 0 to discard
+ * @return none
+ */
+void Sim_SetUartSink(uint32_t module, void (*sink)(uint8_t data));
+
+/**
+ * Model of the Cortex-M I bit, used by CortexMSim.c.
+ * 1 means interrupts are disabled.
+ */
+extern uint32_t Sim_Primask;
+
+/**
+ * Run any pending interrupt that is now allowed; used by CortexMSim.c
+ * after the I bit is cleared.
+ * @param none
+ * @return none
+ */
+void Sim_Dispatch(void);
+
+#endif // __SIM_H__
@@ -0,0 +1,274 @@
+/**
+ * @file      msp.h
+ * @brief     Simulated MSP432P401R register file for host builds
+ * @details   Stands in for the TI device header when the drivers in
+ * ../inc are compiled on a Linux host.  Only the registers the
+ * drivers actually use are declared.  Every peripheral name
+ * (P1, TIMER_A0, EUSCI_A0, ...) expands to a call to Sim_Access(),
+ * which charges the bus cycles of the access to virtual time and
+ * lets the peripheral models in Sim.c catch up before the register
+ * is read or written.  See Sim.h for the model.
+ * @version   V1.0
+ * @author    Daniel and Jonathan Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ ******************************************************************************/
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef __MSP_H__
+#define __MSP_H__
+#include <stdint.h>
+
+#define __I  volatile const
+#define __O  volatile
+#define __IO volatile
+
+// ***************** Digital I/O ports ****************
+typedef struct {
+  __I  uint8_t IN;
+  __IO uint8_t OUT;
+  __IO uint8_t DIR;
+  __IO uint8_t REN;
+  __IO uint8_t DS;
+  __IO uint8_t SEL0;
+  __IO uint8_t SEL1;
+  __IO uint8_t SELC;
+  __IO uint8_t IES;
+  __IO uint8_t IE;
+  __IO uint8_t IFG;
+  __I  uint16_t IV;
+} DIO_PORT_Interruptable_Type;
+
+// ***************** Timer_A ****************
+typedef struct {
+  __IO uint16_t CTL;
+  __IO uint16_t CCTL[7];
+  __IO uint16_t R;
+  __IO uint16_t CCR[7];
+  __IO uint16_t EX0;
+  __I  uint16_t IV;
+} Timer_A_Type;
+
+// ***************** eUSCI_A (UART and SPI) ****************
+typedef struct {
+  __IO uint16_t CTLW0;
+  __IO uint16_t CTLW1;
+  __IO uint16_t BRW;
+  __IO uint16_t MCTLW;
+  __IO uint16_t STATW;
+  __I  uint16_t RXBUF;
+  __IO uint16_t TXBUF;
+  __IO uint16_t ABCTL;
+  __IO uint16_t IRTCTL;
+  __IO uint16_t IRRCTL;
+  __IO uint16_t IE;
+  __IO uint16_t IFG;
+  __I  uint16_t IV;
+} EUSCI_A_Type;
+
+// ***************** ADC14 ****************
+typedef struct {
+  __IO uint32_t CTL0;
+  __IO uint32_t CTL1;
+  __IO uint32_t LO0;
+  __IO uint32_t HI0;
+  __IO uint32_t LO1;
+  __IO uint32_t HI1;
+  __IO uint32_t MCTL[32];
+  __IO uint32_t MEM[32];
+  __IO uint32_t IER0;
+  __IO uint32_t IER1;
+  __I  uint32_t IFGR0;
+  __I  uint32_t IFGR1;
+  __O  uint32_t CLRIFGR0;
+  __IO uint32_t CLRIFGR1;
+  __I  uint32_t IV;
+} ADC14_Type;
+
+// ***************** Timer32 ****************
+typedef struct {
+  __IO uint32_t LOAD;
+  __I  uint32_t VALUE;
+  __IO uint32_t CONTROL;
+  __O  uint32_t INTCLR;
+  __I  uint32_t RIS;
+  __I  uint32_t MIS;
+  __IO uint32_t BGLOAD;
+} Timer32_Type;
+
+// ***************** DMA ****************
+typedef struct {
+  __I  uint32_t STAT;
+  __O  uint32_t CFG;
+  __IO uintptr_t CTLBASE;   // pointer wide here, so the table can be anywhere on the host
+  __I  uint32_t ALTBASE;
+  __I  uint32_t WAITSTAT;
+  __O  uint32_t SWREQ;
+  __IO uint32_t USEBURSTSET;
+  __O  uint32_t USEBURSTCLR;
+  __IO uint32_t REQMASKSET;
+  __O  uint32_t REQMASKCLR;
+  __IO uint32_t ENASET;
+  __O  uint32_t ENACLR;
+  __IO uint32_t ALTSET;
+  __O  uint32_t ALTCLR;
+  __IO uint32_t PRIOSET;
+  __O  uint32_t PRIOCLR;
+  __IO uint32_t ERRCLR;
+} DMA_Control_Type;
+
+typedef struct {
+  __I  uint32_t DEVICE_CFG;
+  __IO uint32_t SW_CHTRIG;
+  __IO uint32_t CH_SRCCFG[32];
+  __IO uint32_t INT1_SRCCFG;
+  __IO uint32_t INT2_SRCCFG;
+  __IO uint32_t INT3_SRCCFG;
+  __I  uint32_t INT0_SRCFLG;
+  __O  uint32_t INT0_CLRFLG;
+} DMA_Channel_Type;
+
+// ***************** Cortex-M4 core peripherals ****************
+typedef struct {
+  __IO uint32_t CTRL;
+  __IO uint32_t LOAD;
+  __IO uint32_t VAL;
+  __I  uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+  __IO uint32_t ISER[8];
+  __IO uint32_t ICER[8];
+  __IO uint32_t ISPR[8];
+  __IO uint32_t ICPR[8];
+  __IO uint32_t IABR[8];
+  __IO uint32_t IP[60];     // four 8-bit priorities per word, as used by the drivers
+} NVIC_Type;
+
+typedef struct {
+  __I  uint32_t CPUID;
+  __IO uint32_t ICSR;
+  __IO uint32_t VTOR;
+  __IO uint32_t AIRCR;
+  __IO uint32_t SCR;
+  __IO uint32_t CCR;
+  __IO uint8_t  SHP[12];
+  __IO uint32_t SHCSR;
+  __IO uint32_t CPACR;
+} SCB_Type;
+
+// ***************** clock, power and flash control ****************
+typedef struct {
+  __IO uint32_t CTL0;
+  __IO uint32_t CTL1;
+  __IO uint32_t IE;
+  __I  uint32_t IFG;
+  __O  uint32_t CLRIFG;
+} PCM_Type;
+
+typedef struct {
+  __IO uint32_t KEY;
+  __IO uint32_t CTL0;
+  __IO uint32_t CTL1;
+  __IO uint32_t CTL2;
+  __IO uint32_t CTL3;
+  __IO uint32_t CLKEN;
+  __I  uint32_t STAT;
+  __IO uint32_t IE;
+  __I  uint32_t IFG;
+  __O  uint32_t CLRIFG;
+  __O  uint32_t SETIFG;
+} CS_Type;
+
+typedef struct {
+  __I  uint32_t POWER_STAT;
+  __IO uint32_t BANK0_RDCTL;
+  __IO uint32_t BANK1_RDCTL;
+} FLCTL_Type;
+
+typedef struct {
+  __IO uint16_t CTL;
+} WDT_A_Type;
+
+#include "Sim.h"
+
+// ***************** peripheral instances ****************
+#define P1        ((DIO_PORT_Interruptable_Type *)Sim_Access(&Sim_Port[1]))
+#define P2        ((DIO_PORT_Interruptable_Type *)Sim_Access(&Sim_Port[2]))
+#define P3        ((DIO_PORT_Interruptable_Type *)Sim_Access(&Sim_Port[3]))
+#define P4        ((DIO_PORT_Interruptable_Type *)Sim_Access(&Sim_Port[4]))
+#define P5        ((DIO_PORT_Interruptable_Type *)Sim_Access(&Sim_Port[5]))
+#define P6        ((DIO_PORT_Interruptable_Type *)Sim_Access(&Sim_Port[6]))
+#define P7        ((DIO_PORT_Interruptable_Type *)Sim_Access(&Sim_Port[7]))
+#define P8        ((DIO_PORT_Interruptable_Type *)Sim_Access(&Sim_Port[8]))
+#define P9        ((DIO_PORT_Interruptable_Type *)Sim_Access(&Sim_Port[9]))
+#define P10       ((DIO_PORT_Interruptable_Type *)Sim_Access(&Sim_Port[10]))
+#define PJ        ((DIO_PORT_Interruptable_Type *)Sim_Access(&Sim_Port[SIM_PJ]))
+#define TIMER_A0  ((Timer_A_Type *)Sim_Access(&Sim_TimerA[0]))
+#define TIMER_A1  ((Timer_A_Type *)Sim_Access(&Sim_TimerA[1]))
+#define TIMER_A2  ((Timer_A_Type *)Sim_Access(&Sim_TimerA[2]))
+#define TIMER_A3  ((Timer_A_Type *)Sim_Access(&Sim_TimerA[3]))
+#define EUSCI_A0  ((EUSCI_A_Type *)Sim_Access(&Sim_EUSCIA[0]))
+#define EUSCI_A1  ((EUSCI_A_Type *)Sim_Access(&Sim_EUSCIA[1]))
+#define EUSCI_A2  ((EUSCI_A_Type *)Sim_Access(&Sim_EUSCIA[2]))
+#define EUSCI_A3  ((EUSCI_A_Type *)Sim_Access(&Sim_EUSCIA[3]))
+#define ADC14     ((ADC14_Type *)Sim_Access(&Sim_ADC14))
+#define TIMER32_1 ((Timer32_Type *)Sim_Access(&Sim_Timer32[0]))
+#define TIMER32_2 ((Timer32_Type *)Sim_Access(&Sim_Timer32[1]))
+#define DMA_Control ((DMA_Control_Type *)Sim_Access(&Sim_DMAControl))
+#define DMA_Channel ((DMA_Channel_Type *)Sim_Access(&Sim_DMAChannel))
+#define SysTick   ((SysTick_Type *)Sim_Access(&Sim_SysTick))
+#define SYSTICK   SysTick
+#define NVIC      ((NVIC_Type *)Sim_Access(&Sim_NVIC))
+#define SCB       ((SCB_Type *)Sim_Access(&Sim_SCB))
+#define PCM       ((PCM_Type *)Sim_Access(&Sim_PCM))
+#define CS        ((CS_Type *)Sim_Access(&Sim_CS))
+#define FLCTL     ((FLCTL_Type *)Sim_Access(&Sim_FLCTL))
+#define WDT_A     ((WDT_A_Type *)Sim_Access(&Sim_WDT_A))
+
+// legacy register names still used by some drivers
+#define UCA0CTLW0 (EUSCI_A0->CTLW0)
+
+#define FLCTL_BANK0_RDCTL_WAIT_2 0x00002000
+#define FLCTL_BANK1_RDCTL_WAIT_2 0x00002000
+
+#endif // __MSP_H__
@@ -0,0 +1,8 @@
+// msp432.h
+// Runs on a Linux host
+// Device selector for host builds; the simulated MSP432P401R
+// register file is the only device.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+#include "msp.h"
@@ -84,11 +84,107 @@ uint32_t fcserr;      // debugging counts of errors
 uint32_t TimeOutErr;  // debugging counts of no response errors
 uint32_t NoSOFErr;    // debugging counts of no SOF errors
 
-#define APTIMEOUT 40000   // 10 ms
+#define APTIMEOUT (40*3000)   // 40 ms of TIMER32_2 at 3 MHz
+#define APBOOTTIMEOUT (10*APTIMEOUT) // power up, before resetting again
+#define APFRAMESIZE 64    // longest message, SOF through FCS
+#define APQUEUESIZE 8     // messages waiting to be sent (must be power of 2)
+#define APEXPECT 0x01     // message has a response
+#define APREADY  0x02     // message is complete
+
+// Messages are built in place in Queue by AP_FrameBegin, and UART1
+// sends them from there.  A slot is reserved (QueueResI) when its
+// message is begun and published (QueuePutI) when it and every
+// slot before it is complete, so builders may be interleaved.
+// A slot is free again only when UART1 has sent its last byte.
+struct apframe{
+  uint8_t data[APFRAMESIZE];   // SOF through FCS
+  uint32_t size;               // bytes in data, 0 for a dropped message
+  uint8_t flags;
+  void (*response)(int result, uint8_t *frame);
+};
+static struct apframe Queue[APQUEUESIZE];
+static uint32_t QueueResI;            // reserved by main
+static volatile uint32_t QueuePutI;   // put by main
+static volatile uint32_t QueueGetI;   // get in the UART1 interrupt
+static uint32_t Sending;              // 1 if UART1 is sending Queue[QueueGetI]
+
+enum APStates{
+  APIDLE,          // MRDY=1, SRDY=1
+  APSENDWAIT,      // MRDY=0, waiting for SRDY=0
+  APSENDING,       // message going out on UART1
+  APSENDDONE,      // MRDY=1, waiting for SRDY=1
+  APRECEIVING,     // SRDY=0, MRDY=0, message coming in
+  APRECVDONE       // MRDY=1, waiting for SRDY=1
+};
+static volatile enum APStates State;
+enum BootStates{
+  BOOTWAIT,        // reset, waiting for SNP power up
+  BOOTRESET,       // HCI reset is the next message
+  BOOTWAIT2,       // HCI reset sent, waiting for SNP power up
+  BOOTED           // ready for messages
+};
+static volatile enum BootStates Boot;
+static volatile uint32_t WaitStart; // time of the last progress in the handshake
+static uint32_t BootStart;         // time of the reset
+static volatile int Pending;       // request sent, waiting for the response
+static uint8_t PendingCmd1;        // CMD1 of the request
+static void (*PendingTask)(int result, uint8_t *frame);
+static uint32_t PendingStart;      // time the request went out
+
+// TIMER32_2 runs free at 3 MHz, shared with the Log timestamps
+static uint32_t now(void){
+  return ~TIMER32_2->VALUE;        // counts down
+}
+
+enum RxStates{RXSOF, RXHEADER, RXPAYLOAD, RXFCS};
+static enum RxStates RxState;
+static uint32_t RxCount;           // bytes so far, including SOF
+static uint32_t RxSize;            // bytes before FCS
+static uint32_t RxJunk;            // bytes before SOF
+static uint8_t RxFcs;
+void (*EventTask)(uint8_t *frame); // user function
+static uint16_t ConnectionInterval; // 1.25 ms units, 0 if not connected
+
+typedef struct characteristics{
+  uint16_t theHandle;          // each object has an ID
+  uint16_t size;               // number of bytes in user data (1,2,4,8)
+  uint8_t *pt;                 // pointer to user data, stored little endian
+  void (*callBackRead)(void);  // action if SNP Characteristic Read Indication
+  void (*callBackWrite)(void); // action if SNP Characteristic Write Indication
+  uint8_t readFcs;             // FCS of readFrame without the data
+  uint8_t readFrame[13+8+1];   // SNP Characteristic Read Confirmation, data and FCS filled in
+}characteristic_t;
+#define MAXCHARACTERISTICS 32
+uint32_t CharacteristicCount=0;
+characteristic_t CharacteristicList[MAXCHARACTERISTICS];
+typedef struct NotifyCharacteristics{
+  uint16_t uuid;               // user defined 
+  uint16_t theHandle;          // each object has an ID (used to notify)
+  uint16_t CCCDhandle;         // generated/assigned by SNP
+  uint16_t CCCDvalue;          // sent by phone to this object
+  uint16_t size;               // number of bytes in user data (1,2,4,8)
+  uint8_t *pt;                 // pointer to user data array, stored little endian
+  void (*callBackCCCD)(void);  // action if SNP CCCD Updated Indication
+}NotifyCharacteristic_t;
+#define NOTIFYMAXCHARACTERISTICS 16
+uint32_t NotifyCharacteristicCount=0;
+NotifyCharacteristic_t NotifyCharacteristicList[NOTIFYMAXCHARACTERISTICS];
+
+// Indications are dispatched on their attribute handle.  The SNP hands
+// out handles in order from the first service, so HandleMap[handle-HandleBase]
+// finds the characteristic without a search: 0 for none, i+1 for
+// CharacteristicList[i], and HANDLENOTIFY+i for the CCCD of
+// NotifyCharacteristicList[i].  Every characteristic takes 3 handles
+// (declaration, value, description), a notify one also has a CCCD.
+#define APHANDLES (8+3*MAXCHARACTERISTICS+4*NOTIFYMAXCHARACTERISTICS)
+#define HANDLENOTIFY 0x80
+static uint8_t HandleMap[APHANDLES];
+static uint16_t HandleBase;        // handle of the first service, 0 if none yet
+
 /* If you define APDEBUG then all LP-SNP traffic is displayed on UART0.
    If you do not define APDEBUG then no UART0 output is performed, and thus it runs faster.
  */
-#define APDEBUG 1
+//#define APDEBUG 1
 //**debug macros**********
 #ifdef APDEBUG
 #define OutString(STRING) UART0_OutString(STRING)
@@ -202,15 +298,15 @@ const uint8_t NPI_StartAdvertisement[] = {
   0x00,0x01,0x00,0x00,0x00,0xC5, // RFU
   0x02,           // Advertising will restart with connectable advertising when a connection is terminated
   0xBB};          // FCS (calculated by AP_SendMessageResponse)
-uint8_t NPI_ReadConfirmation[] = {   
-  SOF,0x08,0x00,  // length = 8 (7+data length, filled in dynamically)
+const uint8_t NPI_ReadConfirmation[] = {   
+  SOF,0x08,0x00,  // length = 8 (7+data length, set in each readFrame)
   0x55,0x87,      // SNP Characteristic Read Confirmation (0x87)
   0x00,           // Success
   0x00,0x00,      // handle of connection always 0
-  0x00,0x00,      // Handle of the characteristic value attribute being read (filled in dynamically
+  0x00,0x00,      // Handle of the characteristic value attribute being read (set in each readFrame)
   0x00,0x00,      // offset, ignored, assumes small chucks of data
-  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,  // actual data (filled in dynamically)
-  0x00};          // FCS (calculated by AP_SendMessageResponse)
+  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,  // actual data (set in each readFrame)
+  0x00};          // FCS (calculated in each readFrame)
 uint8_t NPI_WriteConfirmation[] = {   
   SOF,0x03,0x00,  // length = 3
   0x55,0x88,      // SNP Characteristic Write Confirmation
@@ -223,16 +319,6 @@ uint8_t NPI_CCCDUpdatedConfirmation[] = {
   0x00,           // Success
   0x00,0x00,      // handle of connection always 0
   0xDD};          // FCS (calculated by AP_SendMessageResponse)
-uint8_t NPI_SendNotificationIndication[] = {   
-  SOF,0x07,0x00,  // length = 7 to 14 depending on data size
-  0x55,0x89,      // SNP Send Notification Indication (0x89))
-  0x00,0x00,      // handle of connection always 0
-  0x00,0x00,      // Handle of the characteristic value attribute to notify / indicate (filled in dynamically
-  0x00,           // RFU
-  0x01,           // Indication Request type
-  0x00,0,0,0,0,0,0,0, // 1 to 8 bytes of data filled in dynamically
-  0xDD};      // FCS (calculated by AP_SendMessageResponse)
-
 uint8_t NPI_AddCharValue[] = {   
   SOF,0x08,0x00,  // length = 8
   0x35,0x82,      // SNP Add Characteristic Value Declaration
@@ -252,58 +338,6 @@ uint8_t NPI_AddCharDescriptor[] = {
   'C','h','a','r','a','c','t','e','r','i','s','t','i','c',' ','0',0, // Initial user description string
   0x0C,0,0,0};    // FCS (calculated by AP_SendMessageResponse)
 
-//------------AP_Init------------
-// Initialize serial link and GPIO to Bluetooth module
-// see GPIO.c file for hardware connections 
-// reset the Bluetooth module and initialize connection
-// Input: none
-// Output: APOK on success, APFAIL on timeout
-int AP_Init(void){int bwaiting;   int count = 0;
-  GPIO_Init(); // MRDY, SRDY, reset
-#ifdef APDEBUG
-  if(UCA0CTLW0 != 0x00C0){
-    UART0_Init(); // if not on, enable
-  }
-  UART0_OutString("\n\rReset CC2650");
-#endif
-  UART1_Init();
-  fcserr = 0;     // number of packets with FCS errors
-  TimeOutErr = 0; // debugging counts of no response error
-  NoSOFErr =0 ;   // debugging counts of no SOF error
-  bwaiting = 1; // waiting for reset
-  while(bwaiting){
-    AP_Reset();
-    count = 0;  // should get SNP power up within 30 ms (duration is arbitrary and 'count' value is uncalibrated)
-    while(count < 600000){
-      if(AP_RecvStatus()){
-        AP_RecvMessage(RecvBuf,RECVSIZE);
-        if((RecvBuf[3]==0x55)&&(RecvBuf[4]==0x01)){
-          count = 600000;
-          bwaiting = 0; // success
-        }
-      }
-      count = count + 1;
-    }
-  } 
-  AP_SendMessageResponse((uint8_t*)HCI_EXT_ResetSystemCmd,RecvBuf,RECVSIZE); 
-  count = 0;  // should get SNP power up within 120 ms (duration is arbitrary and 'count' value is uncalibrated)
-  bwaiting = 1; // waiting for SNP power up
-  while(count < 6000000){
-    if(AP_RecvStatus()){
-      AP_RecvMessage(RecvBuf,RECVSIZE);
-      if((RecvBuf[3]==0x55)&&(RecvBuf[4]==0x01)){
-        count = 6000000;
-        bwaiting = 0; // success
-      }
-    }
-    count = count + 1;
-  } 
-  if(bwaiting){
-    TimeOutErr++;  // no response error
-    return APFAIL;
-  }  
-  return APOK;
-}
 //***********AP_GetSize***************
 // returns the size of an NPI message
 // Inputs:  pointer to NPI message
@@ -321,23 +355,21 @@ uint32_t AP_GetSize(uint8_t *pt){
 #ifdef APDEBUG
 // *****AP_EchoSendMessage**************
 // For debugging, sends message to UART0
-// Inputs:  pointer to message 
+// Inputs:  pointer to message as queued, FCS included
 // Outputs: none
-void AP_EchoSendMessage(uint8_t *sendMsg){ int i;uint32_t fcs;
+void AP_EchoSendMessage(uint8_t *sendMsg){ uint32_t i;
   uint32_t size=AP_GetSize(sendMsg);
-  fcs = 0;
-  for(i=1;i<size+5;i++)fcs = fcs^sendMsg[i];
   OutString("\n\rLP->SNP ");
   for(i=0; i<=(4+size); i++){ 
     OutUHex2(sendMsg[i]); OutChar(',');
   }
-  OutUHex2(fcs); //  FCS, calculated and not in messsage
+  OutUHex2(sendMsg[i]); //  FCS
 }
 // *****AP_EchoReceived**************
 // for debugging, sends RecvBuf from SNP to UART0
 // Inputs:  result APOK or APFAIL
 // Outputs: none
-void AP_EchoReceived(int response){ uint32_t size; int i;
+void AP_EchoReceived(int response){ uint32_t size, i;
   if(response==APOK){
     OutString("\n\rSNP->LP ");
     size = AP_GetSize(RecvBuf);
@@ -353,199 +385,649 @@ void AP_EchoReceived(int response){ uint32_t size; int i;
 #define AP_EchoSendMessage(MESSAGE)
 #define AP_EchoReceived(R)
 #endif
+// The NPI link is a state machine.  The SRDY edge interrupt and the
+// UART1 transmit complete interrupt move it through a handshake, and
+// AP_BackgroundProcess feeds it bytes from the UART1 receive FIFO.
+// Outgoing messages wait in a queue until the link is idle.
+//   send:    IDLE -MRDY=0-> SENDWAIT -SRDY=0-> SENDING -last byte, MRDY=1-> SENDDONE -SRDY=1-> IDLE
+//   receive: IDLE -SRDY=0, MRDY=0-> RECEIVING -FCS, MRDY=1-> RECVDONE -SRDY=1-> IDLE
+// A request waits for the response with the same CMD1 before the next
+// request is sent; messages that need no response are not held back.
+static void kick(void){
+  struct apframe *f;
+  if(State != APIDLE) return;
+  while((QueuePutI != QueueGetI) && (Queue[QueueGetI&(APQUEUESIZE-1)].size == 0)){
+    QueueGetI = QueueGetI + 1;   // dropped by AP_FrameSend
+  }
+  f = &Queue[QueueGetI&(APQUEUESIZE-1)];
+  if(ReadSRDY() == 0) return;
+  if(Boot != BOOTRESET){
+    if((Boot != BOOTED) || (QueuePutI == QueueGetI)) return;
+    if(Pending && (f->flags&APEXPECT)) return;
+  }
+  State = APSENDWAIT;
+  WaitStart = now();
+  ClearMRDY();      //   MRDY=0
+}
+
+// runs in the UART1 interrupt when the last byte of the message is out
+static void sendDone(void){
+  if(Sending){
+    Sending = 0;
+    QueueGetI = QueueGetI + 1;   // the slot may be reused
+  }
+  State = APSENDDONE;
+  WaitStart = now();
+  SetMRDY();        //   MRDY=1
+}
+
+// SNP is ready to receive, queue the message on UART1
+static void send(void){
+  struct apframe *f = &Queue[QueueGetI&(APQUEUESIZE-1)];
+  State = APSENDING;
+  UART1_SetTxDone(&sendDone);
+  if(Boot == BOOTRESET){
+    Boot = BOOTWAIT2;   // it will power up again
+    UART1_OutBlock(HCI_EXT_ResetSystemCmd, sizeof(HCI_EXT_ResetSystemCmd));
+    return;
+  }
+  if(f->flags&APEXPECT){
+    // SNP Start Advertisement (0x42) answers with an SNP Event Indication (0x05)
+    PendingCmd1 = (f->data[4] == 0x42)? 0x05 : f->data[4];
+    PendingTask = f->response;
+    PendingStart = now();
+    Pending = 1;
+  }
+  Sending = 1;
+  UART1_OutBlock(f->data, f->size);  // straight from the queue
+}
+
+// runs in the port interrupt after each SRDY edge
+static void srdyEdge(void){
+  WaitStart = now();
+  if(ReadSRDY() == 0){
+    if(State == APSENDWAIT){
+      send();
+    }else if(State == APIDLE){
+      State = APRECEIVING;   // SNP has a message
+      ClearMRDY();      //   MRDY=0
+    }
+  }else{
+    if((State == APSENDDONE) || (State == APRECVDONE)){
+      State = APIDLE;
+    }
+    kick();
+  }
+}
+
+static uint8_t *Queued;   // last message published, for AP_EchoSendMessage
+
+// reserve the next slot of the queue
+// Output: the slot, 0 if the queue is full
+static struct apframe *reserve(void){
+  struct apframe *f;
+  if((QueueResI - QueueGetI) >= APQUEUESIZE) return 0;
+  f = &Queue[QueueResI&(APQUEUESIZE-1)];
+  f->flags = 0;
+  QueueResI = QueueResI + 1;
+  return f;
+}
+
+// mark a reserved slot complete, publish the complete
+// slots at the front, and start sending
+static void commit(struct apframe *f, uint8_t flags, void(*response)(int result, uint8_t *frame)){
+  long sr;
+  f->response = response;
+  f->flags = flags|APREADY;
+  while((QueuePutI != QueueResI) && (Queue[QueuePutI&(APQUEUESIZE-1)].flags&APREADY)){
+    QueuePutI = QueuePutI + 1;
+  }
+  Queued = f->data;
+  sr = StartCritical();
+  kick();
+  EndCritical(sr);
+}
+
+// finish a message begun by AP_FrameBegin: fill in the
+// length, fold it into the FCS, and append the FCS
+static int finish(apbuilder_t *b, uint8_t flags, void(*response)(int result, uint8_t *frame)){
+  struct apframe *f = &Queue[b->index&(APQUEUESIZE-1)];
+  uint32_t length;
+  if(b->size >= APFRAMESIZE){
+    f->size = 0;            // too long, dropped
+    commit(f, 0, 0);
+    return APFAIL;
+  }
+  length = b->size-5;       // payload
+  f->data[1] = length&0xFF;
+  f->data[2] = length>>8;
+  f->data[b->size] = b->fcs^f->data[1]^f->data[2];
+  f->size = b->size+1;
+  commit(f, flags, response);
+  return APOK;
+}
+
+//------------AP_FrameBegin------------
+// start a message in the next free slot of the transmit queue
+// Input: b is the builder to use for this message
+//        cmd0 and cmd1 are the NPI command
+// Output: APOK, or APFAIL if the queue is full
+int AP_FrameBegin(apbuilder_t *b, uint8_t cmd0, uint8_t cmd1){
+  struct apframe *f = reserve();
+  if(f == 0) return APFAIL;
+  b->index = QueueResI - 1;
+  b->frame = f->data;
+  b->frame[0] = SOF;        // length is filled in at the end
+  b->frame[3] = cmd0;
+  b->frame[4] = cmd1;
+  b->size = 5;
+  b->fcs = cmd0^cmd1;
+  return APOK;
+}
+
+//------------AP_FrameByte------------
+// append one payload byte, updating the FCS
+// Input: b is the builder of the message
+//        data is the byte
+// Output: none
+void AP_FrameByte(apbuilder_t *b, uint8_t data){
+  if(b->size < APFRAMESIZE-1){
+    b->frame[b->size] = data;
+    b->size = b->size+1;
+    b->fcs = b->fcs^data;
+  }else{
+    b->size = APFRAMESIZE;  // too long, AP_FrameSend fails
+  }
+}
+
+//------------AP_FrameHalf------------
+// append a 16-bit payload field, little endian as in NPI
+// Input: b is the builder of the message
+//        data is the field
+// Output: none
+void AP_FrameHalf(apbuilder_t *b, uint16_t data){
+  AP_FrameByte(b, data&0xFF);
+  AP_FrameByte(b, data>>8);
+}
+
+//------------AP_FrameBytes------------
+// append payload bytes, updating the FCS
+// Input: b is the builder of the message
+//        pt and n are the bytes
+// Output: none
+void AP_FrameBytes(apbuilder_t *b, const uint8_t *pt, uint32_t n){
+  uint32_t i;
+  for(i=0; i<n; i++){
+    AP_FrameByte(b, pt[i]);
+  }
+}
+
+//------------AP_FrameSend------------
+// finish a message that has no response and let it go
+// Input: b is the builder of the message
+// Output: APOK, or APFAIL if the message was too long (it is dropped)
+int AP_FrameSend(apbuilder_t *b){
+  return finish(b, 0, 0);
+}
+
+//------------AP_FrameRequest------------
+// finish a request and let it go, see AP_SendRequest
+// Input: b is the builder of the message
+//        response is a pointer to a user function (0 for none),
+//        called with APOK and the response, or APFAIL and 0
+// Output: APOK, or APFAIL if the message was too long (it is dropped)
+int AP_FrameRequest(apbuilder_t *b, void(*response)(int result, uint8_t *frame)){
+  return finish(b, APEXPECT, response);
+}
+
+// copy a message into the queue with its FCS
+static int queue(const uint8_t *pt, uint8_t flags, void(*response)(int result, uint8_t *frame)){
+  apbuilder_t b;
+  uint32_t size = AP_GetSize((uint8_t *)pt); // payload
+  if(size+6 > APFRAMESIZE) return APFAIL;
+  if(AP_FrameBegin(&b, pt[3], pt[4]) == APFAIL) return APFAIL;
+  AP_FrameBytes(&b, &pt[5], size);
+  return finish(&b, flags, response);
+}
+
+// copy a prebuilt message, FCS included, into the queue
+static int queueFrame(const uint8_t *pt, uint32_t size){
+  struct apframe *f;
+  uint32_t i;
+  if(size > APFRAMESIZE) return APFAIL;
+  f = reserve();
+  if(f == 0) return APFAIL;
+  for(i=0;i<size;i++){
+    f->data[i] = pt[i];
+  }
+  f->size = size;
+  commit(f, 0, 0);
+  return APOK;
+}
+
 //------------AP_SendMessage------------
-// sends a message to the Bluetooth module
+// queue a message to the Bluetooth module and return
 // calculates/sends FCS at end 
 // FCS is the 8-bit EOR of all bytes except SOF and FCS itself
-// 1) Send NPI package (it will calculate fcs)
-// 2) Wait for entire message to be sent
+// The message is copied, so the caller may reuse it at once.
 // Input: pointer to NPI encoded array
-// Output: APOK on success, APFAIL on timeout
+// Output: APOK if queued, APFAIL if queue full or message too long
 int AP_SendMessage(uint8_t *pt){
-  uint8_t fcs; uint32_t waitCount; uint8_t data; uint32_t size;
-// 1) Make MRDY=0
-  ClearMRDY();
-// 2) wait for SRDY to be low
-  waitCount = 0;
-  while(ReadSRDY()){
-    waitCount++;
-    if(waitCount>APTIMEOUT){
-      TimeOutErr++;  // no response error
-      return APFAIL; // timeout??
-    } 
-  }
-// 3) Send NPI package
-  size = AP_GetSize(pt);
-  fcs=0;
-  UART1_OutChar(SOF); pt++;
-  data=*pt; UART1_OutChar(data); fcs=fcs^data; pt++;   // LSB length
-  data=*pt; UART1_OutChar(data); fcs=fcs^data; pt++;   // MSB length
-  data=*pt; UART1_OutChar(data); fcs=fcs^data; pt++;   // CMD0
-  data=*pt; UART1_OutChar(data); fcs=fcs^data; pt++;   // CMD1
-  for(int i=0;i<size;i++){
-    data=*pt; UART1_OutChar(data); fcs=fcs^data; pt++; // payload
-  }
-  UART1_OutChar(fcs);                                  // FCS
-  
-// 4) Wait for entire message to be sent
-  UART1_FinishOutput();
-// 5) Make MRDY=1
-  SetMRDY();        //   MRDY=1  
-// 6) wait for SRDY to be high
-  waitCount = 0;
-  while(ReadSRDY()==0){
-    waitCount++;
-    if(waitCount>APTIMEOUT){
+  return queue(pt, 0, 0);
+}
+
+//------------AP_SendRequest------------
+// queue a message to the Bluetooth module and return;
+// AP_BackgroundProcess runs the response function when
+// the SNP answers (response with the same CMD1), or on timeout
+// Input: pt pointer to NPI encoded array
+//        response is a pointer to a user function (0 for none),
+//        called with APOK and the response, or APFAIL and 0
+// Output: APOK if queued, APFAIL if queue full or message too long
+int AP_SendRequest(uint8_t *pt, void(*response)(int result, uint8_t *frame)){
+  return queue(pt, APEXPECT, response);
+}
+
+//------------AP_SendStatus------------
+// check to see if messages are still waiting or in progress
+// Inputs: none
+// Outputs: 0 if every queued message has been sent and the
+//          handshake is over, nonzero while in progress
+uint32_t AP_SendStatus(void){
+  return (QueuePutI != QueueGetI) || (State == APSENDWAIT) ||
+         (State == APSENDING) || (State == APSENDDONE);
+}
+
+//------------AP_Ready------------
+// check to see if the Bluetooth module has powered up
+// Inputs: none
+// Outputs: 0 while resetting, nonzero once ready for messages
+uint32_t AP_Ready(void){
+  return (Boot == BOOTED);
+}
+
+//------------AP_SetEventTask------------
+// set the function run for messages from the Bluetooth module
+// that are not responses or characteristic indications,
+// such as connection events
+// Input: task is a pointer to a user function (0 for none),
+//        called from AP_BackgroundProcess with the message
+// Output: none
+void AP_SetEventTask(void(*task)(uint8_t *frame)){
+  EventTask = task;
+}
+
+// one byte from the SNP into RecvBuf
+// Output: 0 within a message, 1 at the end of a good
+//         message, -1 at the end of a bad one
+static int receive(uint8_t data){
+  switch(RxState){
+    case RXSOF:
+      if(data != SOF){
+        if(++RxJunk >= 10){   // same limit as the blocking version
+          RxJunk = 0;
+          NoSOFErr++;         // no SOF error
+          return -1;
+        }
+        return 0;
+      }
+      RecvBuf[0] = SOF;
+      RxCount = 1;
+      RxFcs = 0;
+      RxJunk = 0;
+      RxState = RXHEADER;
+      return 0;
+    case RXHEADER:            // length LSB, MSB, CMD0, CMD1
+      RecvBuf[RxCount] = data; RxCount++;
+      RxFcs = RxFcs^data;
+      if(RxCount == 5){
+        RxSize = AP_GetSize(RecvBuf)+5;
+        RxState = (RxSize == 5)? RXFCS : RXPAYLOAD;
+      }
+      return 0;
+    case RXPAYLOAD:
+      if(RxCount < RECVSIZE){
+        RecvBuf[RxCount] = data; // discard data beyond RECVSIZE
+      }
+      RxCount++;
+      RxFcs = RxFcs^data;
+      if(RxCount == RxSize){
+        RxState = RXFCS;
+      }
+      return 0;
+    default:                  // RXFCS
+      if(RxCount < RECVSIZE){
+        RecvBuf[RxCount] = data;
+      }
+      RxState = RXSOF;
+      if(data != RxFcs){
+        fcserr++;
+        return -1;
+      }
+      return 1;
+  }
+}
+
+// give up on the current handshake
+static void abandon(void){ long sr;
+  sr = StartCritical();
+  State = APIDLE;
+  RxState = RXSOF;
+  SetMRDY();        //   MRDY=1
+  EndCritical(sr);
+  TimeOutErr++;     // no response error
+  WaitStart = now();
+}
+
+// a complete message from the SNP
+static void dispatch(void);
+
+// ****AP_BackgroundProcess****
+// run the NPI state machine, never waits
+// handles incoming SNP frames, runs response, event
+// and characteristic functions, and checks timeouts
+// call it often from the main program; the timeouts run on TIMER32_2
+// Inputs:  none
+// Outputs: none
+void AP_BackgroundProcess(void){
+  int r; long sr;
+  void (*task)(int result, uint8_t *frame);
+  while(UART1_InStatus()){
+    r = receive(UART1_InChar());
+    WaitStart = now();
+    if(r){
+      if(State == APRECEIVING){
+        State = APRECVDONE;
+        SetMRDY();    //   MRDY=1
+      }
+      if(r > 0){
+        dispatch();
+      }
+    }
+  }
+  // SENDING always finishes, the other handshake states need the SNP
+  if((State != APIDLE) && (State != APSENDING)){
+    if(now() - WaitStart > APTIMEOUT){
+      abandon();
+    }
+  }
+  if(Pending){
+    if(now() - PendingStart > APTIMEOUT){
+      Pending = 0;
       TimeOutErr++;  // no response error
-      return APFAIL; // timeout??
-    } 
+      task = PendingTask;
+      if(task){
+        (*task)(APFAIL, 0);
+      }
+    }
   }
+  if(Boot != BOOTED){
+    if(now() - BootStart > APBOOTTIMEOUT){
+      TimeOutErr++;  // no power up
+      AP_Reset();
+      sr = StartCritical();
+      Boot = BOOTWAIT;
+      State = APIDLE;
+      RxState = RXSOF;
+      EndCritical(sr);
+      BootStart = now();
+    }
+  }
+  sr = StartCritical();
+  if((State == APIDLE) && (ReadSRDY() == 0)){
+    State = APRECEIVING;   // SRDY edge was missed
+    WaitStart = now();
+    ClearMRDY();      //   MRDY=0
+  }else{
+    kick();
+  }
+  EndCritical(sr);
+}
+
+// entry of HandleMap for a handle, 0 if none
+static uint8_t lookup(uint16_t h){
+  uint16_t offset = h - HandleBase;  // wraps if below the first service
+  if((HandleBase == 0) || (offset >= APHANDLES)) return 0;
+  return HandleMap[offset];
+}
+// record the entry of a handle
+// Output: APOK, or APFAIL if the handle is outside HandleMap
+static int mapHandle(uint16_t h, uint8_t entry){
+  uint16_t offset = h - HandleBase;
+  if((HandleBase == 0) || (offset >= APHANDLES)) return APFAIL;
+  HandleMap[offset] = entry;
   return APOK;
 }
 
+// SNP Characteristic Write Indication (0x88)
+static void writeIndication(void){
+  uint32_t count, j; uint16_t h;
+  uint32_t s; // size of user data 1,2,4,8
+  uint32_t d; // difference between packet size and user data size
+  uint8_t responseNeeded, entry;
+  characteristic_t *c;
+  h = (RecvBuf[8]<<8)+RecvBuf[7]; // handle for this characteristic
+  responseNeeded = RecvBuf[9];
+  entry = lookup(h);
+  if(entry && (entry < HANDLENOTIFY)){
+    c = &CharacteristicList[entry-1];
+    count = RecvBuf[1]-7;   // number of bytes in message
+    s = c->size;
+    if(count>s)count=s;   // truncate to size
+    d = s-count;
+    for(j=0;j<s;j++){     // if message is smaller than size
+      c->pt[j] = 0; // fill MSbytes with 0
+    }
+    for(j=0;j<count;j++){ // write data
+      c->pt[s-j-1-d] = RecvBuf[12+j];
+    }
+    (*c->callBackWrite)(); // process Characteristic Write Indication
+  }
+  if(responseNeeded){
+    queueFrame(NPI_WriteConfirmation, sizeof(NPI_WriteConfirmation));
+    AP_EchoSendMessage(NPI_WriteConfirmation);
+  }
+}
+// SNP Characteristic Read Indication (0x87)
+static void readIndication(void){
+  uint16_t h; uint32_t j;
+  uint32_t s; // size of user data 1,2,4,8
+  uint8_t entry, data, fcs;
+  characteristic_t *c;
+  apbuilder_t b;
+  h = (RecvBuf[8]<<8)+RecvBuf[7]; // handle for this characteristic
+  entry = lookup(h);
+  if((entry == 0) || (entry >= HANDLENOTIFY)){  // not ours, answer with one 0 byte
+    if(AP_FrameBegin(&b, 0x55, 0x87) == APFAIL) return; // SNP Characteristic Read Confirmation
+    AP_FrameByte(&b, 0x00);        // Success
+    AP_FrameHalf(&b, 0);           // handle of connection always 0
+    AP_FrameHalf(&b, h);           // handle of the characteristic value attribute being read
+    AP_FrameHalf(&b, 0);           // offset
+    AP_FrameByte(&b, 0x00);        // data
+    if(AP_FrameSend(&b) == APOK){
+      AP_EchoSendMessage(Queued);
+    }
+    return;
+  }
+  c = &CharacteristicList[entry-1];
+  (*c->callBackRead)(); // process Characteristic Read Indication
+  s = c->size;
+  fcs = c->readFcs;
+  for(j=0;j<s;j++){ // write data, big endian
+    data = c->pt[s-j-1];
+    c->readFrame[j+12] = data;
+    fcs = fcs^data;
+  }
+  c->readFrame[12+s] = fcs;
+  queueFrame(c->readFrame, 13+s);
+  AP_EchoSendMessage(c->readFrame);
+}
+// SNP CCCD Updated Indication (0x8B)
+static void cccdIndication(void){
+  uint16_t h;
+  uint8_t responseNeeded, entry;
+  NotifyCharacteristic_t *n;
+  h = (RecvBuf[8]<<8)+RecvBuf[7]; // handle for this characteristic
+  responseNeeded = RecvBuf[9];
+  entry = lookup(h);
+  if(entry >= HANDLENOTIFY){
+    n = &NotifyCharacteristicList[entry-HANDLENOTIFY];
+    n->CCCDvalue = (RecvBuf[11]<<8)+RecvBuf[10];
+    n->callBackCCCD();
+  }
+  if(responseNeeded){
+    queueFrame(NPI_CCCDUpdatedConfirmation, sizeof(NPI_CCCDUpdatedConfirmation));
+    AP_EchoSendMessage(NPI_CCCDUpdatedConfirmation);
+  }
+}
 
-  
-//------------AP_RecvMessage------------
-// receive a message from the Bluetooth module
-// 1) receive NPI package
-// 2) Wait for entire message to be received
-// Input: pointer to empty buffer into which data is returned
-//        maximum size (discard data beyond this limit)
-// Output: APOK if ok, APFAIL on error (timeout or fcs error)
-int AP_RecvMessage(uint8_t *pt, uint32_t max){
-  uint8_t fcs; uint32_t waitCount; uint8_t data,cmd0,cmd1; 
-  uint8_t msb,lsb;
-  uint32_t size,count,SOFcount=10;
-// 1) wait for SRDY to be low
-  waitCount = 0;
-  while(ReadSRDY()){
-    waitCount++;
-    if(waitCount>APTIMEOUT){
-      TimeOutErr++;  // no response error
-      return APFAIL; // timeout??
-    }      
-  }
-// 2) Make MRDY=0
-  ClearMRDY();
-// 3) receive NPI package
-  // wait for SOF
-  do{
-    data = UART1_InChar();
-    SOFcount--;
-    if(SOFcount==0){
-      SetMRDY();     //   MRDY=1  
-      NoSOFErr++;    // no SOF error
-      return APFAIL;
+// a complete message from the SNP is in RecvBuf
+static void dispatch(void){
+  void (*task)(int result, uint8_t *frame);
+  if((RecvBuf[3] == 0x55) && (RecvBuf[4] == 0x05)){  // SNP Event Indication
+    switch(RecvBuf[5]+(RecvBuf[6]<<8)){
+      case 0x0001:              // connection established
+      case 0x0004:              // connection parameters updated
+        ConnectionInterval = RecvBuf[9]+(RecvBuf[10]<<8);
+        break;
+      case 0x0002:              // connection terminated
+        ConnectionInterval = 0;
+        break;
     }
-  }while(data != SOF);
-  *pt = data; pt++;
-  fcs = 0;
-// get size, once we get SOF, it is highly likely for the rest to come
-  lsb = UART1_InChar(); *pt = lsb; fcs=fcs^lsb; pt++;
-  msb = UART1_InChar(); *pt = msb; fcs=fcs^msb; pt++;
-// get command
-  cmd0 = UART1_InChar(); *pt = cmd0; fcs=fcs^cmd0; pt++;
-  cmd1 = UART1_InChar(); *pt = cmd1; fcs=fcs^cmd1; pt++;
-  count = 5;
-  size = (msb<<8)+lsb;
-// get payload
-  for(int i=0;i<size;i++){
-    data = UART1_InChar(); 
-    fcs = fcs^data; 
-    count++;
-    if(count <= max){
-      *pt = data; 
-      pt++; // payload
+  }
+  if(Pending && (RecvBuf[4] == PendingCmd1)){
+    Pending = 0;
+    task = PendingTask;
+    if(task){
+      (*task)(APOK, RecvBuf);   // response to the request
     }
+    return;
   }
-// get FCB
-  data = UART1_InChar(); 
-  count++;
-  if(count <= max){
-    *pt = data; 
-  }    
-  if(data != fcs){ 
-    fcserr++;
-    SetMRDY();        //   MRDY=1  
-    return APFAIL;
+  if(RecvBuf[3] == 0x55){
+    switch(RecvBuf[4]){
+      case 0x01:                // SNP Power Up Indication
+        if(Boot == BOOTWAIT){
+          Boot = BOOTRESET;     // send HCI reset next
+          BootStart = now();
+          return;
+        }
+        if(Boot == BOOTWAIT2){
+          Boot = BOOTED;
+          return;
+        }
+        break;                  // unexpected, tell the user
+      case 0x88:
+        OutString("\n\rRecvMessage");
+        AP_EchoReceived(APOK);
+        writeIndication();
+        return;
+      case 0x87:
+        OutString("\n\rRecvMessage");
+        AP_EchoReceived(APOK);
+        readIndication();
+        return;
+      case 0x8B:
+        OutString("\n\rRecvMessage");
+        AP_EchoReceived(APOK);
+        cccdIndication();
+        return;
+    }
+  }
+  if(EventTask){
+    (*EventTask)(RecvBuf);      // execute user task
+  }
+}
+
+//------------AP_Init------------
+// Initialize serial link and GPIO to Bluetooth module
+// see GPIO.c file for hardware connections 
+// reset the Bluetooth module and return; AP_BackgroundProcess
+// finishes the start up (power up, HCI reset, power up)
+// and resets again if the module does not answer
+// Input: none
+// Output: APOK
+int AP_Init(void){
+  GPIO_Init(); // MRDY, SRDY, reset
+#ifdef APDEBUG
+  if(UCA0CTLW0 != 0x00C0){
+    UART0_Init(); // if not on, enable
+  }
+  UART0_OutString("\n\rReset CC2650");
+#endif
+  UART1_Init();
+  fcserr = 0;     // number of packets with FCS errors
+  TimeOutErr = 0; // debugging counts of no response error
+  NoSOFErr =0 ;   // debugging counts of no SOF error
+  CharacteristicCount = 0;
+  NotifyCharacteristicCount = 0;
+  QueueResI = QueuePutI = QueueGetI = 0;
+  Sending = 0;
+  State = APIDLE;
+  RxState = RXSOF;
+  RxJunk = 0;
+  Pending = 0;
+  if((TIMER32_2->CONTROL&0x80) == 0){  // if not on, start it as Log_Init does
+    TIMER32_2->LOAD = 0xFFFFFFFF;    // count the full 32 bits
+    TIMER32_2->CONTROL = 0x00000086; // enable, free-running, /16, 32-bit, wrapping
   }
-// 4) Make MRDY=1
-  SetMRDY();        //   MRDY=1  
-// 5) wait for SRDY to be high
-  waitCount = 0;
-  while(ReadSRDY()==0){
-    waitCount++;
+  WaitStart = BootStart = now();
+  ConnectionInterval = 0;
+  HandleBase = 0;
+  for(int i=0;i<APHANDLES;i++){
+    HandleMap[i] = 0;
   }
+  Boot = BOOTWAIT;  // waiting for reset
+  AP_Reset();
+  GPIO_SRDYArm(&srdyEdge);
   return APOK;
 }
 
-//------------AP_RecvStatus------------
-// check to see if Bluetooth module wishes to send packet
-// Inputs: none
-// Outputs: 0 if no communication needed, 
-//          nonzero for communication ready 
-uint32_t AP_RecvStatus(void){
-  return (ReadSRDY()==0);
+static uint8_t *ResponsePt;   // where AP_SendMessageResponse puts the response
+static uint32_t ResponseMax;
+static int ResponseResult;
+static int Waiting;
+static void copyResponse(int result, uint8_t *frame){
+  uint32_t i, size;
+  ResponseResult = result;
+  if(result == APOK){
+    size = AP_GetSize(frame)+6; // SOF through FCS
+    if(size > RECVSIZE) size = RECVSIZE;
+    if(size > ResponseMax) size = ResponseMax;
+    for(i=0; i<size; i++){
+      ResponsePt[i] = frame[i];
+    }
+  }
+  Waiting = 0;
 }
 
 //------------AP_SendMessageResponse------------
 // send a message to the Bluetooth module
-// and receive a response from the Bluetooth module
-// 1) send outgoing message
-// 2) wait at least 10ms to receive NPI package
-// 3) Wait for entire message to be received
+// and wait for a response from the Bluetooth module,
+// used to set up services before the robot moves
+// 1) queue outgoing message
+// 2) run AP_BackgroundProcess until the response (or timeout)
+// Waits for the module to power up if AP_Init was just called.
+// Do not call it from an AP callback.
 // Input: msgPt points to message to send
 //        responsePt points to empty buffer into which data is returned
 //        maximum size (discard data beyond this limit)
 // Output: APOK if ok, APFAIL on error (timeout or fcs error)
 int AP_SendMessageResponse(uint8_t *msgPt, uint8_t *responsePt,uint32_t max){
-  int result;
-//  uint32_t timeout;
-  result = AP_SendMessage(msgPt);
-  if(result == APFAIL){
+  ResponsePt = responsePt;
+  ResponseMax = max;
+  Waiting = 1;
+  if(AP_SendRequest(msgPt, &copyResponse) == APFAIL){
     return APFAIL;
   }
-//  timeout = APTIMEOUT;
-//  while(AP_RecvStatus()==0){
-//    timeout--;
-//    if(timeout==0){
-//      return APFAIL; // 10 ms
-//    }
-//  }
-  result = AP_RecvMessage(responsePt,max);
-#ifdef APDEBUG
-    AP_EchoSendMessage(msgPt);  // debugging
-    AP_EchoReceived(result);    // debugging
-#endif
-  if(result == APFAIL){
-    return APFAIL;
-  }  
-  return APOK;
+  AP_EchoSendMessage(Queued);  // debugging, while it goes out
+  while(Waiting){
+    AP_BackgroundProcess();
+    Clock_Delay1us(1);
+  }
+  AP_EchoReceived(ResponseResult); // debugging
+  return ResponseResult;
 }
 
-typedef struct characteristics{
-  uint16_t theHandle;          // each object has an ID
-  uint16_t size;               // number of bytes in user data (1,2,4,8)
-  uint8_t *pt;                 // pointer to user data, stored little endian
-  void (*callBackRead)(void);  // action if SNP Characteristic Read Indication
-  void (*callBackWrite)(void); // action if SNP Characteristic Write Indication
-}characteristic_t;
-#define MAXCHARACTERISTICS 10
-uint32_t CharacteristicCount=0;
-characteristic_t CharacteristicList[MAXCHARACTERISTICS];
-typedef struct NotifyCharacteristics{
-  uint16_t uuid;               // user defined 
-  uint16_t theHandle;          // each object has an ID (used to notify)
-  uint16_t CCCDhandle;         // generated/assigned by SNP
-  uint16_t CCCDvalue;          // sent by phone to this object
-  uint16_t size;               // number of bytes in user data (1,2,4,8)
-  uint8_t *pt;                 // pointer to user data array, stored little endian
-  void (*callBackCCCD)(void);  // action if SNP CCCD Updated Indication
-}NotifyCharacteristic_t;
-#define NOTIFYMAXCHARACTERISTICS 4
-uint32_t NotifyCharacteristicCount=0;
-NotifyCharacteristic_t NotifyCharacteristicList[NOTIFYMAXCHARACTERISTICS];
-
 
 //*********AP_GetNotifyCCCD*******
 // Return notification CCCD from the communication interface
@@ -569,6 +1051,9 @@ int AP_AddService(uint16_t uuid){ int r;
   NPI_AddService[6] = uuid&0xFF;
   NPI_AddService[7] = uuid>>8;
   r = AP_SendMessageResponse((uint8_t*)NPI_AddService,RecvBuf,RECVSIZE);  
+  if((r == APOK) && (HandleBase == 0)){
+    HandleBase = (RecvBuf[7]<<8)+RecvBuf[6]; // characteristics follow the first service
+  }
   return r;
 }
 
@@ -595,10 +1080,11 @@ int AP_RegisterService(void){ int r;
 //        (*ReadFunc) called before it responses with data from internal structure
 //        (*WriteFunc) called after it accepts data into internal structure
 // Output APOK if successful,
-//        APFAIL if name is empty, more than 8 characteristics, or if SNP failure
+//        APFAIL if name is empty, more than 32 characteristics, or if SNP failure
 int AP_AddCharacteristic(uint16_t uuid, uint16_t thesize, void *pt, uint8_t permission,
   uint8_t properties, char name[], void(*ReadFunc)(void), void(*WriteFunc)(void)){
   int r; uint16_t handle; int i;
+  characteristic_t *c;
   if(thesize>8) return APFAIL;
   if(CharacteristicCount>=MAXCHARACTERISTICS) return APFAIL; // error
   NPI_AddCharValue[3] = 0x35;   // SNP Add Characteristic Value Declaration
@@ -627,11 +1113,23 @@ int AP_AddCharacteristic(uint16_t uuid, uint16_t thesize, void *pt, uint8_t perm
   NPI_AddCharDescriptor[8] = NPI_AddCharDescriptor[10] = 0; // string length
   r=AP_SendMessageResponse((uint8_t*)NPI_AddCharDescriptor,RecvBuf,RECVSIZE);
   if(r == APFAIL) return APFAIL;
-  CharacteristicList[CharacteristicCount].theHandle = handle;
-  CharacteristicList[CharacteristicCount].size = thesize;
-  CharacteristicList[CharacteristicCount].pt = (uint8_t *) pt;
-  CharacteristicList[CharacteristicCount].callBackRead = ReadFunc;
-  CharacteristicList[CharacteristicCount].callBackWrite = WriteFunc;
+  if(mapHandle(handle, CharacteristicCount+1) == APFAIL) return APFAIL;
+  c = &CharacteristicList[CharacteristicCount];
+  c->theHandle = handle;
+  c->size = thesize;
+  c->pt = (uint8_t *) pt;
+  c->callBackRead = ReadFunc;
+  c->callBackWrite = WriteFunc;
+  for(i=0;i<12;i++){ // read confirmation, all but the data
+    c->readFrame[i] = NPI_ReadConfirmation[i];
+  }
+  c->readFrame[1] = 7+thesize;
+  c->readFrame[8] = handle&0xFF;
+  c->readFrame[9] = handle>>8;
+  c->readFcs = 0;
+  for(i=1;i<12;i++){
+    c->readFcs = c->readFcs^c->readFrame[i];
+  }
   CharacteristicCount++;
   return APOK; // OK
 }  
@@ -645,7 +1143,7 @@ int AP_AddCharacteristic(uint16_t uuid, uint16_t thesize, void *pt, uint8_t perm
 //        name is a null-terminated string, maximum length of name is 20 bytes
 //        (*CCCDfunc) called after it accepts , changing CCCDvalue
 // Output APOK if successful,
-//        APFAIL if name is empty, more than 4 notify characteristics, or if SNP failure
+//        APFAIL if name is empty, more than 16 notify characteristics, or if SNP failure
 int AP_AddNotifyCharacteristic(uint16_t uuid, uint16_t thesize, void *pt,   
   char name[], void(*CCCDfunc)(void)){
   int r; uint16_t handle; int i;
@@ -677,6 +1175,7 @@ int AP_AddNotifyCharacteristic(uint16_t uuid, uint16_t thesize, void *pt,
   NPI_AddCharDescriptor[9] = NPI_AddCharDescriptor[11] = 0; // string length
   r=AP_SendMessageResponse((uint8_t*)NPI_AddCharDescriptor,RecvBuf,RECVSIZE);
   if(r == APFAIL) return APFAIL;
+  if(mapHandle((RecvBuf[8]<<8)+RecvBuf[7], HANDLENOTIFY+NotifyCharacteristicCount) == APFAIL) return APFAIL;
   NotifyCharacteristicList[NotifyCharacteristicCount].uuid = uuid;
   NotifyCharacteristicList[NotifyCharacteristicCount].theHandle = handle;
   NotifyCharacteristicList[NotifyCharacteristicCount].CCCDhandle = (RecvBuf[8]<<8)+RecvBuf[7]; // handle for this CCCD
@@ -690,31 +1189,73 @@ int AP_AddNotifyCharacteristic(uint16_t uuid, uint16_t thesize, void *pt,
   
 //*************AP_SendNotification**************
 // Send a notification (will skip if CCCD is 0) 
+// Queues the message and returns, the data is copied now
 // Input:  index into notify characteristic to send
 // Output: APOK if successful,
-//         APFAIL if notification not configured, or if SNP failure
+//         APFAIL if notification not configured, or if queue full
 int AP_SendNotification(uint32_t i){ uint16_t handle; uint32_t j;uint8_t thedata;
-  int r1; uint32_t s;
+  uint32_t s; apbuilder_t b;
   if(i>= NotifyCharacteristicCount) return APFAIL;   // not valid
-  if(NotifyCharacteristicList[i].CCCDvalue){         // send only if active
-    handle = NotifyCharacteristicList[i].theHandle;
-    if(handle == 0) return APFAIL; // not open   
-    NPI_SendNotificationIndication[1] = 6+NotifyCharacteristicList[i].size;      // 1 to 8 bytes 
-    OutString("\n\rSend data=");
-    s = NotifyCharacteristicList[i].size;
-    for(j=0; j<s; j++){
-      thedata = NotifyCharacteristicList[i].pt[s-j-1]; // fetch data from user little endian to SNP big endian
-      OutUHex(thedata); OutString(", ");      
-      NPI_SendNotificationIndication[11+j] = thedata;    // copy into message, big endian
-    }
-    NPI_SendNotificationIndication[7] = handle&0x0FF; // handle
-    NPI_SendNotificationIndication[8] = handle>>8; 
-    r1=AP_SendMessageResponse(NPI_SendNotificationIndication,RecvBuf,RECVSIZE);
-  }else{
-    r1 = APOK; // no need to notify
+  if(NotifyCharacteristicList[i].CCCDvalue == 0) return APOK; // no need to notify
+  handle = NotifyCharacteristicList[i].theHandle;
+  if(handle == 0) return APFAIL; // not open
+  if(AP_FrameBegin(&b, 0x55, 0x89) == APFAIL) return APFAIL; // SNP Send Notification Indication
+  AP_FrameHalf(&b, 0);           // handle of connection always 0
+  AP_FrameHalf(&b, handle);
+  AP_FrameByte(&b, 0);           // RFU
+  AP_FrameByte(&b, 0x01);        // Indication Request type
+  OutString("\n\rSend data=");
+  s = NotifyCharacteristicList[i].size;
+  for(j=0; j<s; j++){
+    thedata = NotifyCharacteristicList[i].pt[s-j-1]; // fetch data from user little endian to SNP big endian
+    OutUHex(thedata); OutString(", ");
+    AP_FrameByte(&b, thedata);   // into the queue, big endian
   }
-  return r1; // OK or fail depending on SendNotificationIndication
+  return AP_FrameRequest(&b, 0); // do not wait
+}
+//*************AP_SendNotificationData**************
+// Send a notification of up to 20 bytes, sent as they are
+// in the array (will skip if CCCD is 0)
+// Queues the message and returns, the data is copied now
+// Input:  i index into notify characteristic to send
+//         data and length, 1 to APNOTIFYMAX bytes
+//         response is a pointer to a user function (0 for none),
+//         called with the SNP response or APFAIL and 0
+// Output: APOK if successful,
+//         APFAIL if notification not configured, too long, or if queue full
+int AP_SendNotificationData(uint32_t i, const uint8_t *data, uint32_t length,
+  void(*response)(int result, uint8_t *frame)){
+  uint16_t handle; apbuilder_t b;
+  if((i >= NotifyCharacteristicCount) || (length == 0) || (length > APNOTIFYMAX)) return APFAIL;
+  if(NotifyCharacteristicList[i].CCCDvalue == 0) return APOK;  // no need to notify
+  handle = NotifyCharacteristicList[i].theHandle;
+  if(handle == 0) return APFAIL; // not open
+  if(AP_FrameBegin(&b, 0x55, 0x89) == APFAIL) return APFAIL; // SNP Send Notification Indication
+  AP_FrameHalf(&b, 0);           // handle of connection always 0
+  AP_FrameHalf(&b, handle);
+  AP_FrameByte(&b, 0);           // RFU
+  AP_FrameByte(&b, 0x01);        // Indication Request type
+  AP_FrameBytes(&b, data, length);
+  return AP_FrameRequest(&b, response);  // do not wait
 }
+
+//*************AP_GetNotifyCount**************
+// Return the number of notify characteristics added so far,
+// which is the index the next one will get
+// Input:  none
+// Output: count
+uint32_t AP_GetNotifyCount(void){
+  return NotifyCharacteristicCount;
+}
+
+//*************AP_GetConnectionInterval**************
+// Return the connection interval reported by the SNP
+// Input:  none
+// Output: interval in 1.25 ms units, 0 if not connected
+uint16_t AP_GetConnectionInterval(void){
+  return ConnectionInterval;
+}
+
 //*************AP_StartAdvertisement**************
 // Start advertisement
 // Input:  none
@@ -765,83 +1306,3 @@ uint32_t AP_GetVersion(void){volatile int r;
   r = AP_SendMessageResponse((uint8_t*)NPI_GetVersion,RecvBuf,RECVSIZE); 
   return (RecvBuf[5]<<8)+(RecvBuf[6]);
 }
-// ****AP_BackgroundProcess****
-// handle incoming SNP frames
-// Inputs:  none
-// Outputs: none
-void AP_BackgroundProcess(void){
-  int count; uint16_t h; int i,j;
-  uint32_t s; // size of user data 1,2,4,8
-  uint32_t d; // difference between packet size and user data size
-  uint8_t responseNeeded;
-
-  if(AP_RecvStatus()){
-    if(AP_RecvMessage(RecvBuf,RECVSIZE)==APOK){
-      OutString("\n\rRecvMessage");
-      AP_EchoReceived(APOK);        
-      if((RecvBuf[3]==0x55)&&(RecvBuf[4]==0x88)){// SNP Characteristic Write Indication (0x88)
-        h = (RecvBuf[8]<<8)+RecvBuf[7]; // handle for this characteristic
-        responseNeeded = RecvBuf[9];
-        i = 0;
-        while(i<MAXCHARACTERISTICS){
-          if(CharacteristicList[i].theHandle == h){
-            count = RecvBuf[1]-7;   // number of bytes in message
-            s = CharacteristicList[i].size;
-            if(count>s)count=s;   // truncate to size
-            d = s-count;
-            for(j=0;j<s;j++){     // if message is smaller than size
-              CharacteristicList[i].pt[j] = 0; // fill MSbytes with 0
-            }
-            for(j=0;j<count;j++){ // write data
-              CharacteristicList[i].pt[s-j-1-d] = RecvBuf[12+j];
-            }
-            (*CharacteristicList[i].callBackWrite)(); // process Characteristic Write Indication
-            i = MAXCHARACTERISTICS;
-          }else{
-            i++;
-          }
-        }
-        if(responseNeeded){
-          AP_SendMessage(NPI_WriteConfirmation);
-          AP_EchoSendMessage(NPI_WriteConfirmation);
-        }
-      }
-      if((RecvBuf[3]==0x55)&&(RecvBuf[4]==0x87)){// SNP Characteristic Read Indication (0x87)
-        h = (RecvBuf[8]<<8)+RecvBuf[7]; // handle for this characteristic
-        i = 0;
-        while(i<MAXCHARACTERISTICS){
-          if(CharacteristicList[i].theHandle == h){
-            (*CharacteristicList[i].callBackRead)(); // process Characteristic Read Indication
-            NPI_ReadConfirmation[1] = 7+CharacteristicList[i].size;
-            s = CharacteristicList[i].size;
-            for(j=0;j<s;j++){ // write data
-              NPI_ReadConfirmation[j+12]=CharacteristicList[i].pt[s-j-1];
-            }
-            i = MAXCHARACTERISTICS;
-          }else{
-            i++;
-          }
-        }
-        NPI_ReadConfirmation[8] = RecvBuf[7]; // handle
-        NPI_ReadConfirmation[9] = RecvBuf[8]; 
-        AP_SendMessage(NPI_ReadConfirmation);
-        AP_EchoSendMessage(NPI_ReadConfirmation);
-      }
-      if((RecvBuf[3]==0x55)&&(RecvBuf[4]==0x8B)){// SNP CCCD Updated Indication (0x8B)
-        h = (RecvBuf[8]<<8)+RecvBuf[7]; // handle for this characteristic
-        responseNeeded = RecvBuf[9];
-        for(i=0; i<NOTIFYMAXCHARACTERISTICS;i++){
-          if(NotifyCharacteristicList[i].CCCDhandle == h){  // to do
-            NotifyCharacteristicList[i].CCCDvalue = (RecvBuf[11]<<8)+RecvBuf[10];
-            NotifyCharacteristicList[i].callBackCCCD();
-          }
-        }
-        if(responseNeeded){
-          AP_SendMessage(NPI_CCCDUpdatedConfirmation);
-          AP_EchoSendMessage(NPI_CCCDUpdatedConfirmation);
-        }
-      }        
-    }
-  }
-}
-
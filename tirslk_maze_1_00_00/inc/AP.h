@@ -88,17 +88,56 @@ policies, either expressed or implied, of the FreeBSD Project.
  */
 #define APOK   1
 
+/**
+ * longest notification for AP_SendNotificationData, the ATT payload of the default MTU
+ */
+#define APNOTIFYMAX 20
+
+/**
+ * \brief a message being built in place in the transmit queue, see AP_FrameBegin()
+ */
+typedef struct{
+  uint8_t *frame;     /**< SOF of the message in the queue */
+  uint32_t size;      /**< bytes so far, SOF through payload */
+  uint32_t index;     /**< slot in the queue */
+  uint8_t fcs;        /**< EOR of CMD0, CMD1 and the payload so far */
+}apbuilder_t;
+
+/**
+ * debugging count of messages from the Bluetooth module with a bad FCS
+ */
+extern uint32_t fcserr;
+/**
+ * debugging count of handshakes, responses and power ups that timed out
+ */
+extern uint32_t TimeOutErr;
+/**
+ * debugging count of runs of bytes with no start of frame
+ */
+extern uint32_t NoSOFErr;
 
 /**
  * Initialize serial link and GPIO to Bluetooth module.
  * See GPIO.h file for hardware connections .
- * Resets the Bluetooth module and initialize connection.
+ * Resets the Bluetooth module and returns without waiting.
+ * AP_BackgroundProcess() finishes the start up, and resets
+ * the module again if it does not power up.  Starts Timer32
+ * Timer 2 free running at 3 MHz, unless Log_Init() already has,
+ * to time the 40 ms timeouts.
  * @param  none
- * @return APOK on success, APFAIL on timeout
+ * @return APOK
  * @brief  Initialize serial link and GPIO to Bluetooth module
  */
 int AP_Init(void);
 
+/**
+ * Check to see if the Bluetooth module has powered up after AP_Init()
+ * @param  none
+ * @return 0 while starting up, nonzero when ready for messages
+ * @brief Check Bluetooth start up
+ */
+uint32_t AP_Ready(void);
+
 
 /**
  * Resets the Bluetooth module.
@@ -110,61 +149,137 @@ int AP_Init(void);
 void AP_Reset(void);
 
 /**
- * Send a message to the Bluetooth module
- * Automatically calculates/sends FCS at end.<br>
- * 1) Send NPI package (it will calculate fcs)<br>
- * 2) Wait for entire message to be sent
+ * Queue a message to the Bluetooth module and return.
+ * Automatically calculates/sends FCS at end.
+ * The message is copied, so the caller may change it right away.
+ * The SRDY interrupt sends it when the NPI link is free.
  * @note FCS is the 8-bit EOR of all bytes except SOF and FCS itself.
  * @param  pt pointer to NPI encoded array (the message to send)
- * @return APOK on success, APFAIL on timeout
+ * @return APOK if queued, APFAIL if the queue is full or the message too long
  * @brief  sends a message to the Bluetooth module
  */
 int AP_SendMessage(uint8_t *pt);
 
+/**
+ * Queue a request to the Bluetooth module and return.
+ * AP_BackgroundProcess() runs the response function when the
+ * response (the next message with the same CMD1) arrives, or on
+ * timeout.  A request is sent only after the previous one is answered.
+ * @param  pt pointer to NPI encoded array (the message to send)
+ * @param  response pointer to a user function (0 for none), called with APOK and the response, or APFAIL and 0
+ * @return APOK if queued, APFAIL if the queue is full or the message too long
+ * @brief  sends a request to the Bluetooth module
+ */
+int AP_SendRequest(uint8_t *pt, void(*response)(int result, uint8_t *frame));
 
 /**
- * This function is for debugging. It sends RecvBuf from SNP to UART0
- * @note FCS is the 8-bit EOR of all bytes except SOF and FCS itself.
- * @param  response 0 is OK, 1 was error
+ * Start a message directly in the next free slot of the transmit
+ * queue, so nothing is copied and no shared template is changed.
+ * Append the payload with AP_FrameByte(), AP_FrameHalf() and
+ * AP_FrameBytes(), which keep the FCS as they go, then finish with
+ * AP_FrameSend() or AP_FrameRequest().  Messages are sent in the
+ * order they were begun; several may be open at once.
+ * @param  b pointer to the builder for this message
+ * @param  cmd0 first NPI command byte, such as 0x55
+ * @param  cmd1 second NPI command byte, such as 0x89
+ * @return APOK, or APFAIL if the queue is full
+ * @note   Every message begun must be finished, or later ones wait for it
+ * @brief  start building a message to the Bluetooth module
+ */
+int AP_FrameBegin(apbuilder_t *b, uint8_t cmd0, uint8_t cmd1);
+
+/**
+ * Append one payload byte to a message begun by AP_FrameBegin()
+ * @param  b pointer to the builder of the message
+ * @param  data the byte
  * @return none
- * @brief   RecvBuf from SNP to UART0
+ * @brief  append a byte to a message
  */
-void AP_EchoReceived(int response);
+void AP_FrameByte(apbuilder_t *b, uint8_t data);
 
 /**
- * This function is for debugging. It sends a message to UART0
- * @param  sendMsg is SNP message to display out UART
+ * Append a 16-bit payload field, least significant byte first as NPI
+ * sends handles and lengths
+ * @param  b pointer to the builder of the message
+ * @param  data the field
  * @return none
- * @brief Sends message to UART0
+ * @brief  append a 16-bit field to a message
  */
-void AP_EchoSendMessage(uint8_t *sendMsg);
+void AP_FrameHalf(apbuilder_t *b, uint16_t data);
+
+/**
+ * Append payload bytes to a message begun by AP_FrameBegin()
+ * @param  b pointer to the builder of the message
+ * @param  pt pointer to the bytes
+ * @param  n number of bytes
+ * @return none
+ * @brief  append bytes to a message
+ */
+void AP_FrameBytes(apbuilder_t *b, const uint8_t *pt, uint32_t n);
 
+/**
+ * Finish a message that has no response: fill in its length and
+ * FCS, and let the SRDY interrupt send it when the NPI link is free.
+ * @param  b pointer to the builder of the message
+ * @return APOK, or APFAIL if the message was longer than a queue slot (it is dropped)
+ * @brief  send a built message
+ */
+int AP_FrameSend(apbuilder_t *b);
 
 /**
- * Receive a message from the Bluetooth module
- * 1) Receive NPI package<br>
- * 2) Wait for entire message to be received
- * @param  pt pointer to empty buffer into which data is returned
- *         max maximum size (discard data beyond this limit)
- * @return APOK on success, APFAIL on timeout or fcs error
- * @brief Receive a message from the Bluetooth module
+ * Finish a request, as AP_FrameSend(), and run the response function
+ * as AP_SendRequest() does.
+ * @param  b pointer to the builder of the message
+ * @param  response pointer to a user function (0 for none), called with APOK and the response, or APFAIL and 0
+ * @return APOK, or APFAIL if the message was longer than a queue slot (it is dropped)
+ * @brief  send a built request
  */
-int AP_RecvMessage(uint8_t *pt, uint32_t max);
+int AP_FrameRequest(apbuilder_t *b, void(*response)(int result, uint8_t *frame));
 
 /**
- * Check to see if Bluetooth module wishes to send packet
+ * Check to see if queued messages are still waiting or being sent
  * @param  none
- * @return 0 for no communication needed and nonzero for communication ready
- * @brief Check Bluetooth status
+ * @return 0 when all are sent and the Bluetooth module has released SRDY, nonzero while in progress
+ * @brief Check send status
+ */
+uint32_t AP_SendStatus(void);
+
+/**
+ * Set the function run for messages from the Bluetooth module that
+ * are not responses or characteristic indications, such as connection
+ * events.  It runs from AP_BackgroundProcess().
+ * @param  task pointer to a user function (0 for none), called with the message
+ * @return none
+ * @brief Set event function
+ */
+void AP_SetEventTask(void(*task)(uint8_t *frame));
+
+
+/**
+ * This function is for debugging. It sends RecvBuf from SNP to UART0
+ * @note FCS is the 8-bit EOR of all bytes except SOF and FCS itself.
+ * @param  response 0 is OK, 1 was error
+ * @return none
+ * @brief   RecvBuf from SNP to UART0
+ */
+void AP_EchoReceived(int response);
+
+/**
+ * This function is for debugging. It sends a message to UART0
+ * @param  sendMsg is SNP message to display out UART, FCS included
+ * @return none
+ * @brief Sends message to UART0
  */
-uint32_t AP_RecvStatus(void);
+void AP_EchoSendMessage(uint8_t *sendMsg);
 
 //------------AP_SendMessageResponse------------
 // send a message to the Bluetooth module
-// and receive a response from the Bluetooth module
-// 1) send outgoing message
-// 2) wait at least 10ms to receive NPI package
-// 3) Wait for entire message to be received
+// and wait for a response from the Bluetooth module,
+// used to set up services before the robot moves
+// 1) queue outgoing message
+// 2) run AP_BackgroundProcess until the response (or timeout)
+// Waits for the module to power up if AP_Init was just called.
+// Do not call it from an AP callback.
 // Input: msgPt points to message to send
 //        responsePt points to empty buffer into which data is returned
 //        maximum size (discard data beyond this limit)
@@ -222,7 +337,7 @@ int AP_RegisterService(void);
 //        (*ReadFunc) called before it responses with data from internal structure
 //        (*WriteFunc) called after it accepts data into internal structure
 // Output APOK if successful,
-//        APFAIL if name is empty, more than 8 characteristics, or if SNP failure
+//        APFAIL if name is empty, more than 32 characteristics, or if SNP failure
 int AP_AddCharacteristic(uint16_t uuid, uint16_t thesize, void *pt, uint8_t permission,
   uint8_t properties, char name[], void(*ReadFunc)(void), void(*WriteFunc)(void));
 
@@ -235,17 +350,45 @@ int AP_AddCharacteristic(uint16_t uuid, uint16_t thesize, void *pt, uint8_t perm
 //        name is a null-terminated string, maximum length of name is 20 bytes
 //        (*CCCDfunc) called after it accepts , changing CCCDvalue
 // Output APOK if successful,
-//        APFAIL if name is empty, more than 4 notify characteristics, or if SNP failure
+//        APFAIL if name is empty, more than 16 notify characteristics, or if SNP failure
 int AP_AddNotifyCharacteristic(uint16_t uuid, uint16_t thesize,  void *pt, 
   char name[], void(*CCCDfunc)(void));
   
 //*************AP_SendNotification**************
 // Send a notification (will skip if CCCD is 0) 
+// Queues the message and returns, the data is copied now
 // Input:  index into notify characteristic to send
 // Output: APOK if successful,
-//         APFAIL if notification not configured, or if SNP failure
+//         APFAIL if notification not configured, or if queue full
 int AP_SendNotification(uint32_t i);
 
+//*************AP_SendNotificationData**************
+// Send a notification of up to 20 bytes, sent as they are
+// in the array (will skip if CCCD is 0)
+// Queues the message and returns, the data is copied now
+// Input:  i index into notify characteristic to send
+//         data and length, 1 to APNOTIFYMAX bytes
+//         response is a pointer to a user function (0 for none),
+//         called with the SNP response or APFAIL and 0
+// Output: APOK if successful,
+//         APFAIL if notification not configured, too long, or if queue full
+int AP_SendNotificationData(uint32_t i, const uint8_t *data, uint32_t length,
+  void(*response)(int result, uint8_t *frame));
+
+//*************AP_GetNotifyCount**************
+// Return the number of notify characteristics added so far,
+// which is the index the next one will get
+// Input:  none
+// Output: count
+uint32_t AP_GetNotifyCount(void);
+
+//*************AP_GetConnectionInterval**************
+// Return the connection interval reported by the SNP
+// in its connection established and updated events
+// Input:  none
+// Output: interval in 1.25 ms units, 0 if not connected
+uint16_t AP_GetConnectionInterval(void);
+
 //*************AP_StartAdvertisement**************
 // Start advertisement
 // Input:  none
@@ -277,7 +420,11 @@ uint32_t AP_GetStatus(void);
 uint32_t AP_GetVersion(void);
 
 // ****AP_BackgroundProcess****
-// handle incoming SNP frames
+// run the NPI state machine, never waits
+// handles incoming SNP frames, runs response, event
+// and characteristic functions, and checks timeouts
+// call it often from the main program; the timeouts are 40 ms,
+// timed with Timer32 Timer 2
 // Inputs:  none
 // Outputs: none
 void AP_BackgroundProcess(void);
@@ -0,0 +1,73 @@
+// Baud.c
+// Runs on MSP432
+// Error of eUSCI_A baud rate settings, bit by bit.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#include <stdint.h>
+#include "../inc/Baud.h"
+
+// ------------Baud_Error------------
+// Find the worst error in the edges of a 10-bit frame.
+// Input: baud the baud rate the settings are meant for
+//        brw UCAxBRW
+//        mctlw UCAxMCTLW
+// Output: signed error of the worst edge in 0.01% of a bit, negative is early
+int32_t Baud_Error(uint32_t baud, uint16_t brw, uint16_t mctlw){
+  uint64_t clocks = 0;          // BRCLK cycles to the end of bit i
+  int64_t error;
+  int32_t worst = 0;
+  uint32_t i;
+  for(i=0; i<10; i=i+1){
+    if(mctlw&0x0001){           // 16 BITCLK16, UCBRFx of them one longer
+      clocks = clocks + 16*brw + ((mctlw>>4)&0x0F);
+    }else{
+      clocks = clocks + brw;
+    }
+    clocks = clocks + ((mctlw>>(8 + (i&7)))&1);  // UCBRSx, one bit per bit
+    // (actual - ideal)/bit time, where the ideal end is (i+1)*BAUD_CLOCK/baud
+    error = ((int64_t)clocks*baud - (int64_t)(i + 1)*BAUD_CLOCK)*10000/BAUD_CLOCK;
+    if((error > worst) || (error < -worst)){
+      worst = (int32_t)error;
+    }
+  }
+  return worst;
+}
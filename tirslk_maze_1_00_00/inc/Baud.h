@@ -0,0 +1,132 @@
+/**
+ * @file      Baud.h
+ * @brief     eUSCI_A baud rate register settings for any baud rate
+ * @details   The BAUD_ macros give UCAxBRW and UCAxMCTLW for a baud
+ * rate from SMCLK, following the method in the eUSCI chapter of the
+ * MSP432P4xx Technical Reference Manual.  With N = BAUD_CLOCK/baud:<br>
+ 1) N of 16 or more uses 16x oversampling: UCBRx = INT(N/16) and
+    UCBRFx = INT(N) mod 16<br>
+ 2) N under 16 uses low frequency mode: UCBRx = INT(N)<br>
+ 3) UCBRSx comes from the fraction of N, using the manual's table of
+    modulation patterns<br>
+ * When the baud rate is a constant, the macros are evaluated by the
+ * compiler, so UART0_InitBaud(1000000) costs two register writes.
+ * Baud_Error() reports how far the bit edges of a frame sent with
+ * those settings fall from where they belong.
+ * @version   V1.0
+ * @author    Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ *
+<table>
+<caption id="Baud_rates">Settings at SMCLK = 12 MHz</caption>
+<tr><th>Baud    <th>UCBRx <th>UCBRFx <th>UCBRSx <th>UCOS16 <th>worst bit edge error
+<tr><td>115200  <td>6     <td>8      <td>0x20   <td>1      <td>-0.64%
+<tr><td>460800  <td>1     <td>10     <td>0x00   <td>1      <td>-1.6%
+<tr><td>921600  <td>13    <td>-      <td>0x00   <td>0      <td>-1.6%
+<tr><td>1000000 <td>12    <td>-      <td>0x00   <td>0      <td>0%
+</table>
+ ******************************************************************************/
+
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef BAUD_H_
+#define BAUD_H_
+
+/**
+ * \brief BRCLK of every UART in this folder, SMCLK after Clock_Init48MHz()
+ */
+#define BAUD_CLOCK 12000000
+
+/**
+ * \brief integer part of N
+ */
+#define BAUD_N(baud) (BAUD_CLOCK/(baud))
+
+/**
+ * \brief fraction of N in 1/10000
+ */
+#define BAUD_FRACTION(baud) ((uint32_t)((uint64_t)(BAUD_CLOCK%(baud))*10000/(baud)))
+
+/**
+ * \brief 1 if 16x oversampling is used
+ */
+#define BAUD_OS16(baud) (BAUD_N(baud) >= 16)
+
+/**
+ * \brief UCBRSx for a fraction of N in 1/10000
+ */
+#define BAUD_UCBRS(f) ((f)>=9288? 0xFE:(f)>=9170? 0xFD:(f)>=9004? 0xFB:(f)>=8751? 0xF7: \
+  (f)>=8572? 0xEF:(f)>=8464? 0xDF:(f)>=8333? 0xBF:(f)>=8004? 0xEE:(f)>=7861? 0xED: \
+  (f)>=7503? 0xDD:(f)>=7147? 0xBB:(f)>=7001? 0xB7:(f)>=6667? 0xD6:(f)>=6432? 0xB6: \
+  (f)>=6254? 0xB5:(f)>=6003? 0xAD:(f)>=5715? 0x6B:(f)>=5002? 0xAA:(f)>=4378? 0x55: \
+  (f)>=4286? 0x53:(f)>=4003? 0x92:(f)>=3753? 0x52:(f)>=3575? 0x4A:(f)>=3335? 0x49: \
+  (f)>=3000? 0x25:(f)>=2503? 0x44:(f)>=2224? 0x22:(f)>=2147? 0x21:(f)>=1670? 0x11: \
+  (f)>=1430? 0x20:(f)>=1252? 0x10:(f)>=1001? 0x08:(f)>=835? 0x04:(f)>=715? 0x02: \
+  (f)>=529? 0x01: 0x00)
+
+/**
+ * \brief UCAxBRW for a baud rate
+ */
+#define BAUD_BRW(baud) (BAUD_OS16(baud)? BAUD_N(baud)/16 : BAUD_N(baud))
+
+/**
+ * \brief UCAxMCTLW for a baud rate: UCBRSx, UCBRFx and UCOS16
+ */
+#define BAUD_MCTLW(baud) ((BAUD_UCBRS(BAUD_FRACTION(baud))<<8)| \
+  ((BAUD_OS16(baud)? BAUD_N(baud)%16 : 0)<<4)|BAUD_OS16(baud))
+
+/**
+ * Find the worst error in the edges of a 10-bit frame (start, 8 data,
+ * stop) sent with the given register settings, as a fraction of one
+ * bit time.  A receiver samples in the middle of each bit, so the
+ * frame is received if the error of each edge stays well inside 50%.
+ * @param baud the baud rate the settings are meant for
+ * @param brw UCAxBRW
+ * @param mctlw UCAxMCTLW
+ * @return signed error of the worst edge, in units of 0.01% of a bit;
+ * negative means the edges come early
+ * @brief Check baud rate settings
+ */
+int32_t Baud_Error(uint32_t baud, uint16_t brw, uint16_t mctlw);
+
+#endif /* BAUD_H_ */
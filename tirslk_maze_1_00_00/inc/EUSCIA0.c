@@ -47,19 +47,27 @@ policies, either expressed or implied, of the FreeBSD Project.
 // UCA0RXD (VCP receive) connected to P1.2
 // UCA0TXD (VCP transmit) connected to P1.3
 #include <stdint.h>
+#include "../inc/Baud.h"
 #include "../inc/FIFO0.h"
+#include "../inc/Format.h"
 #include "EUSCIA0.h"
 #include "msp.h"
 
+uint32_t (*TxBlockSource)(const uint8_t **pt);  // user function that supplies blocks
+static const uint8_t *TxBlock;   // sent by the interrupt after TxFifo0
+static uint32_t TxBlockSize;     // bytes left in TxBlock
 
-//------------EUSCIA0_Init------------
-// Initialize the UART for 115,200 baud rate (assuming 48 MHz bus clock),
+//------------EUSCIA0_InitRate------------
+// Initialize the UART for any baud rate (assuming 48 MHz bus clock),
 // 8 bit word length, no parity bits, one stop bit
-// Input: none
+// Input: brw   UCA0BRW, see BAUD_BRW() in Baud.h
+//        mctlw UCA0MCTLW, see BAUD_MCTLW() in Baud.h
 // Output: none
-void EUSCIA0_Init(void){
+void EUSCIA0_InitRate(uint16_t brw, uint16_t mctlw){
   RxFifo0_Init();              // initialize FIFOs
   TxFifo0_Init();
+  TxBlockSource = 0;
+  TxBlockSize = 0;
   EUSCI_A0->CTLW0 = 0x0001;         // hold the USCI module in reset mode
   // bit15=0,      no parity bits
   // bit14=x,      not used when parity is disabled
@@ -75,10 +83,8 @@ void EUSCIA0_Init(void){
   // bit1=0,       do not transmit break (not used here)
   // bit0=1,       hold logic in reset state while configuring
   EUSCI_A0->CTLW0 = 0x00C1;
-  // set the baud rate
-  // N = clock/baud rate = 12,000,000/115,200 = 104.1667
-  EUSCI_A0->BRW = 104;          // UCBR = baud rate = int(N) = 104
-  EUSCI_A0->MCTLW &= ~0xFFF1;   // clear first and second modulation stage bit fields
+  EUSCI_A0->BRW = brw;          // UCBRx, the integer part of the divider
+  EUSCI_A0->MCTLW = mctlw;      // UCBRSx, UCBRFx and UCOS16
 
 // since TxFifo is empty, we initially disarm interrupts on UCTXIFG, but arm it on OutChar
   P1->SEL0 |= 0x0C;
@@ -91,6 +97,15 @@ void EUSCIA0_Init(void){
   EUSCI_A0->IE = 0x0001;        // disable interrupts on transmit empty, start, complete
 }
 
+//------------EUSCIA0_Init------------
+// Initialize the UART for 115,200 baud rate (assuming 48 MHz bus clock),
+// 8 bit word length, no parity bits, one stop bit
+// Input: none
+// Output: none
+void EUSCIA0_Init(void){
+  EUSCIA0_InitBaud(115200);
+}
+
 
 //------------EUSCI_A0_InChar------------
 // Wait for new serial port input
@@ -103,13 +118,24 @@ char EUSCIA0_InChar(void){
   return(letter);
 }
 
+//------------EUSCIA0_InStatus------------
+// Returns how much data available for reading
+// Input: none
+// Output: number of bytes in receive FIFO
+uint32_t EUSCIA0_InStatus(void){
+  return RxFifo0_Size();
+}
+
 //------------EUSCIA0_OutChar------------
 // Output 8-bit to serial port
 // Input: letter is an 8-bit ASCII character to be transferred
 // Output: none
 // spin if TxFifo is full
 void EUSCIA0_OutChar(char data){
-  while(TxFifo0_Put(data) == FIFOFAIL){}; // spin if full
+  while(TxFifo0_Room() == 0){
+    EUSCI_A0->IE = 0x0003;   // full, keep the transmit interrupt draining it
+  }
+  TxFifo0_Put(data);         // fits, so it is not counted in TxFifo0Lost
   EUSCI_A0->IE = 0x0003;     // enable interrupts on transmit empty and receive full
 }
 
@@ -119,10 +145,24 @@ void EUSCIA0_OutChar(char data){
 // vector at 0x00000080 in startup_msp432.s
 void EUSCIA0_IRQHandler(void){ char data; 
   if(EUSCI_A0->IFG&0x02){             // TX data register empty
-    if(TxFifo0_Get(&data) == FIFOFAIL){
-      EUSCI_A0->IE = 0x0001;         // disable interrupts on transmit empty
-    }else{
+    if(TxFifo0_Get(&data) == FIFOSUCCESS){
       EUSCI_A0->TXBUF = data;        // send data, acknowledge interrupt
+    }else{
+      if(TxBlockSize == 0){
+        // disarm before asking, so an EUSCIA0_OutBlocks after the answer is kept
+        EUSCI_A0->IE = 0x0001;       // disable interrupts on transmit empty
+        if(TxBlockSource){
+          TxBlockSize = (*TxBlockSource)(&TxBlock);  // also releases the previous block
+          if(TxBlockSize){
+            EUSCI_A0->IE = 0x0003;   // enable interrupts on transmit empty and receive full
+          }
+        }
+      }
+      if(TxBlockSize){
+        EUSCI_A0->TXBUF = *TxBlock;  // send from the block, no copy
+        TxBlock = TxBlock + 1;
+        TxBlockSize = TxBlockSize - 1;
+      }
     }
   }
   if(EUSCI_A0->IFG&0x01){             // RX data register full
@@ -130,14 +170,45 @@ void EUSCIA0_IRQHandler(void){ char data;
   } 
 }
 
+//------------EUSCIA0_SetBlockSource------------
+// Set the function the transmit interrupt calls for more
+// data once TxFifo0 and the previous block are empty
+// Input: source is a pointer to a user function (0 for none), run in the
+//        interrupt; it sets *pt to the next block and returns its size,
+//        or returns 0 if there is nothing to send.  The previous block
+//        is no longer needed once it is called.
+// Output: none
+void EUSCIA0_SetBlockSource(uint32_t(*source)(const uint8_t **pt)){
+  TxBlockSource = source;
+}
+
+//------------EUSCIA0_OutBlocks------------
+// Start sending blocks from the block source and return
+// Input: none
+// Output: none
+// does not wait, safe to call from any interrupt
+void EUSCIA0_OutBlocks(void){
+  EUSCI_A0->IE = 0x0003;     // enable interrupts on transmit empty and receive full
+}
+
 //------------EUSCIA0_OutString------------
 // Output String (NULL termination)
 // Input: pointer to a NULL-terminated string to be transferred
 // Output: none
 void EUSCIA0_OutString(char *pt){
-  while(*pt){
-    EUSCIA0_OutChar(*pt);
-    pt++;
+  uint32_t size = 0, n;
+  while(pt[size]){
+    size = size + 1;
+  }
+  while(size){
+    n = TxFifo0_Room();        // spin if full
+    if(n > size) n = size;
+    if(n){
+      TxFifo0_PutBlock(pt, n); // fits, so it is not counted in TxFifo0Lost
+      pt = pt + n;
+      size = size - n;
+    }
+    EUSCI_A0->IE = 0x0003;     // enable interrupts on transmit empty and receive full
   }
 }
 
@@ -179,69 +250,9 @@ char character;
 // Output: none
 // Variable format 1-10 digits with no space before or after
 void EUSCIA0_OutUDec(uint32_t n){
-// This function uses recursion to convert decimal number
-//   of unspecified length as an ASCII string
-  if(n >= 10){
-    EUSCIA0_OutUDec(n/10);
-    n = n%10;
-  }
-  EUSCIA0_OutChar(n+'0'); /* n is between 0 and 9 */
-}
-
-uint32_t Messageindexc;
-char Messagec[8];
-void static fillmessagec(uint32_t n){
-// This function uses recursion to convert decimal number
-//   of unspecified length as an ASCII string
-  if(n >= 10){
-    fillmessagec(n/10);
-    n = n%10;
-  }
-  Messagec[Messageindexc] = (n+'0'); /* n is between 0 and 9 */
-  if(Messageindexc<7)Messageindexc++;
-}
-void static fillmessage4b(uint32_t n){
-  if(n>=1000){  // 1000 to 9999
-    Messageindexc = 0;
-  } else if(n>=100){  // 100 to 999
-    Messagec[0] = ' ';
-    Messageindexc = 1;
-  }else if(n>=10){ //
-    Messagec[0] = ' '; /* n is between 10 and 99 */
-    Messagec[1] = ' ';
-    Messageindexc = 2;
-  }else{
-    Messagec[0] = ' '; /* n is between 0 and 9 */
-    Messagec[1] = ' ';
-    Messagec[2] = ' ';
-    Messageindexc = 3;
-  }
-  fillmessagec(n);
-}
-void static fillmessage5b(uint32_t n){
-  if(n>99999)n=99999;
-  if(n>=10000){  // 10000 to 99999
-    Messageindexc = 0;
-  } else if(n>=1000){  // 1000 to 9999
-    Messagec[0] = ' ';
-    Messageindexc = 1;
-  }else if(n>=100){  // 100 to 999
-    Messagec[0] = ' ';
-    Messagec[1] = ' ';
-    Messageindexc = 2;
-  }else if(n>=10){ //
-    Messagec[0] = ' '; /* n is between 10 and 99 */
-    Messagec[1] = ' ';
-    Messagec[2] = ' ';
-    Messageindexc = 3;
-  }else{
-    Messagec[0] = ' '; /* n is between 0 and 9 */
-    Messagec[1] = ' ';
-    Messagec[2] = ' ';
-    Messagec[3] = ' ';
-    Messageindexc = 4;
-  }
-  fillmessagec(n);
+  char buf[FORMAT_SIZE];
+  Format_UDec(buf, n, 0);
+  EUSCIA0_OutString(buf);
 }
 
 //-----------------------EUSCIA0_OutUDec4-----------------------
@@ -250,14 +261,9 @@ void static fillmessage5b(uint32_t n){
 // Output: none
 // Fixed format 4 digits with no space before or after
 void EUSCIA0_OutUDec4(uint32_t n){
-  if(n>9999){
-    EUSCIA0_OutString("****");
-  }else{
-    Messageindexc = 0;
-    fillmessage4b(n);
-    Messagec[Messageindexc] = 0; // terminate
-    EUSCIA0_OutString(Messagec);
-  }
+  char buf[FORMAT_SIZE];
+  Format_UDec(buf, n, 4);       // "****" above 9999
+  EUSCIA0_OutString(buf);
 }
 
 //-----------------------EUSCIA0_OutUDec5-----------------------
@@ -266,14 +272,9 @@ void EUSCIA0_OutUDec4(uint32_t n){
 // Output: none
 // Fixed format 5 digits with no space before or after
 void EUSCIA0_OutUDec5(uint32_t n){
-  if(n>99999){
-    EUSCIA0_OutString("*****");
-  }else{
-    Messageindexc = 0;
-    fillmessage5b(n);
-    Messagec[Messageindexc] = 0; // terminate
-    EUSCIA0_OutString(Messagec);
-  }
+  char buf[FORMAT_SIZE];
+  Format_UDec(buf, n, 5);       // "*****" above 99999
+  EUSCIA0_OutString(buf);
 }
 
 //-----------------------EUSCIA0_OutUFix1-----------------------
@@ -282,9 +283,9 @@ void EUSCIA0_OutUDec5(uint32_t n){
 // Output: none
 // fixed format <digit>.<digit> with no space before or after
 void EUSCIA0_OutUFix1(uint32_t n){
-  EUSCIA0_OutUDec(n/10);
-  EUSCIA0_OutChar('.');
-  EUSCIA0_OutUDec(n%10);
+  char buf[FORMAT_SIZE];
+  Format_UFix(buf, n, 1, 0);
+  EUSCIA0_OutString(buf);
 }
 
 //-----------------------EUSCIA0_OutUFix2-----------------------
@@ -293,11 +294,9 @@ void EUSCIA0_OutUFix1(uint32_t n){
 // Output: none
 // fixed format <digit>.<digit><digit> with no space before or after
 void EUSCIA0_OutUFix2(uint32_t n){
-  EUSCIA0_OutUDec(n/100);
-  EUSCIA0_OutChar('.');
-  n = n%100;
-  EUSCIA0_OutUDec(n/10);
-  EUSCIA0_OutUDec(n%10);
+  char buf[FORMAT_SIZE];
+  Format_UFix(buf, n, 2, 0);
+  EUSCIA0_OutString(buf);
 }
 
 //---------------------EUSCIA0_InUHex----------------------------------------
@@ -348,20 +347,9 @@ char character;
 // Output: none
 // Variable format 1 to 8 digits with no space before or after
 void EUSCIA0_OutUHex(uint32_t number){
-// This function uses recursion to convert the number of
-//   unspecified length as an ASCII string
-  if(number >= 0x10){
-    EUSCIA0_OutUHex(number/0x10);
-    EUSCIA0_OutUHex(number%0x10);
-  }
-  else{
-    if(number < 0xA){
-      EUSCIA0_OutChar(number+'0');
-     }
-    else{
-      EUSCIA0_OutChar((number-0x0A)+'A');
-    }
-  }
+  char buf[FORMAT_SIZE];
+  Format_UHex(buf, number, 0);
+  EUSCIA0_OutString(buf);
 }
 
 //--------------------------EUSCIA0_OutUHex2----------------------------
@@ -369,17 +357,10 @@ void EUSCIA0_OutUHex(uint32_t number){
 // Input: 32-bit number to be transferred
 // Output: none
 // Fixed format 2 digits with no space before or after
-void EUSCIA0outnibble(uint32_t n){
-  if(n < 0xA){
-    EUSCIA0_OutChar(n+'0');
-  }
-  else{
-    EUSCIA0_OutChar((n-0x0A)+'A');
-  }
-}
 void EUSCIA0_OutUHex2(uint32_t number){
-  EUSCIA0outnibble(number/0x10); // ms digit
-  EUSCIA0outnibble(number%0x10); // ls digit
+  char buf[FORMAT_SIZE];
+  Format_UHex(buf, number, 2);  // least significant byte
+  EUSCIA0_OutString(buf);
 }
 
 //------------EUSCIA0_InString------------
@@ -92,6 +92,24 @@ policies, either expressed or implied, of the FreeBSD Project.
  */
 void EUSCIA0_Init(void);
 
+/**
+ * @details   Initialize EUSCI_A0 for UART operation at any baud rate,
+ * @details   8 bit word length, no parity bits, one stop bit
+ * @param  brw   UCAxBRW, usually BAUD_BRW(baud) from Baud.h
+ * @param  mctlw UCAxMCTLW, usually BAUD_MCTLW(baud) from Baud.h
+ * @return none
+ * @note   assumes 48 MHz bus and 12 MHz SMCLK
+ * @note   EUSCIA0_Init() is EUSCIA0_InitBaud(115200)
+ * @brief  Initialize EUSCI A0 at any baud rate
+ */
+void EUSCIA0_InitRate(uint16_t brw, uint16_t mctlw);
+
+/**
+ * \brief Initialize EUSCI A0 at a baud rate, see Baud.h; a constant rate is
+ * converted to register settings by the compiler
+ */
+#define EUSCIA0_InitBaud(baud) EUSCIA0_InitRate(BAUD_BRW(baud), BAUD_MCTLW(baud))
+
 
 /**
  * @details   Receive a character from EUSCI_A0 UART
@@ -104,6 +122,16 @@ void EUSCIA0_Init(void);
  */
 char EUSCIA0_InChar(void);
 
+/**
+ * @details   Check the receive FIFO from EUSCI_A0 UART
+ * @details   non-blocking
+ * @param  none
+ * @return number of characters in FIFO available for reading
+ * @note   EUSCIA0_Init must be called once prior
+ * @brief  Check status of receive FIFO
+ */
+uint32_t EUSCIA0_InStatus(void);
+
 
 /**
  * @details   Transmit a character to EUSCI_A0 UART
@@ -128,6 +156,31 @@ void EUSCIA0_OutChar(char letter);
 void EUSCIA0_OutString(char *pt);
 
 
+/**
+ * @details   Set the function the EUSCI_A0 interrupt calls for the next
+ * @details   block to send, once TxFifo0 and the previous block are empty.
+ * @details   Blocks are sent straight from memory, without a copy.
+ * @param  source is a pointer to a user function (0 for none) that sets
+ * *pt to the next block and returns its size, or returns 0 if there is
+ * nothing to send; the previous block may be reused once it is called
+ * @return none
+ * @note   EUSCIA0_Init clears the function
+ * @brief  Set the source of transmit blocks
+ */
+void EUSCIA0_SetBlockSource(uint32_t(*source)(const uint8_t **pt));
+
+
+/**
+ * @details   Start sending blocks from the block source
+ * @details   non-blocking, safe to call from any interrupt
+ * @param  none
+ * @return none
+ * @note   EUSCIA0_Init and EUSCIA0_SetBlockSource must be called once prior
+ * @brief  Start block transmission
+ */
+void EUSCIA0_OutBlocks(void);
+
+
 /**
  * @details   Receive an unsigned number from EUSCI_A0 UART
  * @details   Accepts ASCII input in unsigned decimal format and converts to a 32-bit unsigned number
@@ -0,0 +1,166 @@
+/**
+ * @file      FIFO.h
+ * @brief     Macro that generates lock-free FIFO queues
+ * @details   AddIndexFifo(NAME,SIZE,TYPE) creates one queue of
+ * SIZE elements of TYPE, with these functions and counter:<br>
+ * void NAME_Init(void)                      empty the queue, clear NAME##Lost<br>
+ * int NAME_Put(TYPE data)                   FIFOSUCCESS, or FIFOFAIL if full<br>
+ * int NAME_Get(TYPE *datapt)                FIFOSUCCESS, or FIFOFAIL if empty<br>
+ * uint32_t NAME_Size(void)                  number of elements, 0 to SIZE-1<br>
+ * uint32_t NAME_Room(void)                  number of elements a put can store, 0 to SIZE-1<br>
+ * uint32_t NAME_PutBlock(const TYPE *data, uint32_t count)  number put<br>
+ * uint32_t NAME_GetBlock(TYPE *datapt, uint32_t count)      number removed<br>
+ * uint32_t NAME##Lost                       elements a put could not store because the queue was full<br>
+ * NAME_Put and NAME_PutBlock count in NAME##Lost what did not fit, so
+ * they are for callers that drop data when the queue is full.  A
+ * caller that waits for room spins on NAME_Room, which counts nothing,
+ * and then puts only what fits.<br>
+ * TYPE can be a byte for a UART or a struct for samples and events.
+ * SIZE must be a power of 2; the queue holds up to SIZE-1 elements.
+ * The indices run freely and are masked on access.  Each index has
+ * one writer, and the data is moved before the index, so one producer
+ * and one consumer (such as an ISR and main) share the queue with no
+ * critical sections.<br>
+ * AddIndexFifoHistogram(NAME,SIZE,TYPE,HISTOGRAM) also counts the size
+ * of the queue at the start of each put call in HISTOGRAM[size], an
+ * array of SIZE uint32_t defined by the caller and cleared by NAME_Init.
+ * @version   V1.0
+ * @author    Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ ******************************************************************************/
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef FIFO_H_
+#define FIFO_H_
+
+#ifndef FIFOSUCCESS
+#define FIFOSUCCESS 1     // return value on success
+#endif
+#ifndef FIFOFAIL
+#define FIFOFAIL    0     // return value on failure
+#endif
+
+/**
+ * \brief Generate a lock-free queue named NAME, see the file description
+ */
+#define AddIndexFifo(NAME,SIZE,TYPE) \
+  FIFOBODY(NAME,SIZE,TYPE,FIFONOHOOK,FIFONOHOOK)
+
+/**
+ * \brief Generate a lock-free queue named NAME with an occupancy histogram
+ */
+#define AddIndexFifoHistogram(NAME,SIZE,TYPE,HISTOGRAM) \
+  FIFOBODY(NAME,SIZE,TYPE, \
+    {uint32_t i; for(i=0; i<SIZE; i++) HISTOGRAM[i] = 0;}, \
+    HISTOGRAM[size]++;)
+
+// INITHOOK runs in NAME_Init, PUTHOOK at the start of each put with
+// the current size in size
+#define FIFONOHOOK
+#define FIFOBODY(NAME,SIZE,TYPE,INITHOOK,PUTHOOK) \
+static volatile uint32_t NAME ## PutI;   /* index of where to put next */ \
+static volatile uint32_t NAME ## GetI;   /* index of where to get next */ \
+static volatile TYPE NAME ## Buffer[SIZE]; \
+uint32_t NAME ## Lost;                   /* should be 0 */ \
+void NAME ## _Init(void){ \
+  NAME ## PutI = NAME ## GetI = 0;       /* empty */ \
+  NAME ## Lost = 0; \
+  INITHOOK \
+} \
+int NAME ## _Put(TYPE data){ \
+  uint32_t put = NAME ## PutI; \
+  uint32_t size = put - NAME ## GetI; \
+  PUTHOOK \
+  if(size == (SIZE-1)){ \
+    NAME ## Lost++; \
+    return(FIFOFAIL);                    /* full */ \
+  } \
+  NAME ## Buffer[put&(SIZE-1)] = data;   /* data first */ \
+  NAME ## PutI = put + 1;                /* then publish */ \
+  return(FIFOSUCCESS); \
+} \
+int NAME ## _Get(TYPE *datapt){ \
+  uint32_t get = NAME ## GetI; \
+  if(NAME ## PutI == get){ \
+    return(FIFOFAIL);                    /* empty */ \
+  } \
+  *datapt = NAME ## Buffer[get&(SIZE-1)];/* data first */ \
+  NAME ## GetI = get + 1;                /* then release the slot */ \
+  return(FIFOSUCCESS); \
+} \
+uint32_t NAME ## _Size(void){ \
+  return NAME ## PutI - NAME ## GetI; \
+} \
+uint32_t NAME ## _Room(void){ \
+  return (SIZE-1) - (NAME ## PutI - NAME ## GetI); \
+} \
+uint32_t NAME ## _PutBlock(const TYPE *data, uint32_t count){ \
+  uint32_t put = NAME ## PutI; \
+  uint32_t size = put - NAME ## GetI; \
+  uint32_t i; \
+  PUTHOOK \
+  if(count > (SIZE-1) - size){ \
+    NAME ## Lost += count - ((SIZE-1) - size); \
+    count = (SIZE-1) - size; \
+  } \
+  for(i=0; i<count; i++){ \
+    NAME ## Buffer[(put + i)&(SIZE-1)] = data[i]; \
+  } \
+  NAME ## PutI = put + count;            /* publish all at once */ \
+  return count; \
+} \
+uint32_t NAME ## _GetBlock(TYPE *datapt, uint32_t count){ \
+  uint32_t get = NAME ## GetI; \
+  uint32_t size = NAME ## PutI - get; \
+  uint32_t i; \
+  if(count > size){ \
+    count = size; \
+  } \
+  for(i=0; i<count; i++){ \
+    datapt[i] = NAME ## Buffer[(get + i)&(SIZE-1)]; \
+  } \
+  NAME ## GetI = get + count;            /* release all at once */ \
+  return count; \
+}
+
+#endif /* FIFO_H_ */
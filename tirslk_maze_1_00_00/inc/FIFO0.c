@@ -44,87 +44,31 @@ policies, either expressed or implied, of the FreeBSD Project.
 */
 
 #include <stdint.h>
+#include "../inc/FIFO.h"
 #include "../inc/FIFO0.h"
 
 // Implementation of the transmit FIFO, TxFifo0
-// can hold 0 to TXFIFOSIZE-1 elements
-// you are allowed to restrict TXFIFOSIZE to a power of 2
-
-// add static, volatile, global variables here this as part of Lab 18
+// can hold 0 to TX0FIFOSIZE-1 elements
+// TxFifo0_Init, _Put, _Get, _Size, _Room, _PutBlock, _GetBlock and TxFifo0Lost
+// come from the lock-free generator in FIFO.h
 
 uint32_t TxHistogram[TX0FIFOSIZE]; 
 // probability mass function of the number of times TxFifo0 as this size
 // as a function of FIFO size at the beginning of call to TxFifo0_Put
-// initialize index TxFifo0
-void TxFifo0_Init(void){int i;
-
-// write this as part of Lab 18
-
-  for(i=0;i<TX0FIFOSIZE;i++){
-      TxHistogram[i] = 0;
+// (one count per call for the block functions)
+AddIndexFifoHistogram(TxFifo0, TX0FIFOSIZE, char, TxHistogram)
+
+// add a null-terminated string to end of TxFifo0, without the null
+// returns number of characters added, less than the length if full;
+// the characters that did not fit count in TxFifo0Lost
+uint32_t TxFifo0_PutString(const char *pt){
+  uint32_t length = 0;
+  while(pt[length]){
+    length = length + 1;
   }
-}
-// add element to end of index TxFifo0
-// return TXFIFOSUCCESS if successful
-int TxFifo0_Put(char data){
-  TxHistogram[TxFifo0_Size()]++;  // probability mass function
-
-// write this as part of Lab 18
-
-  return(FIFOSUCCESS);
-}
-// remove element from front of TxFifo0
-// return TXFIFOSUCCESS if successful
-int TxFifo0_Get(char *datapt){
-
-// write this as part of Lab 18
-
-
-  return(FIFOSUCCESS);
-}
-// number of elements in TxFifo0
-// 0 to TXFIFOSIZE-1
-uint16_t TxFifo0_Size(void){
-
-// write this as part of Lab 18
-
- return 0; // replace this line
+  return TxFifo0_PutBlock(pt, length);
 }
 
 // Implementation of the receive FIFO, RxFifo0
-// can hold 0 to RXFIFOSIZE-1 elements
-// you are allowed to restrict RXFIFOSIZE to a power of 2
-
-// add static, volatile, global variables here this as part of Lab 18
-
-// initialize RxFifo0
-void RxFifo0_Init(void){
-
-// write this as part of Lab 18
-
-}
-// add element to end of RxFifo0
-// return FIFOSUCCESS if successful
-int RxFifo0_Put(char data){
-
-  // write this as part of Lab 18
-
-  return(FIFOSUCCESS);
-}
-// remove element from front of RxFifo0
-// return FIFOSUCCESS if successful
-int RxFifo0_Get(char *datapt){
-
-  // write this as part of Lab 18
-
-  return(FIFOSUCCESS);
-}
-// number of elements in RxFifo0
-// 0 to RXFIFOSIZE-1
-uint16_t RxFifo0_Size(void){
-// write this as part of Lab 18
-
- return 0; // replace this line
-}
-
-
+// can hold 0 to RX0FIFOSIZE-1 elements
+AddIndexFifo(RxFifo0, RX0FIFOSIZE, char)
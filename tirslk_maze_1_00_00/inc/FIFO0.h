@@ -2,7 +2,10 @@
  * @file      FIFO0.h
  * @brief     Provide two FIFO queues
  * @details   Provide functions that initialize a FIFO, put data in, get data out,
- *            and return the current size.
+ *            and return the current size.  Each FIFO is a lock-free ring for one
+ *            producer and one consumer, such as main and EUSCIA0_IRQHandler,
+ *            generated by AddIndexFifo in FIFO.h.  TxFifo0Lost and RxFifo0Lost
+ *            count the elements a put could not store.
  * @remark    The sizes of the FIFO must be a power of two
  * @version   V1.0
  * @author    Valvano
@@ -84,6 +87,7 @@ void TxFifo0_Init(void);
 /**
  * @details   Add one 8-bit element to TxFifo0.
  * @details   Can hold 0 to TX0FIFOSIZE-1 elements, first in first out
+ * @details   A put into a full TxFifo0 counts in TxFifo0Lost; to wait instead, see TxFifo0_Room.
  * @warning  TxFifo0_Put itself need not be reentrant, but TxFifo0_Put must be thread-safe with TxFifo0_Get
  * @param  data 8-bit value to store into TxFifo0
  * @return FIFOSUCCESS if ok, FIFOFAIL if full and could not be saved
@@ -91,6 +95,30 @@ void TxFifo0_Init(void);
  */
 int TxFifo0_Put(char data);
 
+/**
+ * @details   Add up to count 8-bit elements to TxFifo0 with one update of the put index.
+ * @details   Stops early if TxFifo0 fills and counts the rest in TxFifo0Lost;
+ * the histogram counts one call.  To wait instead, see TxFifo0_Room.
+ * @warning  Same thread-safety rules as TxFifo0_Put
+ * @param  data pointer to the elements to store into TxFifo0
+ * @param  count number of elements to store
+ * @return number of elements stored, 0 to count
+ * @brief  Put a block into TxFifo0
+ */
+uint32_t TxFifo0_PutBlock(const char *data, uint32_t count);
+
+/**
+ * @details   Add the characters of a null-terminated string, without the null, to TxFifo0
+ * with one update of the put index.
+ * @details   Stops early if TxFifo0 fills and counts the rest in TxFifo0Lost;
+ * the histogram counts one call.
+ * @warning  Same thread-safety rules as TxFifo0_Put
+ * @param  pt pointer to a null-terminated string
+ * @return number of characters stored
+ * @brief  Put a string into TxFifo0
+ */
+uint32_t TxFifo0_PutString(const char *pt);
+
 /**
  * @details   Remove one 8-bit element from TxFifo0.
  * @details   Returns the oldest value, first in first out
@@ -101,6 +129,16 @@ int TxFifo0_Put(char data);
  */
 int TxFifo0_Get(char *datapt);
 
+/**
+ * @details   Remove up to count 8-bit elements from TxFifo0 with one update of the get index.
+ * @warning  Same thread-safety rules as TxFifo0_Get
+ * @param  datapt pointer to storage for at least count elements
+ * @param  count largest number of elements to remove
+ * @return number of elements removed, 0 if empty
+ * @brief  Get a block from TxFifo0
+ */
+uint32_t TxFifo0_GetBlock(char *datapt, uint32_t count);
+
 /**
  * @details   Return the number of elements in TxFifo0.
  * @details   Can hold 0 to TX0FIFOSIZE-1 elements
@@ -108,7 +146,22 @@ int TxFifo0_Get(char *datapt);
  * @return number of elements in TxFifo0
  * @brief  Current size of TxFifo0
  */
-uint16_t TxFifo0_Size(void);
+uint32_t TxFifo0_Size(void);
+
+/**
+ * @details   Return the number of elements TxFifo0 can take now, without
+ * counting anything in TxFifo0Lost or the histogram.  Wait on it, then
+ * put only what fits, to send without dropping.
+ * @param  none
+ * @return free space in TxFifo0, 0 to TX0FIFOSIZE-1
+ * @brief  Free space in TxFifo0
+ */
+uint32_t TxFifo0_Room(void);
+
+/**
+ * count of characters a put could not store because TxFifo0 was full, should be 0
+ */
+extern uint32_t TxFifo0Lost;
 
 /**
  * \brief Size of the RxFifo0, can hold 0 to RX0FIFOSIZE-1 elements, must be a power of 2
@@ -134,6 +187,16 @@ void RxFifo0_Init(void);
  */
 int RxFifo0_Put(char data);
 
+/**
+ * @details   Add up to count 8-bit elements to RxFifo0 with one update of the put index.
+ * @warning  Same thread-safety rules as RxFifo0_Put
+ * @param  data pointer to the elements to store into RxFifo0
+ * @param  count number of elements to store
+ * @return number of elements stored, 0 to count
+ * @brief  Put a block into RxFifo0
+ */
+uint32_t RxFifo0_PutBlock(const char *data, uint32_t count);
+
 
 /**
  * @details   Remove one 8-bit element from RxFifo0.
@@ -145,6 +208,16 @@ int RxFifo0_Put(char data);
  */
 int RxFifo0_Get(char *datapt);
 
+/**
+ * @details   Remove up to count 8-bit elements from RxFifo0 with one update of the get index.
+ * @warning  Same thread-safety rules as RxFifo0_Get
+ * @param  datapt pointer to storage for at least count elements
+ * @param  count largest number of elements to remove
+ * @return number of elements removed, 0 if empty
+ * @brief  Get a block from RxFifo0
+ */
+uint32_t RxFifo0_GetBlock(char *datapt, uint32_t count);
+
 /**
  * @details   Return the number of elements in RxFifo0.
  * @details   Can hold 0 to RX0FIFOSIZE-1 elements
@@ -152,7 +225,21 @@ int RxFifo0_Get(char *datapt);
  * @return number of elements in RxFifo0
  * @brief  Current size of RxFifo0
  */
-uint16_t RxFifo0_Size(void);
+uint32_t RxFifo0_Size(void);
+
+/**
+ * @details   Return the number of elements RxFifo0 can take now, without
+ * counting anything in RxFifo0Lost.
+ * @param  none
+ * @return free space in RxFifo0, 0 to RX0FIFOSIZE-1
+ * @brief  Free space in RxFifo0
+ */
+uint32_t RxFifo0_Room(void);
+
+/**
+ * count of characters a put could not store because RxFifo0 was full, should be 0
+ */
+extern uint32_t RxFifo0Lost;
 
 
 
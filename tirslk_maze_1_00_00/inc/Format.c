@@ -0,0 +1,229 @@
+// Format.c
+// Runs on MSP432
+// Division-free conversion of integers and fixed-point numbers
+// to text, shared by the serial and LCD drivers.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+// The Cortex-M4 divide takes up to 12 cycles, and the old recursive
+// formatters did one per digit plus a call; here a 32x32 multiply
+// gives the quotient by 100 and one table read gives two digits.
+
+#include <stdint.h>
+#include "../inc/Format.h"
+
+static const char Pairs[201] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+static const uint32_t Powers[10] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000,
+  10000000, 100000000, 1000000000
+};
+
+// n/10 and n/100 for any 32-bit n, from 2^35/10 and 2^37/100 rounded up
+static uint32_t div10(uint32_t n){
+  return (uint32_t)(((uint64_t)n*0xCCCCCCCD)>>35);
+}
+static uint32_t div100(uint32_t n){
+  return (uint32_t)(((uint64_t)n*0x51EB851F)>>37);
+}
+
+// number of decimal digits in n, 1 to 10
+static uint32_t count(uint32_t n){
+  if(n < 100000){
+    if(n < 100) return (n < 10)? 1 : 2;
+    if(n < 10000) return (n < 1000)? 3 : 4;
+    return 5;
+  }
+  if(n < 10000000) return (n < 1000000)? 6 : 7;
+  if(n < 1000000000) return (n < 100000000)? 8 : 9;
+  return 10;
+}
+
+// write the digits of n backward, the last one just before end;
+// returns a pointer to the first
+static char *convert(char *end, uint32_t n){
+  uint32_t q, r;
+  while(n >= 100){
+    q = div100(n);
+    r = 2*(n - 100*q);
+    end = end - 2;
+    end[0] = Pairs[r];
+    end[1] = Pairs[r+1];
+    n = q;
+  }
+  if(n >= 10){
+    end = end - 2;
+    end[0] = Pairs[2*n];
+    end[1] = Pairs[2*n+1];
+  }else{
+    end = end - 1;
+    end[0] = '0' + n;
+  }
+  return end;
+}
+
+// start a field of size characters: returns where they go, after
+// any spaces that right-justify them in width, or 0 if they do not
+// fit, after filling the width with '*'
+static char *field(char *buf, uint32_t size, uint32_t width){
+  uint32_t i;
+  if(width == 0){
+    buf[size] = 0;
+    return buf;
+  }
+  if(size > width){
+    for(i=0; i<width; i=i+1){
+      buf[i] = '*';
+    }
+    buf[width] = 0;
+    return 0;
+  }
+  for(i=0; i<width-size; i=i+1){
+    buf[i] = ' ';
+  }
+  buf[width] = 0;
+  return &buf[width-size];
+}
+
+//------------Format_UDec------------
+// Convert an unsigned number to decimal.
+// Input: buf pointer to at least FORMAT_SIZE characters, or width+1 if larger
+//        n number to convert
+//        width 0 for 1 to 10 digits, else the field size
+// Output: number of characters, not counting the null
+uint32_t Format_UDec(char *buf, uint32_t n, uint32_t width){
+  uint32_t size = count(n);
+  char *pt = field(buf, size, width);
+  if(pt){
+    convert(pt + size, n);
+  }
+  return width? width : size;
+}
+
+//------------Format_SDec------------
+// Convert a signed number to decimal, with a '-' if negative.
+// Input: buf pointer to at least FORMAT_SIZE characters, or width+1 if larger
+//        n number to convert
+//        width 0 for 1 to 11 characters, else the field size
+// Output: number of characters, not counting the null
+uint32_t Format_SDec(char *buf, int32_t n, uint32_t width){
+  uint32_t magnitude = (n < 0)? 0u - (uint32_t)n : (uint32_t)n;
+  uint32_t size = count(magnitude) + (n < 0);
+  char *pt = field(buf, size, width);
+  if(pt){
+    pt[0] = '-';                // replaced by the first digit if positive
+    convert(pt + size, magnitude);
+  }
+  return width? width : size;
+}
+
+//------------Format_UFix------------
+// Convert an unsigned fixed-point number to decimal with a point.
+// Input: buf pointer to at least FORMAT_SIZE characters, or width+1 if larger
+//        n number to convert, in units of 10^-decimals
+//        decimals digits after the point, 1 to 9
+//        width 0 for as many characters as needed, else the field size
+// Output: number of characters, not counting the null
+uint32_t Format_UFix(char *buf, uint32_t n, uint32_t decimals, uint32_t width){
+  uint32_t whole, fraction, size, i;
+  char *pt;
+  if(decimals == 1){
+    whole = div10(n);           // the common cases, without a divide
+  }else if(decimals == 2){
+    whole = div100(n);
+  }else{
+    whole = n/Powers[decimals];
+  }
+  size = count(whole) + 1 + decimals;
+  pt = field(buf, size, width);
+  if(pt){
+    pt = pt + size - decimals;  // first digit of the fraction
+    fraction = n - whole*Powers[decimals];
+    if(decimals == 1){
+      pt[0] = '0' + fraction;
+    }else if(decimals == 2){
+      pt[0] = Pairs[2*fraction];
+      pt[1] = Pairs[2*fraction+1];
+    }else{
+      for(i=0; i<decimals; i=i+1){
+        pt[i] = '0';            // leading zeros of the fraction
+      }
+      convert(pt + decimals, fraction);
+    }
+    pt = pt - 1;
+    pt[0] = '.';
+    convert(pt, whole);
+  }
+  return width? width : size;
+}
+
+//------------Format_UHex------------
+// Convert an unsigned number to upper case hexadecimal.
+// Input: buf pointer to at least FORMAT_SIZE characters
+//        n number to convert
+//        size 0 for 1 to 8 digits, else that many least significant digits
+// Output: number of characters, not counting the null
+uint32_t Format_UHex(char *buf, uint32_t n, uint32_t size){
+  static const char Hex[16] = "0123456789ABCDEF";
+  uint32_t i;
+  if(size == 0){
+    size = 1;
+    while((size < 8) && (n>>(4*size))){
+      size = size + 1;
+    }
+  }
+  for(i=size; i>0; i=i-1){
+    buf[i-1] = Hex[n&0x0F];
+    n = n>>4;
+  }
+  buf[size] = 0;
+  return size;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file      Format.h
+ * @brief     Integer and fixed-point number to text conversion
+ * @details   One set of formatters shared by UART0, EUSCIA0 and the
+ * Nokia5110 display.  Each writes a null-terminated string into a
+ * buffer given by the caller and returns its length, so the driver can
+ * send the whole number at once.  Digits are produced two at a time
+ * from a table of "00" to "99", and the quotient by 100 is found with
+ * a multiply by its reciprocal instead of a divide.<br>
+ * A field width of 0 means as many characters as needed.  A number
+ * that does not fit in a nonzero width is printed as width '*'.
+ * @version   V1.0
+ * @author    Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ ******************************************************************************/
+
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+/**
+ * \brief buffer size that holds any 32-bit number in a width of 0 to 11
+ */
+#define FORMAT_SIZE 12
+
+/**
+ * Convert an unsigned number to decimal.
+ * @param buf pointer to at least FORMAT_SIZE characters, or width+1 if larger
+ * @param n number to convert
+ * @param width 0 for 1 to 10 digits, else the field size with spaces on the left
+ * @return number of characters, not counting the null
+ * @brief Format unsigned decimal
+ */
+uint32_t Format_UDec(char *buf, uint32_t n, uint32_t width);
+
+/**
+ * Convert a signed number to decimal, with a '-' if negative.
+ * @param buf pointer to at least FORMAT_SIZE characters, or width+1 if larger
+ * @param n number to convert
+ * @param width 0 for 1 to 11 characters, else the field size with spaces on the left
+ * @return number of characters, not counting the null
+ * @brief Format signed decimal
+ */
+uint32_t Format_SDec(char *buf, int32_t n, uint32_t width);
+
+/**
+ * Convert an unsigned fixed-point number to decimal with a
+ * point, such as 123 with 2 decimals to "1.23".
+ * @param buf pointer to at least FORMAT_SIZE characters, or width+1 if larger
+ * @param n number to convert, in units of 10^-decimals
+ * @param decimals digits after the point, 1 to 9
+ * @param width 0 for as many characters as needed, else the field size with spaces on the left
+ * @return number of characters, not counting the null
+ * @brief Format unsigned fixed point
+ */
+uint32_t Format_UFix(char *buf, uint32_t n, uint32_t decimals, uint32_t width);
+
+/**
+ * Convert an unsigned number to upper case hexadecimal.
+ * @param buf pointer to at least FORMAT_SIZE characters
+ * @param n number to convert
+ * @param size 0 for 1 to 8 digits, else that many of the least significant digits, with leading zeros
+ * @return number of characters, not counting the null
+ * @brief Format unsigned hexadecimal
+ */
+uint32_t Format_UHex(char *buf, uint32_t n, uint32_t digits);
+
+#endif /* FORMAT_H_ */
@@ -42,8 +42,11 @@ those of the authors and should not be interpreted as representing official
 policies, either expressed or implied, of the FreeBSD Project.
 */
 
+#include <stdint.h>
 #include "msp.h"
 #include "GPIO.h"
+
+void (*SRDYTask)(void);   // user function
 // Legend    TI part number
 // CC2650BP  BOOSTXL-CC2650MA
 // CC2650LP  LAUNCHXL-CC2650
@@ -90,6 +93,31 @@ void GPIO_Init(void){
   P6->DS |= 0x80;     // 3) activate increased drive strength
   ClearReset();     // RESET=0    
 }
+
+//------------GPIO_SRDYArm------------
+// Arm interrupts on both edges of SRDY (P2.5)
+// Input: task is a pointer to a user function run after each edge
+// Output: none
+void GPIO_SRDYArm(void(*task)(void)){
+  SRDYTask = task;
+  P2->IES = (P2->IES&~0x20)|(P2->IN&0x20); // falling edge next if high, rising if low
+  P2->IFG &= ~0x20;   // clear flag5
+  P2->IE |= 0x20;     // arm interrupt on P2.5
+  NVIC->IP[9] = (NVIC->IP[9]&0xFFFFFF00)|0x00000040; // priority 2
+  NVIC->ISER[1] = 0x00000010; // enable interrupt 36 in NVIC
+}
+// an edge can be missed while IES is changed,
+// so repeat until the level is the one IES was set for
+void PORT2_IRQHandler(void){ uint8_t level;
+  do{
+    level = P2->IN&0x20;
+    P2->IES = (P2->IES&~0x20)|level; // catch the opposite edge next
+    P2->IFG &= ~0x20;   // acknowledge flag5
+  }while((P2->IN&0x20) != level);
+  if(SRDYTask){
+    (*SRDYTask)();    // execute user task
+  }
+}
 #else
 // These three options require either reprogramming the CC2650LP/CC2650BP or using a 7-wire tether
 // These three options allow the use of the MKII I/O boosterpack
@@ -154,4 +182,29 @@ void GPIO_Init(void){
   P6->DS |= 0x80;     // 3) activate increased drive strength
   ClearReset();     // RESET=0    
 }
+
+//------------GPIO_SRDYArm------------
+// Arm interrupts on both edges of SRDY (P5.2)
+// Input: task is a pointer to a user function run after each edge
+// Output: none
+void GPIO_SRDYArm(void(*task)(void)){
+  SRDYTask = task;
+  P5->IES = (P5->IES&~0x04)|(P5->IN&0x04); // falling edge next if high, rising if low
+  P5->IFG &= ~0x04;   // clear flag2
+  P5->IE |= 0x04;     // arm interrupt on P5.2
+  NVIC->IP[9] = (NVIC->IP[9]&0x00FFFFFF)|0x40000000; // priority 2
+  NVIC->ISER[1] = 0x00000080; // enable interrupt 39 in NVIC
+}
+// an edge can be missed while IES is changed,
+// so repeat until the level is the one IES was set for
+void PORT5_IRQHandler(void){ uint8_t level;
+  do{
+    level = P5->IN&0x04;
+    P5->IES = (P5->IES&~0x04)|level; // catch the opposite edge next
+    P5->IFG &= ~0x04;   // acknowledge flag2
+  }while((P5->IN&0x04) != level);
+  if(SRDYTask){
+    (*SRDYTask)();    // execute user task
+  }
+}
 #endif
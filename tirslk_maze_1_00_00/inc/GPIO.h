@@ -165,3 +165,13 @@ policies, either expressed or implied, of the FreeBSD Project.
  * @brief  Initialize MRDY (out), SRDY (in), RESET (out) GPIO pins
  */
 void GPIO_Init(void);
+
+/**
+ * Arm interrupts on both edges of SRDY.  The task runs in the
+ * port interrupt after each edge and reads the level with ReadSRDY().
+ * @param  task is a pointer to a user function (0 for none)
+ * @return none
+ * @note   GPIO_Init must be called once prior
+ * @brief  Arm SRDY edge interrupts
+ */
+void GPIO_SRDYArm(void(*task)(void));
@@ -0,0 +1,236 @@
+// Junction.c
+// Runs on MSP432
+// Streaming classifier that recognizes maze junctions from the
+// 8-bit reflectance samples and the distance travelled.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+// reflectance sensor bit 7 is the robot's left, bit 0 its right
+// a branch is every sensor from the center to one edge black
+
+#include <stdint.h>
+#include "../inc/Tachometer.h"
+#include "../inc/Junction.h"
+
+#define LEFTWING  0xF8    // P7.7-P7.3 black
+#define RIGHTWING 0x1F    // P7.4-P7.0 black
+#define CENTER    0x18    // P7.4-P7.3
+
+enum JunctionState{
+  FOLLOWING,   // on a plain line
+  BRANCHING,   // sensor bar over a side branch
+  LOOKING,     // past the branch, checking the line ahead
+  LOST,        // no line under the sensors
+  WAITING      // event reported, waiting for a plain line
+};
+
+void (*JunctionTask)(enum JunctionType type, uint32_t confidence);   // user function
+static enum JunctionState State;
+static int32_t Start;         // distance when the current state began, mm
+static int32_t BranchStart;   // distance when the branch began, mm
+static uint32_t Samples;      // samples in the current state
+static uint32_t LeftCount, RightCount, FullCount, CenterCount;
+static uint32_t BranchSamples;   // samples over the branch
+static uint32_t Misses;       // consecutive samples that disagree
+// published event, written only by Junction_Sample
+static volatile enum JunctionType Type;
+static volatile uint32_t Confidence;
+static volatile int32_t Distance;
+static volatile uint32_t Sequence;
+
+static void enter(enum JunctionState state, int32_t distance){
+  State = state;
+  Start = distance;
+  Samples = 0;
+  Misses = 0;
+  LeftCount = RightCount = FullCount = CenterCount = 0;
+}
+
+static enum JunctionType report(enum JunctionType type, uint32_t confidence, int32_t distance){
+  Type = type;
+  Confidence = confidence;
+  Distance = distance;
+  Sequence = Sequence + 1;      // publish last
+  if(JunctionTask){
+    (*JunctionTask)(type, confidence);   // execute user task
+  }
+  return type;
+}
+
+// ------------Junction_Init------------
+// Reset the classifier.
+// Input: task is a pointer to a user function called with each event (0 for none)
+// Output: none
+void Junction_Init(void(*task)(enum JunctionType type, uint32_t confidence)){
+  JunctionTask = task;
+  Type = NOJUNCTION;
+  Confidence = 0;
+  Distance = 0;
+  Sequence = 0;
+  enter(FOLLOWING, 0);
+}
+
+// ------------Junction_Sample------------
+// Classify one reflectance sample.
+// Input: data is 8-bit result from line sensor
+//        distance travelled in mm
+// Output: event completed by this sample, or NOJUNCTION
+enum JunctionType Junction_Sample(uint8_t data, int32_t distance){
+  int left = ((data&LEFTWING) == LEFTWING);
+  int right = ((data&RIGHTWING) == RIGHTWING);
+  uint32_t wing, ahead;
+  int32_t at;
+  Samples = Samples + 1;
+  switch(State){
+    case FOLLOWING:
+      if(left || right){
+        enter(BRANCHING, distance);
+        BranchStart = distance;
+        Samples = 1;
+        LeftCount = left;
+        RightCount = right;
+        FullCount = (data == 0xFF);
+      }else if(data == 0){
+        enter(LOST, distance);
+        Samples = 1;
+        CenterCount = 1;
+      }
+      break;
+    case LOST:
+      if(data == 0){
+        Misses = 0;
+        CenterCount = CenterCount + 1;      // samples agreeing the line is gone
+      }else if(++Misses >= JUNCTION_MISSES){
+        enter(FOLLOWING, distance);       // line found again
+        break;
+      }
+      if((distance - Start) >= JUNCTION_DEADEND){
+        ahead = 100*CenterCount/Samples;
+        at = Start;
+        enter(WAITING, distance);
+        return report(DEADEND, ahead, at);
+      }
+      break;
+    case BRANCHING:
+      if(left) LeftCount = LeftCount + 1;
+      if(right) RightCount = RightCount + 1;
+      if(data == 0xFF) FullCount = FullCount + 1;
+      if((FullCount*2 > Samples) && ((distance - Start) >= JUNCTION_GOAL)){
+        wing = 100*FullCount/Samples;
+        enter(WAITING, distance);
+        return report(GOAL, wing, BranchStart);
+      }
+      if(left || right){
+        Misses = 0;
+      }else if(++Misses >= JUNCTION_MISSES){
+        // branch is behind the sensors, keep the wing counts
+        BranchSamples = Samples - Misses;
+        State = LOOKING;
+        Start = distance;
+        Misses = 0;
+        CenterCount = 0;
+        Samples = 0;
+      }
+      break;
+    case LOOKING:
+      if(data&CENTER) CenterCount = CenterCount + 1;
+      if((distance - Start) >= JUNCTION_LOOKAHEAD){
+        int isLeft = (LeftCount*3 >= BranchSamples);
+        int isRight = (RightCount*3 >= BranchSamples);
+        int straight = (CenterCount*2 > Samples);
+        enum JunctionType type;
+        if(isLeft && isRight){
+          type = straight? CROSS : TJUNCTION;
+          wing = ((LeftCount < RightCount)? LeftCount : RightCount);
+        }else if(isLeft){
+          type = straight? LEFTBRANCH : LEFTTURN;
+          wing = LeftCount;
+        }else{
+          type = straight? RIGHTBRANCH : RIGHTTURN;
+          wing = RightCount;
+        }
+        wing = 100*wing/BranchSamples;
+        ahead = 100*(straight? CenterCount : (Samples - CenterCount))/Samples;
+        // with no line ahead the robot has yet to turn, so wait for a
+        // plain line rather than report the gap as a dead end
+        enter(straight? FOLLOWING : WAITING, distance);
+        return report(type, (wing < ahead)? wing : ahead, BranchStart);
+      }
+      break;
+    case WAITING:
+      if((data == 0) || (data == 0xFF) || left || right){
+        Misses = 0;
+      }else if(++Misses >= JUNCTION_MISSES){
+        enter(FOLLOWING, distance);       // back on a plain line
+      }
+      break;
+  }
+  return NOJUNCTION;
+}
+
+// ------------Junction_Task------------
+// Classify one reflectance sample at the tachometer distance.
+// Input: data is 8-bit result from line sensor
+// Output: none
+// Assumes: Tachometer_Init() has been called
+void Junction_Task(uint8_t data){
+  uint32_t leftTach, rightTach;
+  enum TachDirection leftDir, rightDir;
+  int32_t leftSteps, rightSteps;
+  Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+  Junction_Sample(data, (leftSteps + rightSteps)*220/720);  // 360 steps per 220 mm, averaged
+}
+
+// ------------Junction_Get------------
+// Return the most recent event. Retries if Junction_Sample
+// publishes a new event in the middle of the copy.
+// Input: type, confidence and distance are pointers to return the event
+// Output: number of events so far
+uint32_t Junction_Get(enum JunctionType *type, uint32_t *confidence, int32_t *distance){
+  uint32_t sequence;
+  do{
+    sequence = Sequence;
+    *type = Type;
+    *confidence = Confidence;
+    *distance = Distance;
+  }while(sequence != Sequence);
+  return sequence;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file      Junction.h
+ * @brief     Recognize maze junctions from the reflectance sensor array
+ * @details   A streaming classifier that runs on each 8-bit sample from
+ * the QTR-8RC, together with the distance travelled, and reports
+ * turns, T-junctions, crosses, dead ends and the goal pad as soon as
+ * the sensor bar has passed over them.<br>
+ 1) A side branch is seen as every sensor from the center to that edge being black<br>
+ 2) After the branch, the center sensors tell whether the line also continues straight<br>
+ 3) A long stretch with all eight sensors black is the goal<br>
+ 4) A long stretch with no sensor black is a dead end<br>
+ 5) After a turn, a T, a dead end or the goal, nothing more is reported until the line comes back<br>
+ * Decisions are made on distance, not time, so they do not depend on
+ * speed.  Each event carries a 0 to 100 confidence, the percentage of
+ * samples in the decision that agreed with it.
+ * @version   V1.0
+ * @author    Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ *
+<table>
+<caption id="Junction_types">Junction events</caption>
+<tr><th>Event       <th>Branches seen <th>Line straight ahead
+<tr><td>LEFTTURN    <td>left          <td>no
+<tr><td>RIGHTTURN   <td>right         <td>no
+<tr><td>LEFTBRANCH  <td>left          <td>yes
+<tr><td>RIGHTBRANCH <td>right         <td>yes
+<tr><td>TJUNCTION   <td>left and right<td>no
+<tr><td>CROSS       <td>left and right<td>yes
+<tr><td>DEADEND     <td>line lost for JUNCTION_DEADEND mm<td>-
+<tr><td>GOAL        <td>all black for JUNCTION_GOAL mm<td>-
+</table>
+ ******************************************************************************/
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef JUNCTION_H_
+#define JUNCTION_H_
+
+/**
+ * \brief what the robot has just driven over
+ */
+enum JunctionType{
+  NOJUNCTION,  /**< no event yet */
+  LEFTTURN,    /**< line turns left only */
+  RIGHTTURN,   /**< line turns right only */
+  LEFTBRANCH,  /**< branch to the left, line also continues straight */
+  RIGHTBRANCH, /**< branch to the right, line also continues straight */
+  TJUNCTION,   /**< branches left and right, no line straight ahead */
+  CROSS,       /**< branches left and right, line also continues straight */
+  DEADEND,     /**< line ends */
+  GOAL         /**< large black goal pad */
+};
+
+/**
+ * \brief distance in mm past the branch at which the center sensors decide if the line continues
+ */
+#define JUNCTION_LOOKAHEAD 10
+
+/**
+ * \brief distance in mm with no line before a dead end is reported
+ */
+#define JUNCTION_DEADEND 30
+
+/**
+ * \brief distance in mm with all sensors black before the goal is reported
+ */
+#define JUNCTION_GOAL 60
+
+/**
+ * \brief consecutive samples that must disagree to end a branch or a lost line
+ */
+#define JUNCTION_MISSES 3
+
+/**
+ * Reset the classifier.
+ * @param task user function called with each event (0 for none);
+ * it runs in the context of Junction_Sample(), usually an interrupt
+ * @return none
+ * @brief Initialize the junction classifier
+ */
+void Junction_Init(void(*task)(enum JunctionType type, uint32_t confidence));
+
+/**
+ * Classify one reflectance sample.
+ * @param data 8-bit result from the line sensor (white is 0, black is 1), bit 7 is the robot's left
+ * @param distance distance travelled in mm, from any fixed origin
+ * @return the event completed by this sample, or NOJUNCTION
+ * @note Typically called at 1 kHz from the task of ReflectanceInt_Init()
+ * @brief Classify one reflectance sample
+ */
+enum JunctionType Junction_Sample(uint8_t data, int32_t distance);
+
+/**
+ * Classify one reflectance sample, reading the distance travelled from
+ * the tachometer (average of both wheels, 360 steps per 220 mm).
+ * Pass this to ReflectanceInt_Init() to classify in the acquisition interrupt.
+ * @param data 8-bit result from the line sensor
+ * @return none
+ * @note Assumes Tachometer_Init() has been called
+ * @brief Classify one reflectance sample at the current tachometer distance
+ */
+void Junction_Task(uint8_t data);
+
+/**
+ * Return the most recent event.
+ * @param type pointer to return the kind of junction
+ * @param confidence pointer to return the confidence, 0 to 100
+ * @param distance pointer to return the distance in mm at which the junction began
+ * @return number of events so far, 0 if none
+ * @note Compare the result with the previous one to detect a new event
+ * @brief Get the latest junction event
+ */
+uint32_t Junction_Get(enum JunctionType *type, uint32_t *confidence, int32_t *distance);
+
+#endif /* JUNCTION_H_ */
@@ -0,0 +1,267 @@
+// Log.c
+// Runs on MSP432
+// Binary data log: timestamped, COBS-framed records sent over
+// UART0 from a ring buffer by the transmit interrupt.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+// UCA0TXD (VCP transmit) connected to P1.3
+// Frames are encoded straight into the ring as Log_Put() builds them,
+// so the interrupt only moves bytes from memory to TXBUF.
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Baud.h"
+#include "../inc/EUSCIA0.h"
+#include "../inc/Log.h"
+
+#define HEADER 6          // sequence, time and id
+#define MASK (LOG_FIFOSIZE-1)
+
+static uint8_t Buffer[LOG_FIFOSIZE];
+static volatile uint32_t PutI;   // index of where to put the next frame
+static volatile uint32_t GetI;   // index of the first byte not yet sent
+static uint32_t Block;           // bytes handed to the interrupt, from GetI
+static uint8_t Sequence;         // of the next frame
+static uint32_t Frames, Lost;
+
+// COBS encoder writing into the ring
+struct cobs{
+  uint32_t code;      // index of the code byte of the present block
+  uint32_t put;       // index of the next byte
+  uint8_t run;        // code byte value so far
+  uint8_t fcs;
+};
+
+static void encode(struct cobs *c, uint8_t data){
+  c->fcs = c->fcs^data;
+  if(data == 0){
+    Buffer[c->code&MASK] = c->run;  // block ends at the 0
+    c->code = c->put;
+    c->put = c->put + 1;
+    c->run = 1;
+    return;
+  }
+  Buffer[c->put&MASK] = data;
+  c->put = c->put + 1;
+  c->run = c->run + 1;
+  if(c->run == 0xFF){
+    Buffer[c->code&MASK] = c->run;  // 254 bytes without a 0
+    c->code = c->put;
+    c->put = c->put + 1;
+    c->run = 1;
+  }
+}
+
+// called by the EUSCI_A0 interrupt when it needs more to send
+static uint32_t source(const uint8_t **pt){
+  uint32_t get = GetI + Block;   // the last block has been sent
+  uint32_t size = PutI - get;
+  GetI = get;
+  if(size > LOG_FIFOSIZE - (get&MASK)){
+    size = LOG_FIFOSIZE - (get&MASK); // up to the end of the ring
+  }
+  *pt = &Buffer[get&MASK];
+  Block = size;
+  return size;
+}
+
+// ------------Log_Init------------
+// Initialize EUSCI_A0 and Timer32 Timer 2, and empty the log.
+// Timer 2 is left alone if it is already running.
+// Input: baud rate of the UART, up to 1,000,000
+// Output: none
+// Assumes: Clock_Init48MHz() has been called
+void Log_Init(uint32_t baud){
+  PutI = GetI = 0;
+  Block = 0;
+  Sequence = 0;
+  Frames = Lost = 0;
+  EUSCIA0_InitBaud(baud);
+  EUSCIA0_SetBlockSource(&source);
+  if(TIMER32_2->CONTROL&0x80){
+    return;                        // already running, AP times its timeouts with it
+  }
+  TIMER32_2->LOAD = 0xFFFFFFFF;    // count the full 32 bits
+  // bit7=1,           timer enable
+  // bit6=0,           free-running mode
+  // bit5=0,           interrupt disable
+  // bits3-2=01,       input clock divider /16, 3 MHz
+  // bit1=1,           32-bit counter
+  // bit0=0,           wrapping mode
+  TIMER32_2->CONTROL = 0x00000086;
+}
+
+// ------------Log_Put------------
+// Timestamp, encode and queue one frame, and return without waiting.
+// Input: id is a number chosen by the caller to tell frames apart
+//        data pointer to the bytes to send
+//        size number of bytes, 0 to LOG_MAXDATA
+// Output: LOGOK if queued, LOGFAIL if too long or if there is no room
+// Call from one interrupt or from main, not both.
+int Log_Put(uint8_t id, const void *data, uint32_t size){
+  const uint8_t *pt = data;
+  uint32_t time = ~TIMER32_2->VALUE;  // counts down
+  uint8_t sequence = Sequence;
+  struct cobs c;
+  uint32_t i;
+  if(size > LOG_MAXDATA){
+    return LOGFAIL;
+  }
+  Sequence = sequence + 1;       // a dropped frame leaves a gap
+  // code byte, frame and 0; no block of a short frame reaches 254 bytes
+  if(LOG_FIFOSIZE - (PutI - GetI) < 1 + HEADER + size + 1 + 1){
+    Lost = Lost + 1;
+    return LOGFAIL;
+  }
+  c.code = PutI;
+  c.put = c.code + 1;
+  c.run = 1;
+  c.fcs = 0;
+  encode(&c, sequence);
+  encode(&c, time);
+  encode(&c, time>>8);
+  encode(&c, time>>16);
+  encode(&c, time>>24);
+  encode(&c, id);
+  for(i=0; i<size; i=i+1){
+    encode(&c, pt[i]);
+  }
+  encode(&c, c.fcs);             // exclusive or of the frame is then 0
+  Buffer[c.code&MASK] = c.run;
+  Buffer[c.put&MASK] = 0;        // end of frame
+  PutI = c.put + 1;              // publish the whole frame at once
+  Frames = Frames + 1;
+  EUSCIA0_OutBlocks();
+  return LOGOK;
+}
+
+// ------------Log_Stats------------
+// Return counts of the frames since Log_Init().
+// Input: frames pointer to return the number of frames queued
+//        lost pointer to return the number of frames dropped for lack of room
+// Output: none
+void Log_Stats(uint32_t *frames, uint32_t *lost){
+  *frames = Frames;
+  *lost = Lost;
+}
+
+// ------------Log_DecodeInit------------
+// Prepare to decode a log stream.
+// Input: d pointer to the receiver state
+// Output: none
+void Log_DecodeInit(struct LogDecoder *d){
+  d->size = 0;
+  d->left = 0;
+  d->code = 0xFF;                // no 0 before the first block
+  d->sequence = 0;
+  d->synced = 0;
+  d->bad = 0;
+}
+
+static void store(struct LogDecoder *d, uint8_t data){
+  if(d->size < sizeof(d->frame)){
+    d->frame[d->size] = data;
+  }
+  if(d->size <= sizeof(d->frame)){
+    d->size = d->size + 1;       // stops at one more than fits
+  }
+}
+
+// a 0 ended the frame, return 1 if it was good
+static uint32_t finish(struct LogDecoder *d,
+  void(*frame)(uint32_t time, uint8_t id, const uint8_t *data, uint32_t size, uint32_t lost)){
+  const uint8_t *f = d->frame;
+  uint32_t i, lost;
+  uint8_t fcs = 0;
+  if(d->size == 0){
+    return 0;                    // two 0s in a row, or the first 0 seen
+  }
+  if((d->left != 0) || (d->size < HEADER + 1) || (d->size > sizeof(d->frame))){
+    d->bad = d->bad + 1;
+    return 0;
+  }
+  for(i=0; i<d->size; i=i+1){
+    fcs = fcs^f[i];
+  }
+  if(fcs){
+    d->bad = d->bad + 1;
+    return 0;
+  }
+  lost = d->synced? (uint8_t)(f[0] - d->sequence) : 0;
+  d->sequence = (uint8_t)(f[0] + 1);
+  d->synced = 1;
+  if(frame){
+    (*frame)(f[1]|(f[2]<<8)|(f[3]<<16)|((uint32_t)f[4]<<24), f[5],
+             &f[HEADER], d->size - HEADER - 1, lost);
+  }
+  return 1;
+}
+
+// ------------Log_Decode------------
+// Decode bytes received from the log, in pieces of any size.
+// Input: d pointer to the receiver state
+//        data pointer to the bytes
+//        length number of bytes
+//        frame user function called with each good frame
+// Output: number of good frames
+uint32_t Log_Decode(struct LogDecoder *d, const uint8_t *data, uint32_t length,
+  void(*frame)(uint32_t time, uint8_t id, const uint8_t *data, uint32_t size, uint32_t lost)){
+  uint32_t i, count = 0;
+  for(i=0; i<length; i=i+1){
+    if(data[i] == 0){
+      count = count + finish(d, frame);
+      d->size = 0;
+      d->left = 0;
+      d->code = 0xFF;
+    }else if(d->left == 0){      // code byte
+      if(d->code != 0xFF){
+        store(d, 0);             // the block before ended at a 0
+      }
+      d->code = data[i];
+      d->left = data[i] - 1;
+    }else{
+      store(d, data[i]);
+      d->left = d->left - 1;
+    }
+  }
+  return count;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file      Log.h
+ * @brief     Binary, framed data log over the UART0 (VCP) port
+ * @details   Each call to Log_Put() becomes one frame holding a sequence
+ * number, a 32-bit timestamp, an id chosen by the caller and up to
+ * LOG_MAXDATA bytes of data.  Frames are COBS encoded, so the only 0
+ * byte on the line is the one that ends each frame, and a receiver
+ * that starts in the middle of the stream is in step after the next 0.
+ * The encoded frames wait in a ring buffer, which the EUSCI_A0
+ * transmit interrupt sends without a copy.<br>
+ 1) Log_Put() never waits; if the ring is full the frame is dropped,
+    and the receiver sees the gap in the sequence numbers<br>
+ 2) The timestamp is Timer32 Timer 2, free running at 3 MHz, so it
+    wraps every 1431 seconds<br>
+ 3) The line carries baud/10 bytes/s, so a frame of n data bytes can
+    be sent at most baud/(10*(n+9)) times a second: 1280 times a second
+    at 115,200 baud, 11,111 times at 1,000,000 baud, for n = 0<br>
+ * @version   V1.0
+ * @author    Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ *
+<table>
+<caption id="Log_format">Frame before COBS encoding</caption>
+<tr><th>Byte    <th>Meaning
+<tr><td>0       <td>sequence number, modulo 256
+<tr><td>1-4     <td>time in 1/3 us, least significant byte first
+<tr><td>5       <td>id
+<tr><td>6-      <td>data, 0 to LOG_MAXDATA bytes
+<tr><td>last    <td>FCS, exclusive or of all the bytes before it
+</table>
+ ******************************************************************************/
+
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef LOG_H_
+#define LOG_H_
+
+/**
+ * \brief most data bytes in one frame
+ */
+#define LOG_MAXDATA 64
+
+/**
+ * \brief bytes of encoded frames waiting to be sent (must be a power of 2)
+ */
+#define LOG_FIFOSIZE 1024
+
+/**
+ * \brief return value on success
+ */
+#define LOGOK   1
+
+/**
+ * \brief return value on failure
+ */
+#define LOGFAIL 0
+
+/**
+ * \brief receiver state for Log_Decode()
+ */
+struct LogDecoder{
+  uint32_t size;       /**< bytes of the frame decoded so far, more than fits if too long */
+  uint32_t left;       /**< bytes left in the COBS block being decoded */
+  uint32_t code;       /**< code byte of the COBS block being decoded */
+  uint32_t sequence;   /**< sequence number expected next */
+  uint32_t synced;     /**< 1 once a frame has been received */
+  uint32_t bad;        /**< frames discarded for a bad length or FCS */
+  uint8_t frame[LOG_MAXDATA+7]; /**< frame being decoded */
+};
+
+/**
+ * Initialize EUSCI_A0 and Timer32 Timer 2, and empty the log.
+ * Timer 2 keeps counting if AP_Init() has already started it.
+ * Text sent with the other EUSCIA0 functions goes out between frames
+ * and would confuse the receiver, so use only Log_Put() while logging.
+ * @param baud rate of the UART, such as 115200 or 1000000
+ * @return none
+ * @note Assumes Clock_Init48MHz() has been called
+ * @brief Initialize the data log
+ */
+void Log_Init(uint32_t baud);
+
+/**
+ * Timestamp, encode and queue one frame, and return without waiting.
+ * @param id is a number chosen by the caller to tell frames apart
+ * @param data pointer to the bytes to send
+ * @param size number of bytes, 0 to LOG_MAXDATA
+ * @return LOGOK if queued, LOGFAIL if too long or if there is no room
+ * @note May be called from an interrupt, but from only one interrupt or
+ * from main, not both
+ * @brief Log one frame
+ */
+int Log_Put(uint8_t id, const void *data, uint32_t size);
+
+/**
+ * Return counts of the frames since Log_Init().
+ * @param frames pointer to return the number of frames queued
+ * @param lost pointer to return the number of frames dropped for lack of room
+ * @return none
+ * @brief Get log statistics
+ */
+void Log_Stats(uint32_t *frames, uint32_t *lost);
+
+/**
+ * Prepare to decode a log stream.  Does not use the hardware,
+ * so it also runs on a PC.
+ * @param d pointer to the receiver state
+ * @return none
+ * @brief Initialize a log decoder
+ */
+void Log_DecodeInit(struct LogDecoder *d);
+
+/**
+ * Decode bytes received from the log, in pieces of any size.
+ * @param d pointer to the receiver state
+ * @param data pointer to the bytes
+ * @param length number of bytes
+ * @param frame user function called with each good frame: its time in
+ * 1/3 us, id, data, size of the data, and the number of frames lost
+ * just before it
+ * @return number of good frames
+ * @brief Decode a log stream
+ */
+uint32_t Log_Decode(struct LogDecoder *d, const uint8_t *data, uint32_t length,
+  void(*frame)(uint32_t time, uint8_t id, const uint8_t *data, uint32_t size, uint32_t lost));
+
+#endif /* LOG_H_ */
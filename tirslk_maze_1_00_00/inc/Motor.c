@@ -67,10 +67,20 @@ policies, either expressed or implied, of the FreeBSD Project.
 // The motors are initially stopped, the drivers
 // are initially powered down. PWM Speed control
 // IS initialized with duty cycles set to 0.
+// Every Motor function returns right away; the
+// PWM keeps running in Timer A0 until the next call.
 // Input: none
 // Output: none
 void Motor_Init(void){
-  // write this as part of Lab 07 when directed
+  P5->SEL0 &= ~0x30;
+  P5->SEL1 &= ~0x30;              // configure P5.4, P5.5 as GPIO
+  P5->OUT &= ~0x30;               // direction forward
+  P5->DIR |= 0x30;                // make P5.4, P5.5 out
+  P3->SEL0 &= ~0xC0;
+  P3->SEL1 &= ~0xC0;              // configure P3.6, P3.7 as GPIO
+  P3->OUT &= ~0xC0;               // drivers asleep
+  P3->DIR |= 0xC0;                // make P3.6, P3.7 out
+  PWM_Init34(15000, 0, 0);        // 10 ms period on P2.6, P2.7, both 0%
 }
 
 // ------------Motor_Stop------------
@@ -79,7 +89,9 @@ void Motor_Init(void){
 // Input: none
 // Output: none
 void Motor_Stop(void){
-  // write this as part of Lab 07 when directed
+  PWM_Duty3(0);
+  PWM_Duty4(0);
+  P3->OUT &= ~0xC0;               // drivers asleep
 }
 
 // ------------Motor_Forward------------
@@ -91,7 +103,10 @@ void Motor_Stop(void){
 // Output: none
 // Assumes: Motor_Init() has been called
 void Motor_Forward(uint16_t leftDuty, uint16_t rightDuty){ 
-  // write this as part of Lab 07 when directed
+  PWM_Duty4(leftDuty);
+  PWM_Duty3(rightDuty);
+  P5->OUT &= ~0x30;               // left forward, right forward
+  P3->OUT |= 0xC0;                // drivers awake
 }
 
 // ------------Motor_Right------------
@@ -103,8 +118,10 @@ void Motor_Forward(uint16_t leftDuty, uint16_t rightDuty){
 // Output: none
 // Assumes: Motor_Init() has been called
 void Motor_Right(uint16_t leftDuty, uint16_t rightDuty){ 
-  // write this as part of Lab 07, when directed....
-
+  PWM_Duty4(leftDuty);
+  PWM_Duty3(rightDuty);
+  P5->OUT = (P5->OUT&~0x30)|0x20; // left forward, right backward
+  P3->OUT |= 0xC0;                // drivers awake
 }
 
 // ------------Motor_Left------------
@@ -116,9 +133,10 @@ void Motor_Right(uint16_t leftDuty, uint16_t rightDuty){
 // Output: none
 // Assumes: Motor_Init() has been called
 void Motor_Left(uint16_t leftDuty, uint16_t rightDuty){ 
-    // write this as part of Lab 07, when directed....
-
-
+  PWM_Duty4(leftDuty);
+  PWM_Duty3(rightDuty);
+  P5->OUT = (P5->OUT&~0x30)|0x10; // left backward, right forward
+  P3->OUT |= 0xC0;                // drivers awake
 }
 
 // ------------Motor_Backward------------
@@ -130,6 +148,8 @@ void Motor_Left(uint16_t leftDuty, uint16_t rightDuty){
 // Output: none
 // Assumes: Motor_Init() has been called
 void Motor_Backward(uint16_t leftDuty, uint16_t rightDuty){ 
-    // write this as part of Lab 07, when directed....
-
+  PWM_Duty4(leftDuty);
+  PWM_Duty3(rightDuty);
+  P5->OUT |= 0x30;                // left backward, right backward
+  P3->OUT |= 0xC0;                // drivers awake
 }
@@ -73,7 +73,10 @@ policies, either expressed or implied, of the FreeBSD Project.
  * to enable or disable the drivers.
  * The motors are initially stopped, the drivers
  * are initially powered down, and the PWM speed
- * control is uninitialized.
+ * control is initialized with 0% duty cycle
+ * on Timer A0 (period 10 ms).
+ * All motor functions return right away; the
+ * PWM runs in hardware until the next call.
  * @param none
  * @return none
  * @brief  Initialize motor interface
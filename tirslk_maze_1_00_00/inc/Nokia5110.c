@@ -78,19 +78,28 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include "msp.h"
 #include "Nokia5110.h"
+#include "../inc/Format.h"
 
 // *************************** Screen dimensions ***************************
 #define SCREENW     84
 #define SCREENH     48
-// The regular 8-bit access for P9OUT  is 0x40004C82.
-// For bit-banding of bit 6 of P9OUT, n=0x4C82 and b=6.
-//    0x42000000 + 32*4C82 + 4*6 = 0x42099040+0x18 = 0x42099058
-// For bit-banding of bit 3 of P9OUT, n=0x4C82 and b=3.
-//    0x42000000 + 32*4C82 + 4*3 = 0x42099040+0x0C = 0x4209904C
-#define DC          (*((volatile uint8_t *)0x42099058))   /* Port 9 Output, bit 6 is DC*/
-#define RESET       (*((volatile uint8_t *)0x4209904C))   /* Port 9 Output, bit 3 is RESET*/
+// P9.6 is DC and P9.3 is RESET.  Only the main program writes
+// P9OUT, so a read-modify-write is safe without bit-banding.
 #define DC_BIT 0x40
 #define RESET_BIT 0x08
+#define SCREENSIZE (SCREENW*SCREENH/8)
+#define BANKS (SCREENH/8)   // 8-pixel rows, one byte per column
+// a flush resends this many unchanged bytes to join two spans
+// rather than send two address commands between them
+#define MERGEGAP 2
+// DMA channel 6, source 1 is UCA3TXIFG.  Each request moves one
+// byte into TXBUF, so a block goes out back to back while the CPU
+// runs, and the channel disables itself after the last byte.
+#define DMACHANNEL 6
+#define DMABIT (1u<<DMACHANNEL)
+// byte source incrementing to the fixed TXBUF, one byte per
+// request, basic mode
+#define DMACONTROL 0xC0000001
 //#define P9DIR                   (*((volatile uint8_t *)0x40004C84))   /* Port 9 Direction */
 //#define P9SEL0                  (*((volatile uint8_t *)0x40004C8A))   /* Port 9 Select 0 */
 //#define P9SEL1                  (*((volatile uint8_t *)0x40004C8C))   /* Port 9 Select 1 */
@@ -206,32 +215,120 @@ static const uint8_t ASCII[][5] = {
 };
 
 
+// uDMA channel control structure; the controller finds the
+// structure of channel n at CTLBASE + n*sizeof, so the table is
+// aligned to its full 256-byte size.  This driver is the only
+// user of the DMA controller.
+struct dmacontrol{
+  const volatile void *srcEnd;     // address of the last source byte
+  volatile void *dstEnd;           // address of the last destination byte
+  uint32_t control;
+  uint32_t spare;
+};
+#ifdef __TI_COMPILER_VERSION__
+#pragma DATA_ALIGN(DmaTable, 256)
+static struct dmacontrol DmaTable[8];
+#else
+static struct dmacontrol DmaTable[8] __attribute__((aligned(256)));
+#endif
+
+// Shown holds what the LCD RAM holds, in the same order, and is
+// the source of every DMA block.  Drawing into Screen marks a
+// column range of each bank dirty; Nokia5110_DisplayBuffer()
+// compares only those ranges with Shown and sends what differs.
+// LcdX and LcdY follow the LCD address, so no address command is
+// sent when the LCD is already there.
+static uint8_t Shown[SCREENSIZE];
+static uint8_t DirtyFirst[BANKS], DirtyLast[BANKS];   // clean if first > last
+static uint8_t LcdX, LcdY;
+
+// wait for the DMA channel to finish its block
+static void dmawait(void){
+  while(DMA_Control->ENASET&DMABIT){};
+}
+
+// mark columns first to last of a bank as possibly different from the LCD
+static void dirty(uint32_t bank, uint32_t first, uint32_t last){
+  if(first < DirtyFirst[bank]) DirtyFirst[bank] = first;
+  if(last > DirtyLast[bank]) DirtyLast[bank] = last;
+}
+
+// mark count bytes of LCD RAM from address at, wrapping like the LCD
+static void overwritten(uint32_t at, uint32_t count){
+  uint32_t x, span;
+  while(count){
+    at = at%SCREENSIZE;
+    x = at%SCREENW;
+    span = SCREENW - x;
+    if(span > count) span = count;
+    dirty(at/SCREENW, x, x + span - 1);
+    at = at + span;
+    count = count - span;
+  }
+}
+
 // This is a helper function that sends 8-bit commands to the LCD.
 // Inputs: command  8-bit function code to transmit
 // Outputs: none
 // Assumes: UCA3 and Port 9 have already been initialized and enabled
 // The Data/Command pin must be valid when the eighth bit is
 // sent.  The eUSCI module has no hardware FIFOs.
-// 1) Wait for SPI to be idle (let previous frame finish)
+// 1) Wait for DMA and SPI to be idle (let previous frame finish)
 // 2) Set DC for command (0)
 // 3) Write command to TXBUF, starts SPI
 // 4) Wait for SPI to be idle (after transmission complete)
 void static lcdcommandwrite(uint8_t command){
-// write this code as part of Lab 11
-
+  dmawait();
+  while(EUSCI_A3->STATW&0x0001){};      // wait for UCBUSY to clear
+  P9->OUT &= ~DC_BIT;                   // DC low for command
+  EUSCI_A3->TXBUF = command;
+  while(EUSCI_A3->STATW&0x0001){};
 }
-// This is a helper function that sends 8-bit data to the LCD.
-// Inputs: data  8-bit data to transmit
+// This is a helper function that moves the LCD address,
+// sending only the commands for the coordinates that change.
+// Inputs: x  column (0<=x<=83)
+//         y  bank (0<=y<=5)
 // Outputs: none
-// Assumes: UCA3 and Port 9 have already been initialized and enabled
-// The Data/Command pin must be valid when the eighth bit is
-// sent.  The eUSCI module has no hardware FIFOs.
-// 1) Wait for transmitter to be empty (let previous frame finish)
-// 2) Set DC for data (1)
-// 3) Write data to TXBUF, starts SPI
-void static lcddatawrite(uint8_t data){
-// write this code as part of Lab 11
-
+void static lcdaddress(uint8_t x, uint8_t y){
+  if(x != LcdX){
+    lcdcommandwrite(0x80|x);            // setting bit 7 updates X-position
+    LcdX = x;
+  }
+  if(y != LcdY){
+    lcdcommandwrite(0x40|y);            // setting bit 6 updates Y-position
+    LcdY = y;
+  }
+}
+// This is a helper function that starts sending a block of
+// Shown to the LCD with DMA, and returns right away.
+// Inputs: at     index in Shown of the first byte, which is the LCD address
+//         count  number of bytes, 1 to 504; wraps to the start of Shown like the LCD
+// Outputs: none
+// Assumes: UCA3, Port 9 and the DMA have already been initialized and enabled
+// 1) Wait for the previous block and for room in TXBUF
+// 2) Set DC for data (1); any byte still shifting out is data too
+// 3) Point the channel at the block and enable it
+// 4) A rising UCTXIFG requests the first byte
+void static lcddatablock(uint32_t at, uint32_t count){
+  uint32_t n = count;
+  if(at + n > SCREENSIZE){
+    n = SCREENSIZE - at;                // the rest follows from address 0
+  }
+  dmawait();
+  while((EUSCI_A3->IFG&0x0002) == 0){}; // wait for TXBUF empty
+  P9->OUT |= DC_BIT;                    // DC high for data
+  DmaTable[DMACHANNEL].srcEnd = &Shown[at + n - 1];
+  DmaTable[DMACHANNEL].dstEnd = &EUSCI_A3->TXBUF;
+  DmaTable[DMACHANNEL].control = DMACONTROL|((n - 1)<<4);
+  EUSCI_A3->IFG &= ~0x0002;
+  DMA_Control->ENASET = DMABIT;
+  EUSCI_A3->IFG |= 0x0002;
+  at = (at + n)%SCREENSIZE;
+  LcdX = at%SCREENW;
+  LcdY = at/SCREENW;
+  if(n < count){
+    lcddatablock(0, count - n);
+  }
 }
 
 //********Nokia5110_Init*****************
@@ -274,11 +371,15 @@ void Nokia5110_Init(void){
   P9->SEL1 &= ~(DC_BIT|RESET_BIT);      // configure P9.3 and P9.6 as GPIO (Reset and D/C pins)
   P9->DIR |= (DC_BIT|RESET_BIT);        // make P9.3 and P9.6 out (Reset and D/C pins)
   EUSCI_A3->CTLW0 &= ~0x0001;           // enable eUSCI module
-  EUSCI_A3->IE &= ~0x0003;              // disable interrupts
+  EUSCI_A3->IE &= ~0x0003;              // disable interrupts, the DMA feeds TXBUF
+  DMA_Control->CFG = 0x01;              // enable the DMA controller
+  DMA_Control->CTLBASE = (uintptr_t)DmaTable;
+  DMA_Control->ENACLR = DMABIT;
+  DMA_Channel->CH_SRCCFG[DMACHANNEL] = 1;  // channel 6 triggered by UCA3TXIFG
 
-  RESET = 0;                            // reset the LCD to a known state, RESET low
+  P9->OUT &= ~RESET_BIT;                // reset the LCD to a known state, RESET low
   for(delay=0; delay<10; delay=delay+1);// delay minimum 100 ns
-  RESET = 1;                            // hold RESET high
+  P9->OUT |= RESET_BIT;                 // hold RESET high
 
   lcdcommandwrite(0x21);                // chip active; horizontal addressing mode (V = 0); use extended instruction set (H = 1)
                                         // set LCD Vop (contrast), which may require some tweaking:
@@ -288,6 +389,8 @@ void Nokia5110_Init(void){
 
   lcdcommandwrite(0x20);                // we must send 0x20 before modifying the display control mode
   lcdcommandwrite(0x0C);                // set display control to normal mode: 0x0D for inverse
+  LcdX = LcdY = 0;                      // address after reset
+  Nokia5110_Clear();                    // LCD RAM is random after reset; now it matches Shown
 }
 
 //********Nokia5110_OutChar*****************
@@ -302,12 +405,11 @@ void Nokia5110_Init(void){
 // Inputs: data  character to print
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
-void Nokia5110_OutChar(char data){int i;
-  lcddatawrite(0x00);        // blank vertical line padding
-  for(i=0; i<5; i=i+1){
-    lcddatawrite(ASCII[data - 0x20][i]);
-  }
-  lcddatawrite(0x00);        // blank vertical line padding
+void Nokia5110_OutChar(char data){
+  char string[2];
+  string[0] = data;
+  string[1] = 0;
+  Nokia5110_OutString(string);
 }
 
 //********Nokia5110_OutString*****************
@@ -317,9 +419,27 @@ void Nokia5110_OutChar(char data){int i;
 // Inputs: ptr  pointer to NULL-terminated ASCII string
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
+// Up to 12 characters, one row, are sent as one DMA block.
+// The columns they cover are marked dirty, so the next
+// Nokia5110_DisplayBuffer() puts back the buffer there.
 void Nokia5110_OutString(char *ptr){
-// write this code as part of Lab 11
-
+  uint32_t i, at, n;
+  while(*ptr){
+    dmawait();                      // Shown is free again
+    at = SCREENW*LcdY + LcdX;
+    n = 0;
+    while(*ptr && (n < SCREENW)){
+      Shown[(at + n)%SCREENSIZE] = 0x00;       // blank vertical line padding
+      for(i=0; i<5; i=i+1){
+        Shown[(at + n + 1 + i)%SCREENSIZE] = ASCII[*ptr - 0x20][i];
+      }
+      Shown[(at + n + 6)%SCREENSIZE] = 0x00;   // blank vertical line padding
+      n = n + 7;
+      ptr = ptr + 1;
+    }
+    overwritten(at, n);
+    lcddatablock(at, n);
+  }
 }
 
 //********Nokia5110_OutUDec*****************
@@ -329,8 +449,9 @@ void Nokia5110_OutString(char *ptr){
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_OutUDec(uint16_t n){
-// write this code as part of Lab 11
-
+  char message[FORMAT_SIZE];
+  Format_UDec(message, n, 5);
+  Nokia5110_OutString(message);
 }
 
 //********Nokia5110_OutSDec*****************
@@ -340,8 +461,9 @@ void Nokia5110_OutUDec(uint16_t n){
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_OutSDec(int16_t n){
-// write this code as part of Lab 11
-
+  char message[FORMAT_SIZE];
+  Format_SDec(message, n, 6);
+  Nokia5110_OutString(message);
 }
 
 //********Nokia5110_OutUFix1*****************
@@ -350,19 +472,9 @@ void Nokia5110_OutSDec(int16_t n){
 // Inputs: n  16-bit unsigned number
 // Outputs: none
 void Nokia5110_OutUFix1(uint16_t n){
-  char message[5];
+  char message[FORMAT_SIZE];
   if(n>999)n=999;
-  if(n>=100){  // 100 to 999
-    message[0] = (n/100+'0'); /* tens digit */
-    n = n%100; //the rest
-  }else { // 0 to 99
-    message[0] = ' '; /* n is between 0.0 and 9.9 */
-  }
-  message[1] = (n/10+'0'); /* ones digit */
-  n = n%10; //the rest
-  message[2] = '.';
-  message[3] = (n+'0'); /* tenths digit */
-  message[4] = 0;
+  Format_UFix(message, n, 1, 4);   // " 0.0" to "99.9"
   Nokia5110_OutString(message);
 }
 
@@ -378,36 +490,46 @@ void Nokia5110_SetCursor(uint8_t newX, uint8_t newY){
     return;                             // do nothing
   }
   // multiply newX by 7 because each character is 7 columns wide
-  lcdcommandwrite(0x80|(newX*7));       // setting bit 7 updates X-position
-  lcdcommandwrite(0x40|newY);           // setting bit 6 updates Y-position
+  lcdaddress(newX*7, newY);
 }
 
 //********Nokia5110_Clear*****************
 // Clear the LCD by writing zeros to the entire screen and
 // reset the cursor to (0,0) (top left corner of screen).
+// The DMA sends the zeros; the address wraps back to (0,0)
+// after the last one.
 // Inputs: none
 // Outputs: none
 void Nokia5110_Clear(void){
-  int i;
-  for(i=0; i<(MAX_X*MAX_Y/8); i=i+1){
-    lcddatawrite(0x00);
-  }
-  Nokia5110_SetCursor(0, 0);
+  Nokia5110_DrawFullImage(0);
 }
 
 //********Nokia5110_DrawFullImage*****************
 // Fill the whole screen by drawing a 48x84 bitmap image.
-// Inputs: ptr  pointer to 504 byte bitmap
+// The image is copied, and returns once the DMA has started;
+// it goes out in the background in about 1 ms at 4 MHz.
+// Inputs: ptr  pointer to 504 byte bitmap, 0 for a blank screen
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_DrawFullImage(const uint8_t *ptr){
-  int i;
-  Nokia5110_SetCursor(0, 0);
-  for(i=0; i<(MAX_X*MAX_Y/8); i=i+1){
-    lcddatawrite(ptr[i]);
+  uint32_t i;
+  dmawait();                        // Shown is free again
+  for(i=0; i<SCREENSIZE; i=i+1){
+    Shown[i] = ptr? ptr[i] : 0;
   }
+  overwritten(0, SCREENSIZE);
+  lcdaddress(0, 0);
+  lcddatablock(0, SCREENSIZE);
+}
+
+//********Nokia5110_Busy*****************
+// Check if the DMA or the SPI is still sending to the LCD.
+// Inputs: none
+// Outputs: 1 if busy, 0 if the last byte is out
+int Nokia5110_Busy(void){
+  return ((DMA_Control->ENASET&DMABIT) != 0) || ((EUSCI_A3->STATW&0x0001) != 0);
 }
-uint8_t Screen[SCREENW*SCREENH/8]; // buffer stores the next image to be printed on the screen
+uint8_t Screen[SCREENSIZE]; // buffer stores the next image to be printed on the screen
 
 //********Nokia5110_PrintBMP*****************
 // Bitmaps defined above were created for the LM3S1968 or
@@ -440,9 +562,12 @@ void Nokia5110_PrintBMP(uint8_t xpos, uint8_t ypos, const uint8_t *ptr, uint8_t
      ((width%2) != 0) ||           // must be even number of columns
      ((xpos + width) > SCREENW) || // right side cut off
      (ypos < (height - 1)) ||      // top cut off
-     (ypos > SCREENH))           { // bottom cut off
+     (ypos >= SCREENH))          { // bottom cut off
     return;
   }
+  for(i=(ypos - height + 1)/8; i<=ypos/8; i=i+1){
+    dirty(i, xpos, xpos + width - 1);
+  }
   if(threshold > 14){
     threshold = 14;             // only full 'on' turns pixel on
   }
@@ -496,16 +621,60 @@ void Nokia5110_ClearBuffer(void){int i;
   for(i=0; i<SCREENW*SCREENH/8; i=i+1){
     Screen[i] = 0;              // clear buffer
   }
+  for(i=0; i<BANKS; i=i+1){
+    dirty(i, 0, SCREENW - 1);
+  }
 }
 
 //********Nokia5110_DisplayBuffer*****************
-// Fill the whole screen by drawing a 48x84 screen image
-// from the RAM buffer.
+// Make the screen show the RAM buffer by sending the bytes
+// that changed since the last call.  In each bank the dirty
+// columns are trimmed to the ones that differ from the LCD,
+// and spans no more than MERGEGAP bytes apart go out as one
+// DMA block, so changing one digit sends about five bytes.
+// Returns once the DMA has started the last block.
 // Inputs: none
 // Outputs: none
 // Assumes: LCD is in default horizontal addressing mode (V = 0)
 void Nokia5110_DisplayBuffer(void){
-  Nokia5110_DrawFullImage(Screen);
+  uint32_t y, first, last, i;
+  uint32_t start = SCREENSIZE, end = 0;  // block being built is Shown[start] to Shown[end-1]
+  dmawait();                        // Shown is free again
+  for(y=0; y<BANKS; y=y+1){
+    if(DirtyFirst[y] > DirtyLast[y]){
+      continue;                     // clean
+    }
+    first = SCREENW*y + DirtyFirst[y];
+    last = SCREENW*y + DirtyLast[y];
+    DirtyFirst[y] = SCREENW;
+    DirtyLast[y] = 0;
+    while((first <= last) && (Screen[first] == Shown[first])){
+      first = first + 1;
+    }
+    if(first > last){
+      continue;                     // redrawn the same
+    }
+    while(Screen[last] == Shown[last]){
+      last = last - 1;
+    }
+    for(i=first; i<=last; i=i+1){
+      Shown[i] = Screen[i];
+    }
+    if(start < SCREENSIZE){
+      if(first <= end + MERGEGAP){
+        end = last + 1;             // join the block
+        continue;
+      }
+      lcdaddress(start%SCREENW, start/SCREENW);
+      lcddatablock(start, end - start);
+    }
+    start = first;
+    end = last + 1;
+  }
+  if(start < SCREENSIZE){
+    lcdaddress(start%SCREENW, start/SCREENW);
+    lcddatablock(start, end - start);
+  }
 }
 
 const unsigned char Masks[8]={0x01,0x02,0x04,0x08,0x10,0x20,0x40,0x80};
@@ -517,6 +686,7 @@ const unsigned char Masks[8]={0x01,0x02,0x04,0x08,0x10,0x20,0x40,0x80};
 // Output: none
 void Nokia5110_ClrPxl(uint32_t i, uint32_t j){
   Screen[84*(i>>3) + j] &= ~Masks[i&0x07];
+  dirty(i>>3, j, j);
 }
 
 //------------Nokia5110_SetPxl------------
@@ -527,5 +697,6 @@ void Nokia5110_ClrPxl(uint32_t i, uint32_t j){
 // Output: none
 void Nokia5110_SetPxl(uint32_t i, uint32_t j){
   Screen[84*(i>>3) + j] |= Masks[i&0x07];
+  dirty(i>>3, j, j);
 }
 
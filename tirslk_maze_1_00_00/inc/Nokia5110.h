@@ -128,10 +128,13 @@ policies, either expressed or implied, of the FreeBSD Project.
  * see <b>Clock.c</b>) or from the low-speed subsystem master
  * clock (SMCLK <= 12 MHz see <b>Clock.c</b>).  The SSI can
  * further divide this clock signal by using the 16-bit Bit
- * Rate Control prescaler Register, UCAxBRW.
+ * Rate Control prescaler Register, UCAxBRW.  Data goes to
+ * the LCD through DMA channel 6, triggered by UCA3TXIFG.
+ * The LCD is cleared, since its RAM is random after reset.
  * @param none
  * @return none
  * @note  Assumes low-speed subsystem master clock is 12 MHz
+ * @note  This driver is the only user of the DMA controller
  * @see Nokia5110_OutChar(), Nokia5110_Clear(), Nokia5110_PrintBMP()
  * @brief  Initialize LCD driver
  */
@@ -216,6 +219,7 @@ void Nokia5110_SetCursor(uint8_t newX, uint8_t newY);
 /**
  * Clear the LCD by writing zeros to the entire screen and
  * reset the cursor to (0,0) (top left corner of screen).
+ * Returns once the DMA has started.
  * @param none
  * @return none
  * @see Nokia5110_Init(), Nokia5110_OutChar(), Nokia5110_SetCursor()
@@ -225,7 +229,9 @@ void Nokia5110_Clear(void);
 
 /**
  * Fill the whole screen by drawing a 48x84 bitmap image.
- * @param ptr  pointer to 504 byte bitmap
+ * The bitmap is copied, and the call returns once the DMA has
+ * started; the 504 bytes go out in about 1 ms while the CPU runs.
+ * @param ptr  pointer to 504 byte bitmap, or 0 for a blank screen
  * @return none
  * @note  LCD is in default horizontal addressing mode (V = 0)
  * @see Nokia5110_Init(), Nokia5110_OutChar(), Nokia5110_Clear()
@@ -272,16 +278,34 @@ void Nokia5110_PrintBMP(uint8_t xpos, uint8_t ypos, const uint8_t *ptr, uint8_t
 void Nokia5110_ClearBuffer(void);
 
 /**
- * Fill the whole screen by drawing a 48x84 screen image
- * from the RAM buffer.
+ * Make the screen show the internal screen buffer.  Only the
+ * bytes that changed since the last call are sent: the
+ * drawing functions mark the columns of each 8-row bank they
+ * touch, and those columns are compared with what the LCD
+ * holds.  Text printed with Nokia5110_OutString() or an image
+ * drawn with Nokia5110_DrawFullImage() is replaced by the
+ * buffer where they differ.  Returns once the DMA has started;
+ * the buffer may be drawn into right away.
  * @param none
  * @return none
  * @note  LCD is in default horizontal addressing mode (V = 0)
+ * @note  Write the buffer only with the functions in this file
  * @see Nokia5110_PrintBMP(), Nokia5110_ClearBuffer(), Nokia5110_SetPxl()
  * @brief  Draw internal screen buffer to the display.
  */
 void Nokia5110_DisplayBuffer(void);
 
+/**
+ * Check if the DMA or the SPI is still sending to the LCD.
+ * The other functions wait on their own, so this is only
+ * needed before changing an image that is being sent.
+ * @param none
+ * @return 1 if busy, 0 if the last byte is out
+ * @see Nokia5110_DrawFullImage(), Nokia5110_DisplayBuffer()
+ * @brief  Check if the LCD transfer is done
+ */
+int Nokia5110_Busy(void);
+
 /**
  * Clear the internal screen buffer pixel at (i, j),
  * turning it off.
@@ -0,0 +1,190 @@
+// Odometry.c
+// Runs on MSP432
+// Fixed-point dead reckoning of x, y and heading from the
+// tachometer step counts.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+// Units inside this file
+//   distance: half steps, the sum of the two wheel step counts;
+//             one half step is 220/720 mm
+//   x, y:     64-bit half steps times 32768 (sine table scale)
+//   heading:  32-bit binary angle, 2^32 is one turn, wraps for free
+// One step of difference between the wheels turns the robot by
+// (220/360 mm)/ODOMETRY_TRACK radians, 2^32*220/(720*pi)/ODOMETRY_TRACK
+
+#include <stdint.h>
+#include "../inc/Tachometer.h"
+#include "../inc/Odometry.h"
+
+#define HEADINGPERSTEP (417734353/ODOMETRY_TRACK)
+
+// sin(2*pi*i/256)*32767
+static const int16_t SineTable[256] = {
+       0,    804,   1608,   2410,   3212,   4011,   4808,   5602,   6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793,
+   12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,  18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,
+   23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790,  27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+   30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,  32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757,
+   32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285,  32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571,
+   30273,  29956,  29621,  29268,  28898,  28510,  28105,  27683,  27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731,
+   23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868,  18204,  17530,  16846,  16151,  15446,  14732,  14010,  13279,
+   12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179,   6393,   5602,   4808,   4011,   3212,   2410,   1608,    804,
+       0,   -804,  -1608,  -2410,  -3212,  -4011,  -4808,  -5602,  -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793,
+  -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530, -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+  -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790, -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+  -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971, -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+  -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285, -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+  -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683, -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+  -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868, -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+  -12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179,  -6393,  -5602,  -4808,  -4011,  -3212,  -2410,  -1608,   -804
+};
+
+// sine of a binary angle, interpolated between table entries, times 32767
+static int32_t sine(uint32_t angle){
+  uint32_t i = angle>>24;
+  int32_t a = SineTable[i];
+  int32_t b = SineTable[(i + 1)&0xFF];
+  return a + (((b - a)*(int32_t)((angle>>8)&0xFFFF))>>16);
+}
+
+struct pose{
+  int64_t x, y;       // half steps*32768
+  uint32_t heading;   // 2^32 per turn
+};
+static struct pose Pose;                // owned by Odometry_Update
+static volatile struct pose Published[2]; // double buffer for readers
+static volatile uint32_t Sequence;
+static int32_t LastLeft, LastRight;
+static int First;                       // next update only records the steps
+static volatile struct pose Request;    // written by Odometry_Set
+static volatile int Requested;
+
+static void publish(void){
+  Published[(Sequence + 1)&1] = Pose;
+  Sequence = Sequence + 1;              // publish last
+}
+
+// ------------Odometry_Init------------
+// Reset the pose to the origin facing +x.
+// Input: none
+// Output: none
+void Odometry_Init(void){
+  Pose.x = Pose.y = 0;
+  Pose.heading = 0;
+  Requested = 0;
+  First = 1;
+  publish();
+}
+
+// ------------Odometry_Update------------
+// Integrate the wheel motion since the last update.
+// Input: leftSteps  total steps of the left wheel
+//        rightSteps total steps of the right wheel
+// Output: none
+void Odometry_Update(int32_t leftSteps, int32_t rightSteps){
+  int32_t dl, dr, ds;
+  uint32_t dh, middle;
+  if(Requested){
+    Pose = Request;
+    Requested = 0;
+  }
+  if(First){
+    First = 0;
+  }else{
+    dl = leftSteps - LastLeft;
+    dr = rightSteps - LastRight;
+    ds = dl + dr;                               // half steps
+    dh = (uint32_t)(dr - dl)*HEADINGPERSTEP;    // counterclockwise
+    middle = Pose.heading + (uint32_t)((int32_t)dh>>1);
+    Pose.x = Pose.x + (int64_t)ds*sine(middle + 0x40000000);  // cos
+    Pose.y = Pose.y + (int64_t)ds*sine(middle);
+    Pose.heading = Pose.heading + dh;
+  }
+  LastLeft = leftSteps;
+  LastRight = rightSteps;
+  publish();
+}
+
+// ------------Odometry_Task------------
+// Read the tachometer and integrate the pose.
+// Input: none
+// Output: none
+// Assumes: Tachometer_Init() has been called
+void Odometry_Task(void){
+  uint32_t leftTach, rightTach;
+  enum TachDirection leftDir, rightDir;
+  int32_t leftSteps, rightSteps;
+  Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+  Odometry_Update(leftSteps, rightSteps);
+}
+
+// ------------Odometry_Get------------
+// Return the most recent pose.  Retries if an update
+// publishes a new pose in the middle of the copy.
+// Input: x and y are pointers to return the position in mm
+//        heading is a pointer to return the heading in 0.01 degrees
+// Output: number of updates so far
+uint32_t Odometry_Get(int32_t *x, int32_t *y, int32_t *heading){
+  struct pose p;
+  uint32_t sequence;
+  do{
+    sequence = Sequence;
+    p = Published[sequence&1];
+  }while(sequence != Sequence);
+  // 220/720 mm per half step, 32768 table scale
+  *x = (int32_t)(p.x*11/1179648);
+  *y = (int32_t)(p.y*11/1179648);
+  *heading = (int32_t)(((int64_t)(int32_t)p.heading*36000)>>32);
+  return sequence;
+}
+
+// ------------Odometry_Set------------
+// Move the pose to a known place, at the next update.
+// Input: x and y position in mm
+//        heading in 0.01 degrees
+// Output: none
+void Odometry_Set(int32_t x, int32_t y, int32_t heading){
+  Requested = 0;
+  Request.x = (int64_t)x*1179648/11;
+  Request.y = (int64_t)y*1179648/11;
+  Request.heading = (uint32_t)((int64_t)heading*4294967296LL/36000);
+  Requested = 1;
+}
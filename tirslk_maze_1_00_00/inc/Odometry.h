@@ -0,0 +1,118 @@
+/**
+ * @file      Odometry.h
+ * @brief     Dead-reckoning pose from the wheel encoders
+ * @details   Integrates x, y and heading from the tachometer step
+ * counts in fixed point; there is no floating point anywhere.  Call
+ * Odometry_Task() from a periodic interrupt, such as the SpeedControl
+ * tick, or Odometry_Update() from any code that has new step counts.
+ * Each update costs a few multiplies and two table lookups.  The pose
+ * is published with a sequence count, so Odometry_Get() is O(1), never
+ * blocks, and never disables interrupts.<br>
+ * The robot starts at x=0, y=0 facing the +x axis.  Positive heading
+ * is counterclockwise (a left turn).
+ * @version   V1.0
+ * @author    Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ ******************************************************************************/
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef ODOMETRY_H_
+#define ODOMETRY_H_
+
+/**
+ * \brief distance between the wheels in mm
+ */
+#define ODOMETRY_TRACK 140
+
+/**
+ * Reset the pose to x=0, y=0, heading 0.  The first update after
+ * this only records the step counts.
+ * @param none
+ * @return none
+ * @brief Initialize odometry
+ */
+void Odometry_Init(void);
+
+/**
+ * Integrate the wheel motion since the previous update.  The heading
+ * at the middle of the interval is used, so short arcs are exact to
+ * first order.  Call at least every 10 ms while moving.
+ * @param leftSteps total steps of the left wheel (360 steps per ~220 mm)
+ * @param rightSteps total steps of the right wheel (360 steps per ~220 mm)
+ * @return none
+ * @brief Integrate the pose
+ */
+void Odometry_Update(int32_t leftSteps, int32_t rightSteps);
+
+/**
+ * Read the tachometer and integrate the pose.  Can be passed to
+ * SpeedControl_Init() or called from another periodic task.
+ * @param none
+ * @return none
+ * @note  Assumes Tachometer_Init() has been called
+ * @brief Integrate the pose from the tachometer
+ */
+void Odometry_Task(void);
+
+/**
+ * Return the most recent pose.
+ * @param x pointer to return the position along the starting direction in mm
+ * @param y pointer to return the position to the left of the starting direction in mm
+ * @param heading pointer to return the heading in 0.01 degrees, -18000 to 17999
+ * @return number of updates so far
+ * @brief Get the pose
+ */
+uint32_t Odometry_Get(int32_t *x, int32_t *y, int32_t *heading);
+
+/**
+ * Move the pose to a known place, for example at a maze junction.
+ * Takes effect at the next update.
+ * @param x position along the starting direction in mm
+ * @param y position to the left of the starting direction in mm
+ * @param heading in 0.01 degrees
+ * @return none
+ * @brief Set the pose
+ */
+void Odometry_Set(int32_t x, int32_t y, int32_t heading);
+
+#endif /* ODOMETRY_H_ */
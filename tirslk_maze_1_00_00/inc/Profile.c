@@ -0,0 +1,211 @@
+// Profile.c
+// Runs on MSP432
+// Trapezoidal motion profiles for straight runs and turns,
+// feeding wheel speed targets to SpeedControl at the control rate.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+// 360 steps per 220 mm wheel circumference
+// turning in place, each wheel travels pi*PROFILE_TRACK/360 mm per degree
+
+#include <stdint.h>
+#include "../inc/Tachometer.h"
+#include "../inc/SpeedControl.h"
+#include "../inc/Profile.h"
+
+#define STEPSTOMM(s) ((s)*220/360)
+#define MMTOSTEPS(m) ((m)*360/220)
+#define DELTAV (PROFILE_ACCEL/SPEED_RATE)   // speed change per tick, mm/s
+// The ramp down follows the measured distance, and the wheels lag
+// the command, so while slowing they are ahead of it and the command
+// falls faster than planned.  Planning at 3/4 of PROFILE_ACCEL keeps
+// the command within PROFILE_ACCEL.
+#define BRAKE (PROFILE_ACCEL*3/4)
+
+void (*ProfileTask)(void);     // user function
+static volatile int Busy;
+static int32_t LeftStart, RightStart;  // step counts when the move began
+static int32_t LeftSign, RightSign;    // +1 forward, -1 backward
+static int32_t Steps;          // length of the move in steps of each wheel
+static int32_t Cruise;         // cruise speed, mm/s
+static int32_t Speed;          // current profile speed, mm/s
+
+// integer square root
+static uint32_t isqrt(uint32_t n){
+  uint32_t root = 0, bit = 1UL<<30;
+  while(bit > n){
+    bit = bit>>2;
+  }
+  while(bit){
+    if(n >= root + bit){
+      n = n - (root + bit);
+      root = (root>>1) + bit;
+    }else{
+      root = root>>1;
+    }
+    bit = bit>>2;
+  }
+  return root;
+}
+
+// run each SpeedControl tick, before the speeds are measured
+static void Profile_Task(void){
+  uint32_t leftTach, rightTach;
+  enum TachDirection leftDir, rightDir;
+  int32_t leftSteps, rightSteps, left, right, remaining, limit, sync;
+  int64_t brake;
+  if(Busy == 0){
+    return;
+  }
+  Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+  left = LeftSign*(leftSteps - LeftStart);       // steps travelled in the move direction
+  right = RightSign*(rightSteps - RightStart);
+  remaining = Steps - (left + right)/2;
+  if(remaining <= 0){
+    Busy = 0;
+    Speed = 0;
+    SpeedControl_Set(0, 0);
+    if(ProfileTask){
+      (*ProfileTask)();          // execute user task
+    }
+    return;
+  }
+  Speed = Speed + DELTAV;        // accelerate
+  if(Speed > Cruise){
+    Speed = Cruise;              // cruise
+  }
+  brake = STEPSTOMM(2*BRAKE*(int64_t)remaining); // scale last, so the last step is not 0 mm
+  if(brake > 0xFFFFFFFF){
+    brake = 0xFFFFFFFF;          // 65535 mm/s, far above any cruise speed
+  }
+  limit = isqrt((uint32_t)brake);
+  if(Speed > limit){
+    Speed = limit;               // decelerate to stop at the end
+  }
+  if(Speed < PROFILE_MINSPEED){
+    Speed = PROFILE_MINSPEED;
+  }
+  sync = PROFILE_KSYNC*(left - right);   // slow the wheel that is ahead
+  if(sync > Speed/2) sync = Speed/2;     // never reverse a wheel
+  if(sync < -Speed/2) sync = -Speed/2;
+  SpeedControl_Set(LeftSign*(Speed - sync), RightSign*(Speed + sync));
+}
+
+static void start(int32_t steps, int32_t leftSign, int32_t rightSign, int32_t speed){
+  uint32_t leftTach, rightTach;
+  enum TachDirection leftDir, rightDir;
+  int32_t leftSteps, rightSteps;
+  Busy = 0;                      // the tick ignores the move while it is set up
+  Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+  LeftStart = leftSteps;
+  RightStart = rightSteps;
+  LeftSign = leftSign;
+  RightSign = rightSign;
+  Steps = steps;
+  Cruise = speed;
+  Speed = 0;
+  Busy = 1;
+}
+
+// ------------Profile_Init------------
+// Start the speed control loop with the profile in each tick.
+// Input: task is a pointer to a user function called when a move finishes (0 for none)
+// Output: none
+// Assumes: Clock_Init48MHz() has been called
+void Profile_Init(void(*task)(void)){
+  ProfileTask = task;
+  Busy = 0;
+  Speed = 0;
+  SpeedControl_Init(&Profile_Task);
+}
+
+// ------------Profile_Straight------------
+// Start a straight run.
+// Input: distance in mm, negative to back up
+//        speed    cruise speed in mm/s
+// Output: none
+void Profile_Straight(int32_t distance, int32_t speed){
+  if(distance < 0){
+    start(MMTOSTEPS(-distance), -1, -1, speed);
+  }else{
+    start(MMTOSTEPS(distance), 1, 1, speed);
+  }
+}
+
+// ------------Profile_Turn------------
+// Start a turn in place.
+// Input: angle in degrees, positive is left (counterclockwise)
+//        speed cruise speed of each wheel in mm/s
+// Output: none
+void Profile_Turn(int32_t angle, int32_t speed){
+  // steps = angle*(pi*TRACK/360 mm)*(360/220 steps/mm) = angle*pi*TRACK/220
+  if(angle < 0){
+    start((-angle)*PROFILE_TRACK*355/(220*113), 1, -1, speed);  // pi ~ 355/113
+  }else{
+    start(angle*PROFILE_TRACK*355/(220*113), -1, 1, speed);
+  }
+}
+
+// ------------Profile_Busy------------
+// Check if a move is in progress.
+// Input: none
+// Output: 1 if a move is running, 0 if idle
+int Profile_Busy(void){
+  return Busy;
+}
+
+// ------------Profile_Speed------------
+// Return the speed the profile is asking of the wheels.
+// Input: none
+// Output: profile speed in mm/s, 0 if idle
+int32_t Profile_Speed(void){
+  return Speed;
+}
+
+// ------------Profile_Stop------------
+// Abort the current move.
+// Input: none
+// Output: none
+void Profile_Stop(void){
+  Busy = 0;
+  Speed = 0;
+  SpeedControl_Set(0, 0);
+}
@@ -0,0 +1,138 @@
+/**
+ * @file      Profile.h
+ * @brief     Trapezoidal motion profiles for straight runs and turns
+ * @details   Plans each maze segment as accelerate, cruise, decelerate.
+ * The profile runs once per SpeedControl tick.  The wheel speed target
+ * ramps up by PROFILE_ACCEL, is capped at the cruise speed, and is
+ * limited by sqrt(2*PROFILE_ACCEL*remaining).  The remaining distance
+ * comes from the tachometer step counts, so slip or a slow wheel pushes
+ * the deceleration later instead of overshooting.  A small correction
+ * keeps the two wheels at the same step count, holding straight runs
+ * straight and turns centered.
+ * @version   V1.0
+ * @author    Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ ******************************************************************************/
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+/**
+ * \brief acceleration and deceleration in mm/s/s, low enough that the wheels do not slip
+ */
+#define PROFILE_ACCEL 800
+
+/**
+ * \brief slowest speed used near the end of a move in mm/s, so the robot does not stall short
+ */
+#define PROFILE_MINSPEED 20
+
+/**
+ * \brief distance between the wheels in mm
+ */
+#define PROFILE_TRACK 140
+
+/**
+ * \brief wheel step mismatch correction, mm/s per step
+ */
+#define PROFILE_KSYNC 4
+
+/**
+ * Initialize the motors and tachometer and start the speed control
+ * loop with the profile running in each tick.  The robot is idle.
+ * @param task is a pointer to a user function called when a move finishes (0 for none)
+ * @return none
+ * @note  Assumes Clock_Init48MHz() has been called
+ * @brief Start the motion profile generator
+ */
+void Profile_Init(void(*task)(void));
+
+/**
+ * Start a straight run.  Returns right away; the move runs in the
+ * background and Profile_Busy() is false when it is done.
+ * Starting a new move while one is running replaces it.
+ * @param distance in mm, negative to back up
+ * @param speed cruise speed in mm/s, positive
+ * @return none
+ * @brief Move straight a given distance
+ */
+void Profile_Straight(int32_t distance, int32_t speed);
+
+/**
+ * Start a turn in place about the center of the axle.  Returns right away.
+ * @param angle in degrees, positive turns left (counterclockwise), negative turns right
+ * @param speed cruise speed of each wheel in mm/s, positive
+ * @return none
+ * @brief Turn in place a given angle
+ */
+void Profile_Turn(int32_t angle, int32_t speed);
+
+/**
+ * Check if a move is in progress.
+ * @param none
+ * @return 1 if a move is running, 0 if idle
+ * @brief Check for a move in progress
+ */
+int Profile_Busy(void);
+
+/**
+ * Return the speed the profile is asking of the wheels.  It rises
+ * by at most PROFILE_ACCEL, brakes at 3/4 of that so the wheels
+ * can follow, and is at least PROFILE_MINSPEED until the move is
+ * done.
+ * @param none
+ * @return profile speed in mm/s, 0 if idle
+ * @brief Get the profile speed
+ */
+int32_t Profile_Speed(void);
+
+/**
+ * Stop the current move immediately and hold the wheels at 0.
+ * @param none
+ * @return none
+ * @brief Abort the current move
+ */
+void Profile_Stop(void);
+
+#endif /* PROFILE_H_ */
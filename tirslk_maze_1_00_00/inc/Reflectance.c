@@ -60,6 +60,7 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include "msp432.h"
 #include "../inc/Clock.h"
+#include "../inc/Reflectance.h"
 
 // ------------Reflectance_Init------------
 // Initialize the GPIO pins associated with the QTR-8RC
@@ -143,13 +144,120 @@ uint8_t Reflectance_Center(uint32_t time){
     return center >> 3;
 }
 
+// ------------Reflectance_Decay------------
+// Objective: Measure the decay time of each of the eight sensors
+//
+// Algorithm
+// 1. Turn on the 8 IR LEDs (connected to P5.3)
+// 2. Pulse the 8 sensors (P7) high for 10 us
+// 3. Make the 8 sensors (P7) input
+// 4. Poll P7 against the free-running SysTick counter, and record
+//    the time each bit falls, until all have fallen or t us pass
+// 5. Turn off the 8 IR LEDs (connect to P5.3) to save power
+// 6. Return the bits still high after t us
+//
+// P7 has no edge interrupts, so the decay window is polled. It ends
+// as soon as the last sensor falls, so over a white floor it is much
+// shorter than the fixed wait in Reflectance_Read().
+// Input: decay is an array of 8 times to fill in usec, index 0 is P7.0;
+//          channels still high after t us are given t
+//        time is the longest time to wait in usec
+// Output: sensor readings, same as Reflectance_Read(time)
+// Assumes: Reflectance_Init() has been called
+// Note: starts SysTick free-running if it is off, and otherwise only
+//       reads SysTick->VAL, so it can share SysTick with SysTickInts
+uint8_t Reflectance_Decay(uint16_t decay[8], uint32_t time){
+    uint32_t cyclesPerUs = Clock_GetFreq()/1000000;
+    uint32_t limit = time*cyclesPerUs;
+    uint32_t period, last, now, elapsed = 0;
+    uint8_t pending = 0xFF, fell;
+    int i;
+    if((SysTick->CTRL&0x00000001) == 0){
+      SysTick->LOAD = 0x00FFFFFF;     // free-running, no interrupts
+      SysTick->VAL = 0;
+      SysTick->CTRL = 0x00000005;
+    }
+    period = (SysTick->LOAD&0x00FFFFFF) + 1;
+    P5 -> OUT |= 0x08;
+    P7 -> DIR = 0xFF;
+    P7 -> OUT = 0xFF;
+    Clock_Delay1us(10);
+    last = SysTick->VAL;
+    P7 -> DIR = 0x00;
+    while(pending && (elapsed < limit)){
+      fell = pending&~(P7 -> IN);
+      now = SysTick->VAL;
+      elapsed = elapsed + ((last >= now)? (last - now) : (last + period - now));
+      last = now;
+      if(fell){
+        pending &= ~fell;
+        for(i=0; i<8; i=i+1){
+          if(fell&(1<<i)){
+            decay[i] = elapsed/cyclesPerUs;
+          }
+        }
+      }
+    }
+    for(i=0; i<8; i=i+1){
+      if(pending&(1<<i)){
+        decay[i] = time;
+      }
+    }
+    P5 -> OUT &= 0b11110111;
+    return pending;
+}
+
+// Weighted centroid of the black sensors, as a constant expression so
+// the compiler builds the 256-entry table below. Weights are in 0.1mm,
+// bit 0 (robot's right) is +332 and bit 7 (robot's left) is -332.
+#define BIT(d,i) (((d)>>(i))&1)
+#define COUNT(d) (BIT(d,0)+BIT(d,1)+BIT(d,2)+BIT(d,3)+BIT(d,4)+BIT(d,5)+BIT(d,6)+BIT(d,7))
+#define SUM(d) (332*BIT(d,0)+237*BIT(d,1)+142*BIT(d,2)+47*BIT(d,3) \
+               -47*BIT(d,4)-142*BIT(d,5)-237*BIT(d,6)-332*BIT(d,7))
+#define POS(d) ((d)? SUM(d)/COUNT(d) : 333)
+#define ROW(d) POS(d),POS(d+1),POS(d+2),POS(d+3),POS(d+4),POS(d+5),POS(d+6),POS(d+7), \
+  POS(d+8),POS(d+9),POS(d+10),POS(d+11),POS(d+12),POS(d+13),POS(d+14),POS(d+15)
+static const int16_t PositionTable[256] = {
+  ROW(0x00), ROW(0x10), ROW(0x20), ROW(0x30), ROW(0x40), ROW(0x50), ROW(0x60), ROW(0x70),
+  ROW(0x80), ROW(0x90), ROW(0xA0), ROW(0xB0), ROW(0xC0), ROW(0xD0), ROW(0xE0), ROW(0xF0)
+};
 
 // Perform sensor integration
 // Input: data is 8-bit result from line sensor
-// Output: position in 0.1mm relative to center of line
+// Output: position in 0.1mm relative to center of line,
+//         333 if no sensor sees the line
 int32_t Reflectance_Position(uint8_t data){
-    // TODO: Write this method.
-    return 0;
+    return PositionTable[data];
+}
+
+// Weights of sensors P7.0 to P7.7 in 0.1mm
+static const int32_t Weight[8] = {332, 237, 142, 47, -47, -142, -237, -332};
+
+// ------------Reflectance_PositionDecay------------
+// Sub-sensor line position from the decay times of Reflectance_Decay().
+// The shortest time is taken as the white floor, and each sensor is
+// weighted by how much longer than that it took to decay, so the
+// estimate moves smoothly as the line passes between two sensors.
+// Input: decay is an array of 8 times in usec, index 0 is P7.0
+// Output: position in 0.1mm relative to center of line,
+//         333 if no sensor is REFLECTANCE_CONTRAST us slower than the floor
+int32_t Reflectance_PositionDecay(const uint16_t decay[8]){
+    int32_t sum = 0, total = 0, darkness;
+    uint16_t white = decay[0], peak = decay[0];
+    int i;
+    for(i=1; i<8; i=i+1){
+      if(decay[i] < white) white = decay[i];
+      if(decay[i] > peak) peak = decay[i];
+    }
+    if((peak - white) < REFLECTANCE_CONTRAST){
+      return 333;
+    }
+    for(i=0; i<8; i=i+1){
+      darkness = decay[i] - white;
+      sum = sum + Weight[i]*darkness;
+      total = total + darkness;
+    }
+    return sum/total;
 }
 
 // ------------Reflectance_Start------------
@@ -125,6 +125,24 @@ uint8_t Reflectance_Read(uint32_t time);
 */
 uint8_t Reflectance_Center(uint32_t time);
 
+/**
+ * <b>Measure the decay time of each sensor</b>:<br>
+  1) Turn on the 8 IR LEDs<br>
+  2) Pulse the 8 sensors high for 10 us<br>
+  3) Make the sensor pins input<br>
+  4) Poll the sensors, recording when each one falls, until all have fallen or <b>time</b> us pass<br>
+  5) Turn off the 8 IR LEDs<br>
+ * The decay time grows with the darkness of the surface under each
+ * sensor, so it gives an analog reading instead of the single
+ * threshold of Reflectance_Read().
+ * @param  decay array of 8 decay times in us, index 0 is P7.0 (robot's right)
+ * @param  time longest time to wait in us; sensors that have not fallen read <b>time</b>
+ * @return 8-bit result, same as Reflectance_Read(time)
+ * @note Assumes Reflectance_Init() has been called
+ * @note Uses SysTick as a free-running timer, starting it if it is off
+ * @brief  Measure the decay time of the eight sensors.
+ */
+uint8_t Reflectance_Decay(uint16_t decay[8], uint32_t time);
 
 /**
  * <b>Calculate the weighted average for each bit</b>:<br>
@@ -144,9 +162,31 @@ uint8_t Reflectance_Center(uint32_t time);
  * @return position in 0.1mm relative to center of line
  * @brief  Perform sensor integration.
  * @note returns 333 if data is zero (off the line)
+ * @note The result for all 256 inputs is computed at compile time, so this is one table lookup
  * */
 int32_t Reflectance_Position(uint8_t data);
 
+/**
+ * Smallest difference, in us, between the slowest and the fastest
+ * sensor for Reflectance_PositionDecay() to report a line
+ */
+#define REFLECTANCE_CONTRAST 100
+
+/**
+ * <b>Calculate the position from the decay times</b>:<br>
+ * The same weights as Reflectance_Position() are used, but each sensor
+ * counts in proportion to how much longer than the fastest (white) sensor
+ * it took to decay.  This interpolates between sensors, giving a smooth
+ * position from one sample.<br>
+ * floor = min(decay)<br>
+ * position = sum(Weight[i]*(decay[i]-floor)) / sum(decay[i]-floor)
+ * @param  decay array of 8 decay times in us from Reflectance_Decay()
+ * @return position in 0.1mm relative to center of line
+ * @brief  Perform sensor integration with sub-sensor resolution.
+ * @note returns 333 if no sensor is REFLECTANCE_CONTRAST us slower than the fastest (off the line)
+ * */
+int32_t Reflectance_PositionDecay(const uint16_t decay[8]);
+
 /**
  * <b>Begin the process of reading the eight sensors</b>:<br>
   1) Turn on the 8 IR LEDs<br>
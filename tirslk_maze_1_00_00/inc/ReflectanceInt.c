@@ -0,0 +1,160 @@
+// ReflectanceInt.c
+// Runs on MSP432, interrupt version
+// Background acquisition of the QTR-8RC reflectance sensor array
+// using Timer A1 to start and end each charge/decay cycle.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+// reflectance LED illuminate connected to P5.3
+// reflectance sensors 1-8 connected to P7.0-P7.7
+// Timer A1 CCR0 starts a sample, CCR1 ends it
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Reflectance.h"
+
+void (*ReflectanceTask)(uint8_t data);   // user function
+static uint16_t Period;          // time between samples, 2us
+static uint32_t Ticks;           // time of the next cycle, 2us
+static uint32_t StartTime;       // time of the sample in progress, 2us
+static int Charged;              // a sample is in progress
+// published sample, written only by TA1_N_IRQHandler
+static volatile uint8_t Data;
+static volatile uint32_t Time;
+static volatile uint32_t Sequence;
+
+// ***************** ReflectanceInt_Init ****************
+// Start background sampling of the eight reflectance sensors
+// Inputs:  task is a pointer to a user function run with each sample (0 for none)
+//          period between samples in units (24/SMCLK), 16 bits
+//          decay from end of charge to read in units (24/SMCLK)
+// Outputs: none
+// Assumes: Reflectance_Init() has been called
+void ReflectanceInt_Init(void(*task)(uint8_t data), uint16_t period, uint16_t decay){
+  ReflectanceTask = task;         // user function
+  Period = period;
+  Ticks = 0;
+  StartTime = 0;
+  Charged = 0;
+  Data = 0;
+  Time = 0;
+  Sequence = 0;
+  TIMER_A1->CTL &= ~0x0030;       // halt Timer A1
+  // bits15-10=XXXXXX, reserved
+  // bits9-8=10,       clock source to SMCLK
+  // bits7-6=10,       input clock divider /4
+  // bits5-4=00,       stop mode
+  // bit3=X,           reserved
+  // bit2=0,           set this bit to clear
+  // bit1=0,           no interrupt on timer
+  TIMER_A1->CTL = 0x0280;
+  // bits15-14=00,     no capture mode
+  // bits13-12=XX,     capture/compare input select
+  // bit11=X,          synchronize capture source
+  // bit10=X,          synchronized capture/compare input
+  // bit9=X,           reserved
+  // bit8=0,           compare mode
+  // bits7-5=XXX,      output mode
+  // bit4=1,           enable capture/compare interrupt on CCIFG
+  // bit3=X,           read capture/compare input from here
+  // bit2=0,           output this value in output mode 0
+  // bit1=X,           capture overflow status
+  // bit0=0,           clear capture/compare interrupt pending
+  TIMER_A1->CCTL[0] = 0x0010;     // CCR0 starts the charge
+  TIMER_A1->CCTL[1] = 0x0010;     // CCR1 reads the sensors
+  TIMER_A1->CCR[0] = (period - 1);   // compare match value
+  TIMER_A1->CCR[1] = decay + 5;   // 10us charge pulse is 5 ticks
+  TIMER_A1->EX0 = 0x0005;    // configure for input clock divider /6
+// interrupts enabled in the main program after all devices initialized
+  NVIC->IP[2] = (NVIC->IP[2]&0x0000FFFF)|0x40400000; // priority 2
+  NVIC->ISER[0] = 0x00000C00;   // enable interrupts 10 and 11 in NVIC
+  TIMER_A1->CTL |= 0x0014;      // reset and start Timer A1 in up mode
+}
+
+// ------------ReflectanceInt_Stop------------
+// Stop background sampling and turn the IR LEDs off.
+// Input: none
+// Output: none
+void ReflectanceInt_Stop(void){
+  TIMER_A1->CTL &= ~0x0030;       // halt Timer A1
+  NVIC->ICER[0] = 0x00000C00;     // disable interrupts 10 and 11 in NVIC
+  P5->OUT &= ~0x08;               // IR LEDs off
+}
+
+// ------------ReflectanceInt_Get------------
+// Return the most recent sample. Retries if TA1_N_IRQHandler
+// publishes a new sample in the middle of the copy.
+// Input: data and time are pointers to return the sample
+// Output: sequence number, 0 if no sample yet
+uint32_t ReflectanceInt_Get(uint8_t *data, uint32_t *time){
+  uint32_t sequence;
+  do{
+    sequence = Sequence;
+    *data = Data;
+    *time = Time;
+  }while(sequence != Sequence);
+  return sequence;
+}
+
+// start of the cycle: charge the capacitors
+void TA1_0_IRQHandler(void){
+  TIMER_A1->CCTL[0] &= ~0x0001; // acknowledge capture/compare interrupt 0
+  Reflectance_Start();
+  StartTime = Ticks;
+  Ticks = Ticks + Period;
+  Charged = 1;
+}
+
+// decay time is over: read the sensors and publish
+void TA1_N_IRQHandler(void){ uint8_t data;
+  TIMER_A1->CCTL[1] &= ~0x0001; // acknowledge capture/compare interrupt 1
+  if(Charged == 0){
+    return;                     // first pass of the timer, before any charge
+  }
+  Charged = 0;
+  data = Reflectance_End();
+  Data = data;
+  Time = StartTime;
+  Sequence = Sequence + 1;      // publish last
+  if(ReflectanceTask){
+    (*ReflectanceTask)(data);   // execute user task
+  }
+}
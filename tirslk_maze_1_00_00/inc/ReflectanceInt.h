@@ -0,0 +1,105 @@
+/**
+ * @file      ReflectanceInt.h
+ * @brief     Background acquisition of the QTR-8RC reflectance sensor array
+ * @details   Timer A1 runs the charge/decay cycle of Reflectance_Start()
+ * and Reflectance_End() in the background, so the main program never
+ * waits for the sensor capacitors to discharge.<br>
+ 1) Timer A1 CCR0 interrupt starts a sample every <b>period</b><br>
+ 2) Timer A1 CCR1 interrupt ends it <b>decay</b> later<br>
+ 3) Each sample is published with a sequence number and timestamp<br>
+ 4) An optional user task runs on each new sample<br>
+ * Timer A1 is owned by this module, so it cannot be used together
+ * with TimerA1.c.
+ * @version   V1.0
+ * @author    Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ *
+<table>
+<caption id="ReflectanceInt_timing">One acquisition cycle, in 2us timer ticks</caption>
+<tr><th>Tick              <th>Event
+<tr><td>0                 <td>IR LEDs on, P7 charged for 10 us
+<tr><td>5                 <td>P7 made input, decay starts
+<tr><td>5+decay           <td>P7 read, IR LEDs off, sample published
+<tr><td>period            <td>next cycle
+</table>
+ ******************************************************************************/
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef REFLECTANCEINT_H_
+#define REFLECTANCEINT_H_
+
+/**
+ * Start background sampling of the eight reflectance sensors.
+ * The sensor pins must already be set up with Reflectance_Init().
+ * Interrupts are enabled in the main program after all devices are initialized.
+ * @param task user function run in the interrupt with each new 8-bit sample (0 for none)
+ * @param period time between samples in 2us units (24/SMCLK), 16 bits
+ * @param decay time from the end of the charge pulse to the read, in 2us units
+ * @return none
+ * @note  Assumes 48 MHz bus and 12 MHz SMCLK.
+ * period must exceed decay+5, e.g. period=500 (1 kHz) with decay=250 (500 us)
+ * @brief Start background reflectance sampling
+ */
+void ReflectanceInt_Init(void(*task)(uint8_t data), uint16_t period, uint16_t decay);
+
+/**
+ * Stop background sampling and turn the IR LEDs off.
+ * @param none
+ * @return none
+ * @brief Stop background reflectance sampling
+ */
+void ReflectanceInt_Stop(void);
+
+/**
+ * Return the most recent sample.
+ * The three results always belong to the same sample, even if a
+ * new one is published while this function runs.
+ * @param data pointer to return the 8-bit sensor reading (white is 0, black is 1)
+ * @param time pointer to return when the sample was started, in 2us units since ReflectanceInt_Init()
+ * @return sequence number of the sample, 0 if no sample has been taken yet
+ * @note Compare the sequence number with the previous one to detect a new sample
+ * @brief Get the latest reflectance sample
+ */
+uint32_t ReflectanceInt_Get(uint8_t *data, uint32_t *time);
+
+#endif /* REFLECTANCEINT_H_ */
@@ -0,0 +1,309 @@
+// Shell.c
+// Runs on MSP432
+// Non-blocking command shell on UART0 for tuning gains, setting
+// speeds, starting runs and showing counters while the robot drives.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+// UART0 RxD P1.2, TxD P1.3 through the XDS110 VCP (EUSCIA0.c)
+
+#include <stdint.h>
+#include "../inc/EUSCIA0.h"
+#include "../inc/FIFO0.h"
+#include "../inc/Format.h"
+#include "../inc/Tachometer.h"
+#include "../inc/SpeedControl.h"
+#include "../inc/Profile.h"
+#include "../inc/Shell.h"
+
+struct command{
+  const char *name;
+  const char *usage;
+  int (*run)(uint32_t argc, const int32_t *argv);   // 1 if done, 0 for bad arguments
+};
+
+static char Line[SHELL_MAXLINE+1];
+static uint32_t Length;           // characters in Line
+static char Last;                 // previous character, so CR LF is one end of line
+// parse of Line[0] to Line[Length-1]
+static uint32_t Argc;             // words finished, including the name
+static int32_t Argv[SHELL_MAXARGS];
+static const struct command *Command;   // 0 until the name is finished and found
+static uint32_t Start;            // first character of the word being read
+static int Reading;               // 1 inside a word
+static int32_t Sign, Value;       // of the number being read
+static uint32_t Digits;
+static int Bad;                   // 1 if a number is malformed or there are too many
+
+static void out(const char *pt){
+  EUSCIA0_OutString((char *)pt);
+}
+static void outSDec(int32_t n){
+  char buf[FORMAT_SIZE];
+  Format_SDec(buf, n, 0);
+  EUSCIA0_OutString(buf);
+}
+
+static int help(uint32_t argc, const int32_t *argv);
+static int gains(uint32_t argc, const int32_t *argv){
+  int32_t kff, kp, ki;
+  if(argc == 3){
+    SpeedControl_SetGains(argv[0], argv[1], argv[2]);
+  }else if(argc != 0){
+    return 0;
+  }
+  SpeedControl_GetGains(&kff, &kp, &ki);
+  outSDec(kff); out(" "); outSDec(kp); out(" "); outSDec(ki); out("\r\n");
+  return 1;
+}
+static int speed(uint32_t argc, const int32_t *argv){
+  if(argc != 2){
+    return 0;
+  }
+  Profile_Stop();                 // or the next tick of a move overrides the speeds
+  SpeedControl_Set(argv[0], argv[1]);
+  return 1;
+}
+static int run(uint32_t argc, const int32_t *argv){
+  if((argc != 2) || (argv[1] <= 0)){
+    return 0;
+  }
+  Profile_Straight(argv[0], argv[1]);
+  return 1;
+}
+static int turn(uint32_t argc, const int32_t *argv){
+  if((argc != 2) || (argv[1] <= 0)){
+    return 0;
+  }
+  Profile_Turn(argv[0], argv[1]);
+  return 1;
+}
+static int stop(uint32_t argc, const int32_t *argv){
+  (void)argv;                     // takes no numbers
+  if(argc != 0){
+    return 0;
+  }
+  Profile_Stop();
+  return 1;
+}
+static int count(uint32_t argc, const int32_t *argv){
+  uint32_t leftTach, rightTach;
+  enum TachDirection leftDir, rightDir;
+  int32_t leftSteps, rightSteps, leftSpeed, rightSpeed;
+  (void)argv;                     // takes no numbers
+  if(argc != 0){
+    return 0;
+  }
+  Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+  SpeedControl_Get(&leftSpeed, &rightSpeed);
+  out("steps "); outSDec(leftSteps); out(" "); outSDec(rightSteps);
+  out(" speed "); outSDec(leftSpeed); out(" "); outSDec(rightSpeed);
+  out(" busy "); outSDec(Profile_Busy());
+  out(" lost "); outSDec((int32_t)RxFifo0Lost); out("\r\n");
+  return 1;
+}
+
+static const struct command Commands[] = {
+  {"help",  "",                  &help},
+  {"gains", "[kff kp ki]",       &gains},
+  {"speed", "left right",        &speed},
+  {"run",   "mm speed",          &run},
+  {"turn",  "degrees speed",     &turn},
+  {"stop",  "",                  &stop},
+  {"count", "",                  &count}
+};
+#define NUMCOMMANDS (sizeof(Commands)/sizeof(Commands[0]))
+
+static int help(uint32_t argc, const int32_t *argv){
+  uint32_t i;
+  (void)argv;                     // takes no numbers
+  if(argc != 0){
+    return 0;
+  }
+  for(i=0; i<NUMCOMMANDS; i=i+1){
+    out(Commands[i].name); out(" "); out(Commands[i].usage); out("\r\n");
+  }
+  return 1;
+}
+
+// find the command named by Line[Start] to Line[end-1]
+static const struct command *lookup(uint32_t end){
+  uint32_t i, j;
+  const char *name;
+  for(i=0; i<NUMCOMMANDS; i=i+1){
+    name = Commands[i].name;
+    for(j=0; (Start + j < end) && (name[j] == Line[Start + j]); j=j+1){}
+    if((Start + j == end) && (name[j] == 0)){
+      return &Commands[i];
+    }
+  }
+  return 0;
+}
+
+// the word ends just before Line[end]
+static void finish(uint32_t end){
+  Reading = 0;
+  if(Argc == 0){
+    Command = lookup(end);
+  }else if((Digits == 0) || (Argc > SHELL_MAXARGS)){
+    Bad = 1;
+  }else{
+    Argv[Argc-1] = Sign*Value;
+  }
+  Argc = Argc + 1;
+}
+
+// parse Line[i], the next character of the line
+static void parse(uint32_t i){
+  char c = Line[i];
+  if(c == ' '){
+    if(Reading){
+      finish(i);
+    }
+    return;
+  }
+  if(Reading == 0){
+    Reading = 1;
+    Start = i;
+    Sign = 1;
+    Value = 0;
+    Digits = 0;
+  }
+  if(Argc == 0){
+    return;                       // name, looked up when it is finished
+  }
+  if((c == '-') && (i == Start)){
+    Sign = -1;
+  }else if((c >= '0') && (c <= '9') && (Digits < 9)){
+    Value = 10*Value + (c - '0');
+    Digits = Digits + 1;
+  }else{
+    Bad = 1;
+  }
+}
+
+static void clear(void){
+  Length = 0;
+  Argc = 0;
+  Command = 0;
+  Reading = 0;
+  Bad = 0;
+}
+
+// parse the line again from the start, after a backspace
+static void reparse(void){
+  uint32_t i, length = Length;
+  clear();
+  Length = length;
+  for(i=0; i<length; i=i+1){
+    parse(i);
+  }
+}
+
+// end of line; returns 1 if a command ran
+static uint32_t execute(void){
+  uint32_t ran = 0;
+  if(Reading){
+    finish(Length);
+  }
+  out("\r\n");
+  if(Argc){
+    if(Command == 0){
+      Line[Length] = 0;
+      out("? "); out(Line); out("\r\n");
+    }else if(Bad || ((*Command->run)(Argc - 1, Argv) == 0)){
+      out("usage: "); out(Command->name); out(" "); out(Command->usage); out("\r\n");
+    }else{
+      ran = 1;
+    }
+  }
+  clear();
+  out("> ");
+  return ran;
+}
+
+// ------------Shell_Init------------
+// Initialize EUSCI_A0, empty the line and send a prompt.
+// Input: none
+// Output: none
+// Assumes: Clock_Init48MHz() and Profile_Init() have been called
+void Shell_Init(void){
+  EUSCIA0_Init();
+  clear();
+  Last = 0;
+  out("> ");
+}
+
+// ------------Shell_Poll------------
+// Process the characters received so far, without waiting.
+// Input: none
+// Output: number of commands run
+uint32_t Shell_Poll(void){
+  uint32_t ran = 0;
+  char c;
+  while(EUSCIA0_InStatus()){
+    c = EUSCIA0_InChar();
+    if((c == CR) || (c == LF)){
+      if((c == CR) || (Last != CR)){
+        ran = ran + execute();
+      }
+    }else if((c == BS) || (c == DEL)){
+      if(Length){
+        Length = Length - 1;
+        out("\b \b");
+        reparse();
+      }
+    }else if(c == ESC){
+      while(Length){
+        Length = Length - 1;
+        out("\b \b");
+      }
+      clear();
+    }else if((c >= ' ') && (c < DEL) && (Length < SHELL_MAXLINE)){
+      Line[Length] = c;
+      Length = Length + 1;
+      EUSCIA0_OutChar(c);
+      parse(Length - 1);
+    }
+    Last = c;
+  }
+  return ran;
+}
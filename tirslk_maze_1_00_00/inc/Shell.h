@@ -0,0 +1,109 @@
+/**
+ * @file      Shell.h
+ * @brief     Command shell on the UART0 (VCP) port for tuning the robot
+ * @details   Shell_Poll() takes the characters waiting in the EUSCIA0
+ * receive FIFO and returns; it never waits for a key.  Each character
+ * is echoed and parsed as it arrives, so when Enter is pressed the
+ * command has already been looked up in a fixed table and its numbers
+ * converted.  The control loop runs in its own interrupt, so commands
+ * typed while the robot drives change it without disturbing its timing.<br>
+ 1) A line is a command name and up to SHELL_MAXARGS signed decimal
+    numbers, separated by spaces<br>
+ 2) Backspace or delete removes the last character, escape clears the line<br>
+ 3) Call Shell_Poll() from the main program at least every
+    RX0FIFOSIZE characters (1.4 ms at 115,200 baud) so no key is lost<br>
+ * @version   V1.0
+ * @author    Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ *
+<table>
+<caption id="Shell_commands">Commands</caption>
+<tr><th>Command               <th>Action
+<tr><td>help                  <td>list the commands
+<tr><td>gains [kff kp ki]     <td>set or show the SpeedControl gains
+<tr><td>speed left right      <td>hold wheel speeds in mm/s
+<tr><td>run mm speed          <td>drive straight mm at speed mm/s
+<tr><td>turn degrees speed    <td>turn in place, positive is left
+<tr><td>stop                  <td>stop the motors
+<tr><td>count                 <td>show steps, speeds and lost characters
+</table>
+ ******************************************************************************/
+
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef SHELL_H_
+#define SHELL_H_
+
+/**
+ * \brief most characters in one line
+ */
+#define SHELL_MAXLINE 32
+
+/**
+ * \brief most numbers after the command name
+ */
+#define SHELL_MAXARGS 3
+
+/**
+ * Initialize EUSCI_A0 at 115,200 baud, empty the line and send a prompt.
+ * Interrupts are enabled in the main program after all devices are initialized.
+ * @param none
+ * @return none
+ * @note Assumes Clock_Init48MHz() and Profile_Init() have been called
+ * @brief Initialize the command shell
+ */
+void Shell_Init(void);
+
+/**
+ * Process the characters received since the last call, running each
+ * command whose line is complete.  Returns when the receive FIFO is
+ * empty.  Replies go through EUSCIA0_OutString(), which waits if
+ * TxFifo0 is full, so call this from the main program, not from an
+ * interrupt.
+ * @param none
+ * @return number of commands run
+ * @brief Run the command shell
+ */
+uint32_t Shell_Poll(void);
+
+#endif /* SHELL_H_ */
@@ -0,0 +1,216 @@
+// SpeedControl.c
+// Runs on MSP432
+// Fixed-point PI wheel speed controller with feedforward, run from the
+// Timer A2 periodic interrupt, using the tachometer for feedback.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+// Left motor PWM P2.7/TA0CCP4, right motor PWM P2.6/TA0CCP3 (Motor.c)
+// Left encoder P8.2/P9.2, right encoder P10.4/P10.5 (Tachometer.c)
+
+#include <stdint.h>
+#include "msp.h"
+#include "../inc/Motor.h"
+#include "../inc/Tachometer.h"
+#include "../inc/TimerA2.h"
+#include "../inc/SpeedControl.h"
+
+#define MAXDUTY 14998
+// one step is 220/360 mm and the period is in 1/12 us, so
+// speed in mm/s = (220/360)*12000000/period
+#define SPEEDCONSTANT 7333333
+
+struct wheel{
+  int32_t target;     // mm/s
+  int32_t speed;      // measured mm/s
+  int32_t integral;   // sum of error, mm/s*ticks
+  int32_t steps;      // tachometer steps at the previous tick
+  uint32_t idle;      // ticks since the last step
+};
+static struct wheel Left, Right;
+static int32_t Kff, Kp, Ki;       // gains, scaled by SPEED_SCALE
+void (*SpeedControlTask)(void);   // user function
+
+// speed of one wheel from its tachometer period, 0 if it has not moved lately
+static int32_t measure(struct wheel *w, uint32_t period, enum TachDirection dir, int32_t steps){
+  if(steps != w->steps){
+    w->steps = steps;
+    w->idle = 0;
+  }else if(w->idle < SPEED_IDLE){
+    w->idle = w->idle + 1;
+  }
+  if((w->idle >= SPEED_IDLE) || (period == 0)){
+    return 0;
+  }
+  if(dir == REVERSE){
+    return -(SPEEDCONSTANT/period);
+  }
+  return SPEEDCONSTANT/period;
+}
+
+// PI with feedforward, returns signed duty
+static int32_t control(struct wheel *w){
+  int32_t error, out, low, high;
+  if(w->target == 0){
+    w->integral = 0;
+    return 0;
+  }
+  if(w->target > 0){
+    low = 0; high = MAXDUTY;      // brake by coasting, never reverse
+  }else{
+    low = -MAXDUTY; high = 0;
+  }
+  error = w->target - w->speed;
+  w->integral = w->integral + error;
+  out = (Kff*w->target + Kp*error + Ki*w->integral)/SPEED_SCALE;
+  // anti-windup: stop integrating while the output is saturated
+  if(out > high){
+    out = high;
+    if(error > 0) w->integral = w->integral - error;
+  }else if(out < low){
+    out = low;
+    if(error < 0) w->integral = w->integral - error;
+  }
+  return out;
+}
+
+// run each tick in the Timer A2 interrupt
+static void SpeedControl_Task(void){
+  uint32_t leftTach, rightTach;
+  enum TachDirection leftDir, rightDir;
+  int32_t leftSteps, rightSteps, left, right;
+  if(SpeedControlTask){
+    (*SpeedControlTask)();        // execute user task, may change targets
+  }
+  Tachometer_Get(&leftTach, &leftDir, &leftSteps, &rightTach, &rightDir, &rightSteps);
+  Left.speed = measure(&Left, leftTach, leftDir, leftSteps);
+  Right.speed = measure(&Right, rightTach, rightDir, rightSteps);
+  left = control(&Left);
+  right = control(&Right);
+  if((Left.target == 0) && (Right.target == 0)){
+    Motor_Stop();
+  }else if(left >= 0){
+    if(right >= 0){
+      Motor_Forward(left, right);
+    }else{
+      Motor_Right(left, -right);
+    }
+  }else{
+    if(right >= 0){
+      Motor_Left(-left, right);
+    }else{
+      Motor_Backward(-left, -right);
+    }
+  }
+}
+
+// ------------SpeedControl_Init------------
+// Initialize the motors and tachometer, and start
+// the control loop with both targets 0.
+// Input: task is a pointer to a user function run at the start of each tick (0 for none)
+// Output: none
+// Assumes: Clock_Init48MHz() has been called
+void SpeedControl_Init(void(*task)(void)){
+  SpeedControlTask = task;
+  Left.target = Right.target = 0;
+  Left.speed = Right.speed = 0;
+  Left.integral = Right.integral = 0;
+  Left.steps = Right.steps = 0;
+  Left.idle = Right.idle = SPEED_IDLE;
+  Kff = SPEED_KFF;
+  Kp = SPEED_KP;
+  Ki = SPEED_KI;
+  Motor_Init();
+  Tachometer_Init();
+  TimerA2_Init(&SpeedControl_Task, SPEED_PERIOD);
+}
+
+// ------------SpeedControl_Set------------
+// Set the target speed of each wheel.
+// Input: leftSpeed  target of left wheel in mm/s, negative is backward
+//        rightSpeed target of right wheel in mm/s, negative is backward
+// Output: none
+void SpeedControl_Set(int32_t leftSpeed, int32_t rightSpeed){
+  Left.target = leftSpeed;
+  Right.target = rightSpeed;
+}
+
+// ------------SpeedControl_Get------------
+// Return the wheel speeds measured at the last tick.
+// Input: leftSpeed and rightSpeed are pointers to return mm/s
+// Output: none
+void SpeedControl_Get(int32_t *leftSpeed, int32_t *rightSpeed){
+  *leftSpeed = Left.speed;
+  *rightSpeed = Right.speed;
+}
+
+// ------------SpeedControl_SetGains------------
+// Change the controller gains while the loop runs.
+// Input: kff feedforward gain, scaled by SPEED_SCALE
+//        kp  proportional gain, scaled by SPEED_SCALE
+//        ki  integral gain, scaled by SPEED_SCALE
+// Output: none
+void SpeedControl_SetGains(int32_t kff, int32_t kp, int32_t ki){
+  Kff = kff;
+  Kp = kp;
+  Ki = ki;
+}
+
+// ------------SpeedControl_GetGains------------
+// Return the controller gains.
+// Input: kff, kp and ki are pointers to return the gains, scaled by SPEED_SCALE
+// Output: none
+void SpeedControl_GetGains(int32_t *kff, int32_t *kp, int32_t *ki){
+  *kff = Kff;
+  *kp = Kp;
+  *ki = Ki;
+}
+
+// ------------SpeedControl_Stop------------
+// Stop the control loop and the motors.
+// Input: none
+// Output: none
+void SpeedControl_Stop(void){
+  TimerA2_Stop();
+  Left.target = Right.target = 0;
+  Left.integral = Right.integral = 0;
+  Motor_Stop();
+}
@@ -0,0 +1,163 @@
+/**
+ * @file      SpeedControl.h
+ * @brief     Closed-loop wheel speed control using tachometer feedback
+ * @details   A fixed-point PI controller with feedforward runs in the
+ * Timer A2 periodic interrupt.  Each tick it reads Tachometer_Get(),
+ * converts the tachometer periods to wheel speeds in mm/s, and sets the
+ * PWM duty cycles of the two motors so each wheel holds its target speed
+ * regardless of battery voltage or floor.<br>
+ * duty = (SPEED_KFF*target + SPEED_KP*error + SPEED_KI*sum(error))/SPEED_SCALE<br>
+ * The gains start at these values and can be tuned with SpeedControl_SetGains().
+ * The integral stops while the output is saturated, so it cannot wind up.
+ * Timer A2 is owned by this module, so it cannot be used together with
+ * TimerA2_Init() from another module or with TA2InputCapture.c.
+ * @version   V1.0
+ * @author    Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ ******************************************************************************/
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef SPEEDCONTROL_H_
+#define SPEEDCONTROL_H_
+
+/**
+ * \brief control loop period in 2us units (24/SMCLK), 5000 is 10 ms (100 Hz)
+ */
+#define SPEED_PERIOD 5000
+
+/**
+ * \brief control loop rate in Hz
+ */
+#define SPEED_RATE (500000/SPEED_PERIOD)
+
+/**
+ * \brief fixed-point scale of the gains; duty = gain*value/SPEED_SCALE
+ */
+#define SPEED_SCALE 64
+
+/**
+ * \brief feedforward, 1600/64 = 25 duty per mm/s (14,998 duty is about 600 mm/s)
+ */
+#define SPEED_KFF 1600
+
+/**
+ * \brief proportional gain, 640/64 = 10 duty per mm/s of error
+ */
+#define SPEED_KP 640
+
+/**
+ * \brief integral gain, 256/64 = 4 duty per mm/s of error per tick
+ */
+#define SPEED_KI 256
+
+/**
+ * \brief wheel is taken as stopped if no encoder step is seen for this many ticks
+ */
+#define SPEED_IDLE 20
+
+/**
+ * Initialize the motors and the tachometer, and start the control
+ * loop in the Timer A2 interrupt with both targets 0.  The user task
+ * runs at the start of every tick, before the wheel speeds are
+ * measured, so it can update the targets at the control rate.
+ * Interrupts are enabled in the main program after all devices are initialized.
+ * @param task is a pointer to a user function run each tick (0 for none)
+ * @return none
+ * @note  Assumes Clock_Init48MHz() has been called
+ * @brief Start wheel speed control
+ */
+void SpeedControl_Init(void(*task)(void));
+
+/**
+ * Set the target speed of each wheel.  Negative speeds run the wheel
+ * backward, and 0 stops it with the drivers asleep once both are 0.
+ * Returns right away; the control loop moves the wheels to the new speeds.
+ * @param leftSpeed target of the left wheel in mm/s
+ * @param rightSpeed target of the right wheel in mm/s
+ * @return none
+ * @brief Set the wheel speed targets
+ */
+void SpeedControl_Set(int32_t leftSpeed, int32_t rightSpeed);
+
+/**
+ * Return the wheel speeds measured by the last control tick.
+ * @param leftSpeed pointer to return the speed of the left wheel in mm/s
+ * @param rightSpeed pointer to return the speed of the right wheel in mm/s
+ * @return none
+ * @brief Get the measured wheel speeds
+ */
+void SpeedControl_Get(int32_t *leftSpeed, int32_t *rightSpeed);
+
+/**
+ * Change the gains of both wheels, for tuning while the robot runs.
+ * The next tick uses the new gains (a tick that interrupts this call
+ * may run once with some of each); the integral is kept, so a change
+ * in ki scales the integral term at once.  SpeedControl_Init()
+ * restores SPEED_KFF, SPEED_KP and SPEED_KI.
+ * @param kff feedforward gain, scaled by SPEED_SCALE
+ * @param kp proportional gain, scaled by SPEED_SCALE
+ * @param ki integral gain, scaled by SPEED_SCALE
+ * @return none
+ * @brief Set the controller gains
+ */
+void SpeedControl_SetGains(int32_t kff, int32_t kp, int32_t ki);
+
+/**
+ * Return the gains in use.
+ * @param kff pointer to return the feedforward gain
+ * @param kp pointer to return the proportional gain
+ * @param ki pointer to return the integral gain
+ * @return none
+ * @brief Get the controller gains
+ */
+void SpeedControl_GetGains(int32_t *kff, int32_t *kp, int32_t *ki);
+
+/**
+ * Stop the control loop and the motors.
+ * @param none
+ * @return none
+ * @brief Stop wheel speed control
+ */
+void SpeedControl_Stop(void);
+
+#endif /* SPEEDCONTROL_H_ */
@@ -48,32 +48,104 @@ policies, either expressed or implied, of the FreeBSD Project.
 // external signal connected to P10.4 (TA3CCP0) (trigger on rising edge)
 
 #include <stdint.h>
+#include "../inc/CortexM.h"
 #include "msp.h"
 
-void ta3dummy(uint16_t t){};       // dummy function
-void (*CaptureTask0)(uint16_t time) = ta3dummy;// user function
-void (*CaptureTask2)(uint16_t time) = ta3dummy;// user function
+static void ta3dummy(uint32_t t){};       // dummy function
+static void (*CaptureTask0)(uint32_t time) = ta3dummy;// user function
+static void (*CaptureTask2)(uint32_t time) = ta3dummy;// user function
+static volatile uint16_t Overflows;       // upper 16 bits of the extended time
+
+// Extend a 16-bit capture to 32 bits.  If the counter wrapped but
+// TA3_N has not counted it yet, TAIFG is still set; a capture in the
+// lower half of the range was then taken after the wrap.
+// Called only from the priority 2 Timer A3 handlers, which cannot
+// preempt each other.
+static uint32_t extend(uint16_t capture){
+  uint16_t high = Overflows;
+  if((TIMER_A3->CTL&0x0001) && (capture < 0x8000)){
+    high = high + 1;
+  }
+  return ((uint32_t)high<<16)|capture;
+}
 
 //------------TimerA3Capture_Init------------
 // Initialize Timer A3 in edge time mode to request interrupts on
 // the rising edges of P10.4 (TA3CCP0) and P8.2 (TA3CCP2).  The
 // interrupt service routines acknowledge the interrupt and call
-// a user function.
+// a user function.  Counter rollovers are counted in the TA3_N
+// interrupt so the times passed to the user functions are 32 bits.
 // Input: task0 is a pointer to a user function called when P10.4 (TA3CCP0) edge occurs
-//              parameter is 16-bit up-counting timer value when P10.4 (TA3CCP0) edge occurred (units of 0.083 usec)
+//              parameter is 32-bit up-counting timer value when P10.4 (TA3CCP0) edge occurred (units of 0.083 usec)
 //        task2 is a pointer to a user function called when P8.2 (TA3CCP2) edge occurs
-//              parameter is 16-bit up-counting timer value when P8.2 (TA3CCP2) edge occurred (units of 0.083 usec)
+//              parameter is 32-bit up-counting timer value when P8.2 (TA3CCP2) edge occurred (units of 0.083 usec)
 // Output: none
 // Assumes: low-speed subsystem master clock is 12 MHz
-void TimerA3Capture_Init(void(*task0)(uint16_t time), void(*task2)(uint16_t time)){
-  // write this as part of lab 16
+void TimerA3Capture_Init(void(*task0)(uint32_t time), void(*task2)(uint32_t time)){long sr;
+  sr = StartCritical();
+  CaptureTask0 = task0;            // user functions
+  CaptureTask2 = task2;
+  Overflows = 0;
+  // initialize P10.4 and make it rising edge (P10.4 TA3CCP0)
+  P10->SEL0 |= 0x10;
+  P10->SEL1 &= ~0x10;              // configure P10.4 as TA3CCP0
+  P10->DIR &= ~0x10;               // make P10.4 in
+  // initialize P8.2 and make it rising edge (P8.2 TA3CCP2)
+  P8->SEL0 |= 0x04;
+  P8->SEL1 &= ~0x04;               // configure P8.2 as TA3CCP2
+  P8->DIR &= ~0x04;                // make P8.2 in
+  TIMER_A3->CTL &= ~0x0030;        // halt Timer A3
+  // bits15-10=XXXXXX, reserved
+  // bits9-8=10,       clock source to SMCLK
+  // bits7-6=00,       input clock divider /1
+  // bits5-4=00,       stop mode
+  // bit3=X,           reserved
+  // bit2=0,           set this bit to clear
+  // bit1=0,           interrupt disable
+  // bit0=0,           clear interrupt pending
+  TIMER_A3->CTL = 0x0200;
+  // bits15-14=01,     capture on rising edge
+  // bits13-12=00,     capture/compare input on CCI0A
+  // bit11=1,          synchronous capture source
+  // bit10=X,          synchronized capture/compare input
+  // bit9=X,           reserved
+  // bit8=1,           capture mode
+  // bits7-5=XXX,      output mode
+  // bit4=1,           enable capture/compare interrupt
+  // bit3=X,           read capture/compare input from here
+  // bit2=X,           output this value in output mode 0
+  // bit1=X,           capture overflow status
+  // bit0=0,           clear capture/compare interrupt pending
+  TIMER_A3->CCTL[0] = 0x4910;
+  TIMER_A3->CCTL[2] = 0x4910;      // same for CCI2A
+  TIMER_A3->EX0 &= ~0x0007;        // configure for input clock divider /1
+  NVIC->IP[3] = (NVIC->IP[3]&0x0000FFFF)|0x40400000; // priority 2
+// interrupts enabled in the main program after all devices initialized
+  NVIC->ISER[0] = 0x0000C000;      // enable interrupts 14 and 15 in NVIC
+  // bits15-10=XXXXXX, reserved
+  // bits9-8=10,       clock source to SMCLK
+  // bits7-6=00,       input clock divider /1
+  // bits5-4=10,       continuous count up mode
+  // bit3=X,           reserved
+  // bit2=1,           set this bit to clear
+  // bit1=1,           interrupt enable on rollover
+  // bit0=0,           clear interrupt pending
+  TIMER_A3->CTL |= 0x0026;         // reset and start Timer A3 in continuous up mode
+  EndCritical(sr);
 }
 
 void TA3_0_IRQHandler(void){
-  // write this as part of lab 16
+  TIMER_A3->CCTL[0] &= ~0x0001;    // acknowledge capture/compare interrupt 0
+  (*CaptureTask0)(extend(TIMER_A3->CCR[0]));// execute user task
 }
 
 void TA3_N_IRQHandler(void){
-  // write this as part of lab 16
+  if(TIMER_A3->CCTL[2]&0x0001){
+    TIMER_A3->CCTL[2] &= ~0x0001;  // acknowledge capture/compare interrupt 2
+    (*CaptureTask2)(extend(TIMER_A3->CCR[2]));// execute user task
+  }
+  if(TIMER_A3->CTL&0x0001){
+    TIMER_A3->CTL &= ~0x0001;      // acknowledge rollover
+    Overflows = Overflows + 1;
+  }
 }
-
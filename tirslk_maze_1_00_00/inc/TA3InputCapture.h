@@ -3,6 +3,8 @@
  * @brief     Initialize Timer A3
  * @details   Use Timer A3 in capture mode to request interrupts on rising
  * edges of P10.4 (TA3CCP0) and P8.2 (TA3CCP2) and call user functions.
+ * Timer rollovers are counted to extend the 16-bit captures to 32 bits,
+ * so periods up to 358 seconds are measured without aliasing.
  * @version   V1.0
  * @author    Valvano
  * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
@@ -61,15 +63,15 @@ policies, either expressed or implied, of the FreeBSD Project.
  * Initialize Timer A3 in edge time mode to request interrupts on
  * the rising edges of P10.4 (TA3CCP0) and P8.2 (TA3CCP2).  The
  * interrupt service routines acknowledge the interrupt and call
- * a user function.
+ * a user function.  Rollovers are counted so the times are 32 bits.
  * @param task0 is a pointer to a user function called when P10.4 (TA3CCP0) edge occurs<br>
- *        parameter is 16-bit up-counting timer value when P10.4 (TA3CCP0) edge occurred (units of 0.083 usec)<br>
+ *        parameter is 32-bit up-counting timer value when P10.4 (TA3CCP0) edge occurred (units of 0.083 usec)<br>
  * @param task2 is a pointer to a user function called when P8.2 (TA3CCP2) edge occurs<br>
- *        parameter is 16-bit up-counting timer value when P8.2 (TA3CCP2) edge occurred (units of 0.083 usec)
+ *        parameter is 32-bit up-counting timer value when P8.2 (TA3CCP2) edge occurred (units of 0.083 usec)
  * @return none
  * @note  Assumes low-speed subsystem master clock is 12 MHz
  * @brief  Initialize Timer A3
  */
-void TimerA3Capture_Init(void(*task0)(uint16_t time), void(*task2)(uint16_t time));
+void TimerA3Capture_Init(void(*task0)(uint32_t time), void(*task2)(uint32_t time));
 
 #endif /* TA3INPUTCAPTURE_H_ */
@@ -59,14 +59,41 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include "msp.h"
 #include "Tachometer.h"
 
-uint16_t Tachometer_FirstRightTime, Tachometer_SecondRightTime;
-uint16_t Tachometer_FirstLeftTime, Tachometer_SecondLeftTime;
+uint32_t Tachometer_FirstRightTime, Tachometer_SecondRightTime;
+uint32_t Tachometer_FirstLeftTime, Tachometer_SecondLeftTime;
 int Tachometer_RightSteps = 0;     // incremented with every step forward; decremented with every step backward
 int Tachometer_LeftSteps = 0;      // incremented with every step forward; decremented with every step backward
 enum TachDirection Tachometer_RightDir = STOPPED;
 enum TachDirection Tachometer_LeftDir = STOPPED;
 
-void tachometerRightInt(uint16_t currenttime){
+// The capture handlers own the globals above.  After each edge they
+// copy all of them into the spare half of a double buffer and then
+// increment Sequence to publish it.  A reader copies the half selected
+// by Sequence and retries if Sequence moved, so it never sees a period
+// from one edge with the step count of another.  Neither side disables
+// interrupts, and a reader that preempts a capture handler still reads
+// the last complete half instead of spinning.  Both halves are volatile
+// so neither side can move the copy across its access to Sequence.
+struct tachsnapshot{
+  uint32_t leftTach, rightTach;
+  int32_t leftSteps, rightSteps;
+  enum TachDirection leftDir, rightDir;
+};
+static volatile struct tachsnapshot Snapshot[2];
+static volatile uint32_t Sequence;
+
+static void publish(void){
+  volatile struct tachsnapshot *s = &Snapshot[(Sequence + 1)&1];
+  s->leftTach = Tachometer_SecondLeftTime - Tachometer_FirstLeftTime;
+  s->leftDir = Tachometer_LeftDir;
+  s->leftSteps = Tachometer_LeftSteps;
+  s->rightTach = Tachometer_SecondRightTime - Tachometer_FirstRightTime;
+  s->rightDir = Tachometer_RightDir;
+  s->rightSteps = Tachometer_RightSteps;
+  Sequence = Sequence + 1;       // publish last
+}
+
+void tachometerRightInt(uint32_t currenttime){
   Tachometer_FirstRightTime = Tachometer_SecondRightTime;
   Tachometer_SecondRightTime = currenttime;
   if((P10->IN&0x20) == 0){
@@ -78,9 +105,10 @@ void tachometerRightInt(uint16_t currenttime){
     Tachometer_RightSteps = Tachometer_RightSteps + 1;
     Tachometer_RightDir = FORWARD;
   }
+  publish();
 }
 
-void tachometerLeftInt(uint16_t currenttime){
+void tachometerLeftInt(uint32_t currenttime){
   Tachometer_FirstLeftTime = Tachometer_SecondLeftTime;
   Tachometer_SecondLeftTime = currenttime;
   if((P9->IN&0x04) == 0){
@@ -92,6 +120,7 @@ void tachometerLeftInt(uint16_t currenttime){
     Tachometer_LeftSteps = Tachometer_LeftSteps + 1;
     Tachometer_LeftDir = FORWARD;
   }
+  publish();
 }
 
 // ------------Tachometer_Init------------
@@ -102,6 +131,11 @@ void tachometerLeftInt(uint16_t currenttime){
 // Input: none
 // Output: none
 void Tachometer_Init(void){
+  Tachometer_FirstRightTime = Tachometer_SecondRightTime = 0;
+  Tachometer_FirstLeftTime = Tachometer_SecondLeftTime = 0;
+  Tachometer_RightSteps = Tachometer_LeftSteps = 0;
+  Tachometer_RightDir = Tachometer_LeftDir = STOPPED;
+  publish();
   // initialize P9.2 and make it GPIO
   P9->SEL0 &= ~0x04;
   P9->SEL1 &= ~0x04;               // configure P9.2 as GPIO
@@ -122,14 +156,22 @@ void Tachometer_Init(void){
 //        rightDir   is pointer to store enumerated direction of last movement of right wheel
 //        rightSteps is pointer to store total number of forward steps measured for right wheel (360 steps per ~220 mm circumference)
 // Output: none
+// All six values come from the same edge; safe to call from main or
+// from any interrupt, without disabling interrupts.
 // Assumes: Tachometer_Init() has been called
 // Assumes: Clock_Init48MHz() has been called
-void Tachometer_Get(uint16_t *leftTach, enum TachDirection *leftDir, int32_t *leftSteps,
-                    uint16_t *rightTach, enum TachDirection *rightDir, int32_t *rightSteps){
-  *leftTach = (Tachometer_SecondLeftTime - Tachometer_FirstLeftTime);
-  *leftDir = Tachometer_LeftDir;
-  *leftSteps = Tachometer_LeftSteps;
-  *rightTach = (Tachometer_SecondRightTime - Tachometer_FirstRightTime);
-  *rightDir = Tachometer_RightDir;
-  *rightSteps = Tachometer_RightSteps;
+void Tachometer_Get(uint32_t *leftTach, enum TachDirection *leftDir, int32_t *leftSteps,
+                    uint32_t *rightTach, enum TachDirection *rightDir, int32_t *rightSteps){
+  const volatile struct tachsnapshot *s;
+  uint32_t sequence;
+  do{
+    sequence = Sequence;
+    s = &Snapshot[sequence&1];
+    *leftTach = s->leftTach;
+    *leftDir = s->leftDir;
+    *leftSteps = s->leftSteps;
+    *rightTach = s->rightTach;
+    *rightDir = s->rightDir;
+    *rightSteps = s->rightSteps;
+  }while(sequence != Sequence);
 }
@@ -91,7 +91,11 @@ enum TachDirection{
 void Tachometer_Init(void);
 
 /**
- * Get the most recent tachometer measurements.
+ * Get the most recent tachometer measurements.  The periods are
+ * 32 bits, so they stay correct when the wheel turns slowly and an
+ * encoder step takes longer than the 5.46 ms rollover of the timer.
+ * All six values come from the same encoder edge, even if an edge
+ * interrupt occurs during the call; interrupts are not disabled.
  * @param leftTach is pointer to store last measured tachometer period of left wheel (units of 0.083 usec)
  * @param leftDir is pointer to store enumerated direction of last movement of left wheel
  * @param leftSteps is pointer to store total number of forward steps measured for left wheel (360 steps per ~220 mm circumference)
@@ -103,7 +107,7 @@ void Tachometer_Init(void);
  * @note Assumes Clock_Init48MHz() has been called
  * @brief Get the most recent tachometer measurement
  */
-void Tachometer_Get(uint16_t *leftTach, enum TachDirection *leftDir, int32_t *leftSteps,
-                    uint16_t *rightTach, enum TachDirection *rightDir, int32_t *rightSteps);
+void Tachometer_Get(uint32_t *leftTach, enum TachDirection *leftDir, int32_t *leftSteps,
+                    uint32_t *rightTach, enum TachDirection *rightDir, int32_t *rightSteps);
 
 #endif /* TACHOMETER_H_ */
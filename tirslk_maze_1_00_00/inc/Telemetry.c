@@ -0,0 +1,322 @@
+// Telemetry.c
+// Runs on MSP432
+// Delta-encoded, rate-adapted telemetry stream packed into
+// full-size BLE notifications of one characteristic.
+// Daniel and Jonathan Valvano
+// October 17, 2026
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+// One NPI frame carries up to 20 bytes, so a six-field sample that
+// changes slowly costs about 6 bytes instead of six frames.
+
+#include <stdint.h>
+#include "../inc/AP.h"
+#include "../inc/FIFO.h"
+#include "../inc/Telemetry.h"
+
+#define NOSTART 31        // offset field when no sample starts in the notification
+#define HEADER 2          // bytes before the samples
+
+struct telemetrypacket{
+  uint8_t length;
+  uint8_t data[APNOTIFYMAX];
+};
+AddIndexFifo(TelemetryPacket, TELEMETRY_PACKETS, struct telemetrypacket)
+
+static uint32_t Index;       // notify characteristic of the stream
+static uint32_t Fields;      // fields per sample
+static uint32_t Period;      // us between calls to Telemetry_Put
+static uint8_t Value;        // characteristic value, not used
+static volatile uint32_t Restart;  // 1 when the CCCD was written
+static int32_t Last[TELEMETRY_MAXFIELDS];  // previous encoded sample
+static uint32_t SkipCode;    // send every 2^SkipCode-th sample
+static uint32_t Count;       // sample periods since the previous encoded sample
+static uint32_t Sequence;    // of the next notification
+static uint32_t NeedKey;     // 1 if the next notification must be absolute
+static struct telemetrypacket Build;  // notification being filled
+static uint32_t BuildKey;    // 1 if Build is absolute
+static uint32_t BuildAge;    // calls to Telemetry_Put since Build was started
+static struct telemetrypacket Current;// notification being sent
+static uint32_t HaveCurrent; // 1 if Current is waiting for the SNP
+static uint32_t InFlight;    // 1 if Current is queued in AP
+static uint32_t Burst;       // notifications per connection interval, 1/8 units
+static uint32_t Credit;      // token bucket, 1/8 notification*us
+static uint32_t Samples, Packets;
+
+// start a notification; decimation only changes here, so every
+// sample starting in a notification has the same spacing
+static void start(void){
+  uint32_t backlog = TelemetryPacket_Size() + HaveCurrent;  // including the one just finished
+  if((backlog > TELEMETRY_PACKETS/2) && ((1u<<SkipCode) < TELEMETRY_MAXSKIP)){
+    SkipCode = SkipCode + 1;     // backing up, send half as many samples
+  }else if((backlog <= 1) && SkipCode){
+    SkipCode = SkipCode - 1;     // keeping up
+  }
+  BuildKey = NeedKey || ((Sequence%TELEMETRY_KEYFRAME) == 0);
+  NeedKey = 0;
+  Build.data[0] = (BuildKey<<7)|(Sequence&0x7F);
+  Build.data[1] = (NOSTART<<3)|SkipCode;
+  Build.length = HEADER;
+  BuildAge = 0;
+  Sequence = Sequence + 1;
+}
+
+static void finish(void){
+  if(BuildKey && ((Build.data[1]>>3) == NOSTART)){
+    NeedKey = 1;                 // no sample to resynchronize on
+  }
+  if(TelemetryPacket_Put(Build) == FIFOFAIL){
+    NeedKey = 1;                 // dropped, receiver sees the gap
+  }
+}
+
+static void append(uint8_t data){
+  Build.data[Build.length] = data;
+  Build.length = Build.length + 1;
+  if(Build.length == APNOTIFYMAX){
+    finish();
+    start();
+  }
+}
+
+// zigzag varint: sign in bit 0, then 7 bits per byte, low first,
+// bit 7 set on all but the last byte
+static void encode(int32_t n){
+  uint32_t z = ((uint32_t)n<<1)^(uint32_t)(n>>31);
+  while(z >= 0x80){
+    append((z&0x7F)|0x80);
+    z = z>>7;
+  }
+  append(z);
+}
+
+static void reset(void){
+  TelemetryPacket_Init();
+  SkipCode = 0;
+  Count = 0;
+  NeedKey = 1;
+  HaveCurrent = 0;
+  InFlight = 0;
+  Burst = 8*TELEMETRY_MAXBURST/2;
+  Credit = 0;
+  Samples = Packets = 0;
+  start();
+}
+
+// AP_BackgroundProcess calls this with the SNP response to a notification
+static void sent(int result, uint8_t *frame){
+  InFlight = 0;
+  if((result == APOK) && (frame[5] == 0)){  // SNP status success
+    HaveCurrent = 0;
+    Packets = Packets + 1;
+    if(Burst < 8*TELEMETRY_MAXBURST){
+      Burst = Burst + 1;
+    }
+  }else{                         // refused or lost, send Current again
+    Burst = Burst - Burst/4;
+    if(Burst < 4){
+      Burst = 4;                 // 1 every other interval
+    }
+  }
+}
+
+static void cccd(void){
+  Restart = 1;
+}
+
+// ------------Telemetry_Init------------
+// Add the telemetry notify characteristic.
+// Input: uuid is 0xFFF0, 0xFFF1, ...
+//        name is a null-terminated string, maximum length of name is 20 bytes
+//        fields per sample, 1 to TELEMETRY_MAXFIELDS
+//        period is the time between calls to Telemetry_Put in us
+// Output: APOK if successful, APFAIL on bad parameters or SNP failure
+int Telemetry_Init(uint16_t uuid, char name[], uint32_t fields, uint32_t period){
+  if((fields == 0) || (fields > TELEMETRY_MAXFIELDS) || (period == 0)) return APFAIL;
+  Fields = fields;
+  Period = period;
+  Sequence = 0;
+  Restart = 1;
+  Index = AP_GetNotifyCount();
+  return AP_AddNotifyCharacteristic(uuid, 1, &Value, name, &cccd);
+}
+
+// ------------Telemetry_Put------------
+// Add one sample to the stream and send what the link allows.
+// Input: fields is a pointer to the values
+// Output: none
+void Telemetry_Put(const int32_t *fields){
+  uint32_t interval, cost, i;
+  int absolute;
+  if(AP_GetNotifyCCCD(Index) == 0) return;  // nobody listening
+  if(Restart){
+    Restart = 0;
+    reset();
+  }
+  interval = AP_GetConnectionInterval();
+  if(interval == 0){
+    interval = TELEMETRY_INTERVAL;
+  }
+  cost = 8*1250*interval;        // one notification, 1/8 notification*us
+  Credit = Credit + Burst*Period;
+  if(Credit > Burst*1250*interval){
+    Credit = Burst*1250*interval;// at most one interval of notifications
+  }
+  Count = Count + 1;
+  BuildAge = BuildAge + 1;
+  if(Count >= (1u<<SkipCode)){
+    Count = 0;
+    absolute = 0;
+    if((Build.data[1]>>3) == NOSTART){
+      Build.data[1] = ((Build.length - HEADER)<<3)|SkipCode;
+      absolute = BuildKey;
+    }
+    for(i=0; i<Fields; i++){
+      encode(absolute? fields[i] : (int32_t)((uint32_t)fields[i] - (uint32_t)Last[i]));
+      Last[i] = fields[i];
+    }
+    Samples = Samples + 1;
+  }
+  // link idle for an interval: send a partial notification, right
+  // after a sample so the spacing of the next one stays 2^SkipCode
+  if((Count == 0) && (Build.length > HEADER) && (InFlight == 0) && (HaveCurrent == 0) &&
+     (TelemetryPacket_Size() == 0) && (BuildAge*Period >= 1250*interval)){
+    finish();
+    start();
+  }
+  if(InFlight) return;
+  if(HaveCurrent == 0){
+    if(TelemetryPacket_Get(&Current) == FIFOFAIL) return;
+    HaveCurrent = 1;
+  }
+  if(Credit < cost) return;
+  if(AP_SendNotificationData(Index, Current.data, Current.length, &sent) == APOK){
+    InFlight = 1;
+    Credit = Credit - cost;
+  }
+}
+
+// ------------Telemetry_Stats------------
+// Return counts of the telemetry stream since it was subscribed.
+// Input: samples, packets and skip are pointers to return
+//        samples encoded, notifications accepted, and decimation
+// Output: none
+void Telemetry_Stats(uint32_t *samples, uint32_t *packets, uint32_t *skip){
+  *samples = Samples;
+  *packets = Packets;
+  *skip = 1u<<SkipCode;
+}
+
+// ------------Telemetry_DecodeInit------------
+// Prepare to decode a telemetry stream.
+// Input: d is a pointer to the receiver state
+//        fields per sample
+// Output: none
+void Telemetry_DecodeInit(struct TelemetryDecoder *d, uint32_t fields){
+  uint32_t i;
+  d->fields = fields;
+  d->sequence = 0;
+  d->synced = 0;
+  d->field = d->value = d->shift = 0;
+  d->absolute = 0;
+  d->skip = 0;
+  for(i=0; i<TELEMETRY_MAXFIELDS; i++){
+    d->last[i] = 0;
+  }
+}
+
+// ------------Telemetry_Decode------------
+// Decode one notification.
+// Input: d is a pointer to the receiver state
+//        packet and length are the notification
+//        sample is a user function called with each complete sample (0 for none)
+// Output: number of samples completed
+uint32_t Telemetry_Decode(struct TelemetryDecoder *d, const uint8_t *packet, uint32_t length,
+  void(*sample)(const int32_t *fields, uint32_t skip)){
+  uint32_t key, sequence, offset, skip, i, count = 0, resync = 0;
+  int32_t n;
+  if((length < HEADER) || (d->fields == 0) || (d->fields > TELEMETRY_MAXFIELDS)) return 0;
+  key = packet[0]>>7;
+  sequence = packet[0]&0x7F;
+  offset = packet[1]>>3;
+  skip = 1u<<(packet[1]&0x07);
+  if(sequence != d->sequence){
+    d->synced = 0;               // lost one
+  }
+  d->sequence = (sequence + 1)&0x7F;
+  i = HEADER;
+  if(d->synced == 0){
+    if((key == 0) || (offset == NOSTART)) return 0;
+    d->synced = 1;
+    resync = 1;                  // spacing before this sample is unknown
+    i = HEADER + offset;
+  }
+  for(; i<length; i++){
+    if((i - HEADER) == offset){  // a sample starts here
+      d->field = d->value = d->shift = 0;
+      d->absolute = key;
+      d->skip = resync? 0 : skip;
+    }else if((d->field == 0) && (d->shift == 0)){
+      d->absolute = 0;
+      d->skip = skip;
+    }
+    d->value |= (uint32_t)(packet[i]&0x7F)<<d->shift;
+    if(packet[i]&0x80){
+      d->shift = d->shift + 7;
+      if(d->shift > 28){
+        d->synced = 0;           // not a 32-bit varint
+        return count;
+      }
+      continue;
+    }
+    n = (int32_t)((d->value>>1)^(0u - (d->value&1)));
+    d->last[d->field] = d->absolute? n : (int32_t)((uint32_t)d->last[d->field] + (uint32_t)n);
+    d->value = d->shift = 0;
+    d->field = d->field + 1;
+    if(d->field == d->fields){
+      d->field = 0;
+      count = count + 1;
+      if(sample){
+        (*sample)(d->last, d->skip);   // execute user task
+      }
+    }
+  }
+  return count;
+}
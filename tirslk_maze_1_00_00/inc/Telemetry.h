@@ -0,0 +1,177 @@
+/**
+ * @file      Telemetry.h
+ * @brief     Stream many sensor fields over one BLE notify characteristic
+ * @details   Each sample is a fixed number of signed 32-bit fields, such
+ * as time, pose and wheel speeds.  Samples are delta encoded against
+ * the previous sample and written as zigzag varints, so small changes
+ * take one byte per field.  The byte stream is cut into notifications
+ * of APNOTIFYMAX bytes, which a sample may straddle.<br>
+ 1) Notifications are paced by a token bucket that refills at a rate
+    of notifications per connection interval<br>
+ 2) The rate grows by 1/8 notification per interval with each
+    notification the SNP accepts, and drops by 1/4 when one is refused<br>
+ 3) When the notifications back up, only every 2nd, 4th, ... sample is
+    sent, and the rate is restored when they drain<br>
+ 4) Every TELEMETRY_KEYFRAME-th notification restarts with absolute
+    values, so a receiver that misses one recovers quickly<br>
+ * @version   V1.0
+ * @author    Valvano
+ * @copyright Copyright 2017 by Jonathan W. Valvano, valvano@mail.utexas.edu,
+ * @warning   AS-IS
+ * @note      For more information see  http://users.ece.utexas.edu/~valvano/
+ * @date      October 17, 2026
+ *
+<table>
+<caption id="Telemetry_format">Notification format</caption>
+<tr><th>Byte   <th>Bits    <th>Meaning
+<tr><td>0      <td>7       <td>1 if the first sample starting here is absolute, 0 if all are deltas
+<tr><td>0      <td>6-0     <td>sequence number, modulo 128
+<tr><td>1      <td>7-3     <td>offset of the first sample starting here, 31 for none
+<tr><td>1      <td>2-0     <td>n, samples starting here are 2^n sample periods apart
+<tr><td>2-19   <td>-       <td>zigzag varints, one per field, continuing the previous notification
+</table>
+ ******************************************************************************/
+
+/* This example accompanies the books
+   "Embedded Systems: Introduction to the MSP432 Microcontroller",
+       ISBN: 978-1512185676, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Interfacing to the MSP432 Microcontroller",
+       ISBN: 978-1514676585, Jonathan Valvano, copyright (c) 2017
+   "Embedded Systems: Real-Time Operating Systems for ARM Cortex-M Microcontrollers",
+       ISBN: 978-1466468863, , Jonathan Valvano, copyright (c) 2017
+ For more information about my classes, my research, and my books, see
+ http://users.ece.utexas.edu/~valvano/
+
+Simplified BSD License (FreeBSD License)
+Copyright (c) 2017, Jonathan Valvano, All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are
+those of the authors and should not be interpreted as representing official
+policies, either expressed or implied, of the FreeBSD Project.
+*/
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+/**
+ * \brief most fields in one sample
+ */
+#define TELEMETRY_MAXFIELDS 8
+
+/**
+ * \brief notifications waiting to be sent (must be power of 2, holds one less)
+ */
+#define TELEMETRY_PACKETS 8
+
+/**
+ * \brief every TELEMETRY_KEYFRAME-th notification starts a sample with absolute values
+ */
+#define TELEMETRY_KEYFRAME 16
+
+/**
+ * \brief largest decimation, send every TELEMETRY_MAXSKIP-th sample (power of 2, at most 128)
+ */
+#define TELEMETRY_MAXSKIP 64
+
+/**
+ * \brief most notifications sent per connection interval
+ */
+#define TELEMETRY_MAXBURST 6
+
+/**
+ * \brief connection interval assumed until the SNP reports one, 1.25 ms units
+ */
+#define TELEMETRY_INTERVAL 24
+
+/**
+ * \brief receiver state for Telemetry_Decode()
+ */
+struct TelemetryDecoder{
+  uint32_t fields;     /**< fields per sample */
+  uint32_t sequence;   /**< sequence number expected next */
+  uint32_t synced;     /**< 1 once an absolute sample has been seen since the last loss */
+  uint32_t field;      /**< field being decoded */
+  uint32_t value;      /**< varint being decoded */
+  uint32_t shift;      /**< bits of value decoded so far */
+  uint32_t absolute;   /**< 1 if the sample being decoded is absolute */
+  uint32_t skip;       /**< sample periods before the sample being decoded */
+  int32_t last[TELEMETRY_MAXFIELDS]; /**< most recent sample */
+};
+
+/**
+ * Add the telemetry notify characteristic.  Call it with the other
+ * characteristics, after AP_AddService() and before AP_RegisterService().
+ * @param uuid is 0xFFF0, 0xFFF1, ...
+ * @param name is a null-terminated string, maximum length of name is 20 bytes
+ * @param fields is the number of fields in each sample, 1 to TELEMETRY_MAXFIELDS
+ * @param period is the time between calls to Telemetry_Put() in us
+ * @return APOK if successful, APFAIL if the parameters are bad or if AP_AddNotifyCharacteristic() fails
+ * @brief Initialize the telemetry stream
+ */
+int Telemetry_Init(uint16_t uuid, char name[], uint32_t fields, uint32_t period);
+
+/**
+ * Add one sample to the stream and send what the link allows.
+ * Samples are discarded while the characteristic is not subscribed.
+ * @param fields pointer to the values, as many as given to Telemetry_Init()
+ * @return none
+ * @note Call every period from the same loop as AP_BackgroundProcess(), not from an interrupt
+ * @brief Stream one sample
+ */
+void Telemetry_Put(const int32_t *fields);
+
+/**
+ * Return counts of the telemetry stream since it was subscribed.
+ * @param samples pointer to return the number of samples encoded
+ * @param packets pointer to return the number of notifications accepted by the SNP
+ * @param skip pointer to return the present decimation, 1 if every sample is sent
+ * @return none
+ * @brief Get telemetry statistics
+ */
+void Telemetry_Stats(uint32_t *samples, uint32_t *packets, uint32_t *skip);
+
+/**
+ * Prepare to decode a telemetry stream.  Does not use the hardware,
+ * so it also runs on a central or a PC.
+ * @param d pointer to the receiver state
+ * @param fields the number of fields in each sample
+ * @return none
+ * @brief Initialize a telemetry decoder
+ */
+void Telemetry_DecodeInit(struct TelemetryDecoder *d, uint32_t fields);
+
+/**
+ * Decode one notification.  After a lost notification, samples are
+ * ignored until one with absolute values arrives.
+ * @param d pointer to the receiver state
+ * @param packet pointer to the notification
+ * @param length number of bytes in the notification
+ * @param sample user function called with each complete sample and
+ * the number of sample periods since the previous one (0 for none)
+ * @return number of samples completed by this notification
+ * @brief Decode one telemetry notification
+ */
+uint32_t Telemetry_Decode(struct TelemetryDecoder *d, const uint8_t *packet, uint32_t length,
+  void(*sample)(const int32_t *fields, uint32_t skip));
+
+#endif /* TELEMETRY_H_ */
@@ -50,14 +50,17 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include <stdio.h>
 #include "UART0.h"
+#include "../inc/Baud.h"
+#include "../inc/Format.h"
 #include "msp.h"
 
-//------------UART0_Init------------
-// Initialize the UART for 115,200 baud rate (assuming 12 MHz SMCLK clock),
+//------------UART0_InitRate------------
+// Initialize the UART for any baud rate (assuming 12 MHz SMCLK clock),
 // 8 bit word length, no parity bits, one stop bit
-// Input: none
+// Input: brw   UCA0BRW, see BAUD_BRW() in Baud.h
+//        mctlw UCA0MCTLW, see BAUD_MCTLW() in Baud.h
 // Output: none
-void UART0_Init(void){
+void UART0_InitRate(uint16_t brw, uint16_t mctlw){
   EUSCI_A0->CTLW0 = 0x0001;                   // hold the USCI module in reset mode
   // bit15=0,      no parity bits
   // bit14=x,      not used when parity is disabled
@@ -73,16 +76,25 @@ void UART0_Init(void){
   // bit1=0,       do not transmit break (not used here)
   // bit0=1,       hold logic in reset state while configuring
   EUSCI_A0->CTLW0 = 0x00C1;
-                                 // set the baud rate
-                                 // N = clock/baud rate = 12,000,000/115,200 = 104.1667
-  EUSCI_A0->BRW = 104;           // UCBR = baud rate = int(N) = 104
-  EUSCI_A0->MCTLW &= ~0xFFF1;    // clear first and second modulation stage bit fields
+  EUSCI_A0->BRW = brw;           // UCBRx, the integer part of the divider
+  EUSCI_A0->MCTLW = mctlw;       // UCBRSx, UCBRFx and UCOS16
   P1->SEL0 |= 0x0C;
   P1->SEL1 &= ~0x0C;             // configure P1.3 and P1.2 as primary module function
   EUSCI_A0->CTLW0 &= ~0x0001;    // enable the USCI module
   EUSCI_A0->IE &= ~0x000F;       // disable interrupts (transmit ready, start received, transmit empty, receive full)
 }
 
+//------------UART0_Init------------
+// Initialize the UART for 115,200 baud rate (assuming 12 MHz SMCLK clock),
+// 8 bit word length, no parity bits, one stop bit
+// Input: none
+// Output: none
+void UART0_Init(void){
+  // N = clock/baud rate = 12,000,000/115,200 = 104.1667
+  // UCBRx = INT(N/16) = 6, UCBRFx = 8, UCBRSx = 0x20 for the 0.1667
+  UART0_InitBaud(115200);
+}
+
 //------------UART0_InChar------------
 // Wait for new serial port input
 // Input: none
@@ -150,121 +162,55 @@ char character;
 // Output: none
 // Variable format 1-10 digits with no space before or after
 void UART0_OutUDec(uint32_t n){
-// This function uses recursion to convert decimal number
-//   of unspecified length as an ASCII string
-  if(n >= 10){
-    UART0_OutUDec(n/10);
-    n = n%10;
-  }
-  UART0_OutChar(n+'0'); /* n is between 0 and 9 */
-}
-uint32_t Messageindexb;
-char Messageb[8];
-void static fillmessageb(uint32_t n){
-// This function uses recursion to convert decimal number
-//   of unspecified length as an ASCII string
-  if(n >= 10){
-    fillmessageb(n/10);
-    n = n%10;
-  }
-  Messageb[Messageindexb] = (n+'0'); /* n is between 0 and 9 */
-  if(Messageindexb<7)Messageindexb++;
-}
-void static fillmessage4b(uint32_t n){
-  if(n>=1000){  // 1000 to 9999
-    Messageindexb = 0;
-  } else if(n>=100){  // 100 to 999
-    Messageb[0] = ' ';
-    Messageindexb = 1;
-  }else if(n>=10){ //
-    Messageb[0] = ' '; /* n is between 10 and 99 */
-    Messageb[1] = ' ';
-    Messageindexb = 2;
-  }else{
-    Messageb[0] = ' '; /* n is between 0 and 9 */
-    Messageb[1] = ' ';
-    Messageb[2] = ' ';
-    Messageindexb = 3;
-  }
-  fillmessageb(n);
-}
-void static fillmessage5b(uint32_t n){
-  if(n>99999)n=99999;
-  if(n>=10000){  // 10000 to 99999
-    Messageindexb = 0;
-  } else if(n>=1000){  // 1000 to 9999
-    Messageb[0] = ' ';
-    Messageindexb = 1;
-  }else if(n>=100){  // 100 to 999
-    Messageb[0] = ' ';
-    Messageb[1] = ' ';
-    Messageindexb = 2;
-  }else if(n>=10){ //
-    Messageb[0] = ' '; /* n is between 10 and 99 */
-    Messageb[1] = ' ';
-    Messageb[2] = ' ';
-    Messageindexb = 3;
-  }else{
-    Messageb[0] = ' '; /* n is between 0 and 9 */
-    Messageb[1] = ' ';
-    Messageb[2] = ' ';
-    Messageb[3] = ' ';
-    Messageindexb = 4;
-  }
-  fillmessageb(n);
+  char buf[FORMAT_SIZE];
+  Format_UDec(buf, n, 0);
+  UART0_OutString(buf);
 }
+
 //-----------------------UART0_OutUDec4-----------------------
 // Output a 32-bit number in unsigned decimal format
 // Input: 32-bit number to be transferred
 // Output: none
 // Fixed format 4 digits with no space before or after
 void UART0_OutUDec4(uint32_t n){
-  if(n>9999){
-    UART0_OutString("****");
-  }else{
-    Messageindexb = 0;
-    fillmessage4b(n);
-    Messageb[Messageindexb] = 0; // terminate
-    UART0_OutString(Messageb);
-  }
+  char buf[FORMAT_SIZE];
+  Format_UDec(buf, n, 4);       // "****" above 9999
+  UART0_OutString(buf);
 }
+
 //-----------------------UART0_OutUDec5-----------------------
 // Output a 32-bit number in unsigned decimal format
 // Input: 32-bit number to be transferred
 // Output: none
 // Fixed format 5 digits with no space before or after
 void UART0_OutUDec5(uint32_t n){
-  if(n>99999){
-    UART0_OutString("*****");
-  }else{
-    Messageindexb = 0;
-    fillmessage5b(n);
-    Messageb[Messageindexb] = 0; // terminate
-    UART0_OutString(Messageb);
-  }
+  char buf[FORMAT_SIZE];
+  Format_UDec(buf, n, 5);       // "*****" above 99999
+  UART0_OutString(buf);
 }
+
 //-----------------------UART0_OutUFix1-----------------------
 // Output a 32-bit number in unsigned decimal format
 // Input: 32-bit number to be transferred
 // Output: none
 // fixed format <digit>.<digit> with no space before or after
 void UART0_OutUFix1(uint32_t n){
-  UART0_OutUDec(n/10);
-  UART0_OutChar('.');
-  UART0_OutUDec(n%10);
+  char buf[FORMAT_SIZE];
+  Format_UFix(buf, n, 1, 0);
+  UART0_OutString(buf);
 }
+
 //-----------------------UART0_OutUFix2-----------------------
 // Output a 32-bit number in unsigned decimal format
 // Input: 32-bit number to be transferred
 // Output: none
 // fixed format <digit>.<digit><digit> with no space before or after
 void UART0_OutUFix2(uint32_t n){
-  UART0_OutUDec(n/100);
-  UART0_OutChar('.');
-  n = n%100;
-  UART0_OutUDec(n/10);
-  UART0_OutUDec(n%10);
+  char buf[FORMAT_SIZE];
+  Format_UFix(buf, n, 2, 0);
+  UART0_OutString(buf);
 }
+
 //---------------------UART0_InUHex----------------------------------------
 // Accepts ASCII input in unsigned hexadecimal (base 16) format
 // Input: none
@@ -313,38 +259,22 @@ char character;
 // Output: none
 // Variable format 1 to 8 digits with no space before or after
 void UART0_OutUHex(uint32_t number){
-// This function uses recursion to convert the number of
-//   unspecified length as an ASCII string
-  if(number >= 0x10){
-    UART0_OutUHex(number/0x10);
-    UART0_OutUHex(number%0x10);
-  }
-  else{
-    if(number < 0xA){
-      UART0_OutChar(number+'0');
-     }
-    else{
-      UART0_OutChar((number-0x0A)+'A');
-    }
-  }
+  char buf[FORMAT_SIZE];
+  Format_UHex(buf, number, 0);
+  UART0_OutString(buf);
 }
+
 //--------------------------UART0_OutUHex2----------------------------
 // Output a 32-bit number in unsigned hexadecimal format
 // Input: 32-bit number to be transferred
 // Output: none
 // Fixed format 2 digits with no space before or after
-void outnibble(uint32_t n){
-    if(n < 0xA){
-   UART0_OutChar(n+'0');
-  }
-  else{
-    UART0_OutChar((n-0x0A)+'A');
-  }
-}
 void UART0_OutUHex2(uint32_t number){
-  outnibble(number/0x10); // ms digit
-  outnibble(number%0x10); // ls digit
+  char buf[FORMAT_SIZE];
+  Format_UHex(buf, number, 2);  // least significant byte
+  UART0_OutString(buf);
 }
+
 //------------UART0_InString------------
 // Accepts ASCII characters from the serial port
 //    and adds them to a string until <enter> is typed
@@ -380,6 +310,7 @@ char character;
   *bufPt = 0;
 }
 
+#ifdef __TI_COMPILER_VERSION__
 // Get input from UART, echo
 int fgetc (FILE *f){
   char ch = UART0_InChar();  // receive from keyboard
@@ -445,6 +376,16 @@ void UART0_Initprintf(void){int ret_val; FILE *fptr;
   freopen("uart:", "w", stdout); // redirect stdout to uart
   setvbuf(stdout, NULL, _IONBF, 0); // turn off buffering for stdout
 }
+#else
+//------------UART0_Initprintf------------
+// Other toolchains (for example the host build in ../host) keep
+// their own stdio, so only the UART is initialized.
+// Input: none
+// Output: none
+void UART0_Initprintf(void){
+  UART0_Init();
+}
+#endif
 /*
 // Keil uVision Code
 // Print a character to UART.
@@ -96,6 +96,24 @@ policies, either expressed or implied, of the FreeBSD Project.
  */
 void UART0_Init(void);
 
+/**
+ * @details   Initialize EUSCI_A0 for UART operation at any baud rate,
+ * @details   8 bit word length, no parity bits, one stop bit
+ * @param  brw   UCAxBRW, usually BAUD_BRW(baud) from Baud.h
+ * @param  mctlw UCAxMCTLW, usually BAUD_MCTLW(baud) from Baud.h
+ * @return none
+ * @note   assumes 48 MHz bus and 12 MHz SMCLK
+ * @note   UART0_Init() is UART0_InitBaud(115200); use 460,800 to 1,000,000 for telemetry
+ * @brief  Initialize EUSCI A0 at any baud rate
+ */
+void UART0_InitRate(uint16_t brw, uint16_t mctlw);
+
+/**
+ * \brief Initialize EUSCI A0 at a baud rate, see Baud.h; a constant rate is
+ * converted to register settings by the compiler
+ */
+#define UART0_InitBaud(baud) UART0_InitRate(BAUD_BRW(baud), BAUD_MCTLW(baud))
+
 
 /**
  * @details   Initializes C standard library, enables printf to work
@@ -51,50 +51,38 @@ policies, either expressed or implied, of the FreeBSD Project.
 // J1.4  from LaunchPad to Bluetooth (DIO2_RXD) (UART TxD){MSP432 P3.3}
 
 #include <stdint.h>
+#include "../inc/Baud.h"
+#include "../inc/FIFO.h"
 #include "UART1.h"
 #include "msp.h"
 
 #define FIFOSIZE   256       // size of the FIFOs (must be power of 2)
-#define FIFOSUCCESS 1        // return value on success
-#define FIFOFAIL    0        // return value on failure
-uint32_t RxPutI;      // should be 0 to SIZE-1
-uint32_t RxGetI;      // should be 0 to SIZE-1 
-uint32_t RxFifoLost;  // should be 0 
-uint8_t RxFIFO[FIFOSIZE];
-void RxFifo_Init(void){
-  RxPutI = RxGetI = 0;                      // empty
-  RxFifoLost = 0; // occurs on overflow
-}
-int RxFifo_Put(uint8_t data){
-  if(((RxPutI+1)&(FIFOSIZE-1)) == RxGetI){
-    RxFifoLost++;
-    return FIFOFAIL; // fail if full  
-  }    
-  RxFIFO[RxPutI] = data;                    // save in FIFO
-  RxPutI = (RxPutI+1)&(FIFOSIZE-1);         // next place to put
-  return FIFOSUCCESS;
-}
-int RxFifo_Get(uint8_t *datapt){ 
-  if(RxPutI == RxGetI) return 0;            // fail if empty
-  *datapt = RxFIFO[RxGetI];                 // retrieve data
-  RxGetI = (RxGetI+1)&(FIFOSIZE-1);         // next place to get
-  return FIFOSUCCESS; 
-}
+// RxFifo_Init, _Put, _Get, _Size and RxFifoLost (should be 0)
+AddIndexFifo(RxFifo, FIFOSIZE, uint8_t)
+// TxFifo_Init, _Put, _Get, _Size, _Room, _PutBlock and TxFifoLost
+AddIndexFifo(TxFifo, FIFOSIZE, uint8_t)
+void (*TxDoneTask)(void);     // user function run when output finishes
+static const uint8_t *volatile TxBlock;  // sent by the interrupt after TxFifo
+static volatile uint32_t TxBlockSize;    // bytes left in TxBlock
                     
 //------------UART1_InStatus------------
 // Returns how much data available for reading
 // Input: none
 // Output: number of bytes in receive FIFO
 uint32_t UART1_InStatus(void){  
- return ((RxPutI - RxGetI)&(FIFOSIZE-1));  
+ return RxFifo_Size();
 }
-//------------UART1_Init------------
-// Initialize the UART for 115,200 baud rate (assuming 12 MHz SMCLK clock),
+//------------UART1_InitRate------------
+// Initialize the UART for any baud rate (assuming 12 MHz SMCLK clock),
 // 8 bit word length, no parity bits, one stop bit
-// Input: none
+// Input: brw   UCA2BRW, see BAUD_BRW() in Baud.h
+//        mctlw UCA2MCTLW, see BAUD_MCTLW() in Baud.h
 // Output: none
-void UART1_Init(void){
+void UART1_InitRate(uint16_t brw, uint16_t mctlw){
   RxFifo_Init();              // initialize FIFOs
+  TxFifo_Init();
+  TxDoneTask = 0;
+  TxBlockSize = 0;
   EUSCI_A2->CTLW0 = 0x0001;         // hold the USCI module in reset mode
   // bit15=0,      no parity bits
   // bit14=x,      not used when parity is disabled
@@ -110,11 +98,8 @@ void UART1_Init(void){
   // bit1=0,       do not transmit break (not used here)
   // bit0=1,       hold logic in reset state while configuring
   EUSCI_A2->CTLW0 = 0x00C1;
-                              // set the baud rate
-                              // N = clock/baud rate = 12,000,000/115,200 = 104.1667
-  EUSCI_A2->BRW = 104;        // UCBR = baud rate = int(N) = 104
-
-  EUSCI_A2->MCTLW = 0x0000;   // clear first and second modulation stage bit fields
+  EUSCI_A2->BRW = brw;        // UCBRx, the integer part of the divider
+  EUSCI_A2->MCTLW = mctlw;    // UCBRSx, UCBRFx and UCOS16
 // since TxFifo is empty, we initially disarm interrupts on UCTXIFG, but arm it on OutChar
   P3->SEL0 |= 0x0C;
   P3->SEL1 &= ~0x0C;          // configure P3.3 and P3.2 as primary module function
@@ -125,6 +110,16 @@ void UART1_Init(void){
   EUSCI_A2->IE = 0x0001;      // disable interrupts on transmit empty, start, complete
 }
 
+//------------UART1_Init------------
+// Initialize the UART for 115,200 baud rate (assuming 12 MHz SMCLK clock),
+// 8 bit word length, no parity bits, one stop bit.  This is the rate
+// of the stock CC2650 SNP image, which has no command to change it.
+// Input: none
+// Output: none
+void UART1_Init(void){
+  UART1_InitBaud(115200);
+}
+
 
 //------------UART1_InChar------------
 // Wait for new serial port input, interrupt synchronization
@@ -138,17 +133,111 @@ uint8_t UART1_InChar(void){
 }
 
 ///------------UART1_OutChar------------
-// Output 8-bit to serial port, busy-wait
+// Output 8-bit to serial port, interrupt synchronization
 // Input: letter is an 8-bit data to be transferred
 // Output: none
+// spin if TxFifo is full
 void UART1_OutChar(uint8_t data){
-  while((EUSCI_A2->IFG&0x02) == 0);
-  EUSCI_A2->TXBUF = data;
+  while(TxFifo_Room() == 0){
+    EUSCI_A2->IE = 0x0003;    // full, keep the transmit interrupt draining it
+  }
+  TxFifo_Put(data);           // fits, so it is not counted in TxFifoLost
+  EUSCI_A2->IE = 0x0003;      // enable interrupts on transmit empty and receive full
+}
+
+//------------UART1_OutBuffer------------
+// Queue a block of bytes for output and return; the
+// transmit interrupt sends them in the background
+// Input: pt is a pointer to the data
+//        size is the number of bytes
+// Output: none
+// spin only while the block does not fit in TxFifo
+void UART1_OutBuffer(const uint8_t *pt, uint32_t size){
+  uint32_t n;
+  while(size){
+    n = TxFifo_Room();        // spin if full
+    if(n > size) n = size;
+    if(n){
+      TxFifo_PutBlock(pt, n); // fits, so it is not counted in TxFifoLost
+      pt = pt + n;
+      size = size - n;
+    }
+    EUSCI_A2->IE = 0x0003;    // enable interrupts on transmit empty and receive full
+  }
+}
+
+//------------UART1_OutBlock------------
+// Send a block of bytes straight from memory and return;
+// the transmit interrupt reads them after any bytes in TxFifo
+// Input: pt is a pointer to the data, which must not change
+//           until UART1_OutStatus is 0 or the TxDone task runs
+//        size is the number of bytes
+// Output: none
+// spin only while an earlier block is still going out
+void UART1_OutBlock(const uint8_t *pt, uint32_t size){
+  if(size == 0) return;       // nothing to send, so no TxDone either
+  while(TxBlockSize);
+  TxBlock = pt;
+  TxBlockSize = size;         // publish last
+  EUSCI_A2->IE = 0x0003;      // enable interrupts on transmit empty and receive full
+}
+
+//------------UART1_SetTxDone------------
+// Set the function run when the last queued byte has
+// left the transmit shift register
+// Input: task is a pointer to a user function (0 for none), run in the interrupt
+// Output: none
+void UART1_SetTxDone(void(*task)(void)){
+  TxDoneTask = task;
+}
+
+//------------UART1_OutStatus------------
+// Check whether output is still in progress
+// Input: none
+// Output: 0 if all output has been sent, nonzero while sending
+uint32_t UART1_OutStatus(void){
+  return EUSCI_A2->IE&0x000A;    // transmit empty or transmit complete armed
+}
+
+static void txDone(void){
+  EUSCI_A2->IE = 0x0001;         // disable interrupts on transmit empty, complete
+  if(TxDoneTask){
+    (*TxDoneTask)();             // execute user task
+  }
 }
 // interrupt 18 occurs on :
+// UCTXIFG TX data register is empty
+// UCTXCPTIFG TX shift register is empty, armed after the last byte
 // UCRXIFG RX data register is full
 // vector at 0x00000088 in startup_msp432.s
-void EUSCIA2_IRQHandler(void){
+void EUSCIA2_IRQHandler(void){ uint8_t data;
+  if((EUSCI_A2->IE&0x02) && (EUSCI_A2->IFG&0x02)){   // TX data register empty
+    if(TxFifo_Get(&data) == FIFOSUCCESS){
+      EUSCI_A2->TXBUF = data;        // send data, acknowledge interrupt
+    }else if(TxBlockSize){
+      EUSCI_A2->TXBUF = *TxBlock;    // send from the block, no copy
+      TxBlock = TxBlock + 1;
+      TxBlockSize = TxBlockSize - 1;
+    }else{
+      // the last byte is in the shift register, wait for it to finish
+      EUSCI_A2->IFG &= ~0x08;        // clear stale UCTXCPTIFG
+      if(EUSCI_A2->STATW&0x01){      // UCBUSY, still shifting
+        EUSCI_A2->IE = 0x0009;       // enable interrupts on transmit complete and receive full
+      }else{
+        txDone();
+      }
+    }
+  }
+  if((EUSCI_A2->IE&0x08) && (EUSCI_A2->IFG&0x08)){   // TX shift register empty
+    EUSCI_A2->IFG &= ~0x08;
+    if(TxFifo_Size() || TxBlockSize){
+      // main queued more before it could rearm UCTXIFG; send that first,
+      // so the TxDone task runs once, after the last byte
+      EUSCI_A2->IE = 0x0003;         // enable interrupts on transmit empty and receive full
+    }else{
+      txDone();
+    }
+  }
   if(EUSCI_A2->IFG&0x01){             // RX data register full
     RxFifo_Put((uint8_t)EUSCI_A2->RXBUF);// clears UCRXIFG
   } 
@@ -159,16 +248,17 @@ void EUSCIA2_IRQHandler(void){
 // Input: pointer to a NULL-terminated string to be transferred
 // Output: none
 void UART1_OutString(uint8_t *pt){
-  while(*pt){
-    UART1_OutChar(*pt);
-    pt++;
+  uint32_t size = 0;
+  while(pt[size]){
+    size++;
   }
+  UART1_OutBuffer(pt, size);
 }
 //------------UART1_FinishOutput------------
 // Wait for all transmission to finish
 // Input: none
 // Output: none
 void UART1_FinishOutput(void){
-  // Wait for entire tx message to be sent
-  while((EUSCI_A2->IFG&0x02) == 0);
+  // Wait for entire tx message to be sent, including the last stop bit
+  while(UART1_OutStatus());
 }
@@ -92,6 +92,24 @@ policies, either expressed or implied, of the FreeBSD Project.
  */
 void UART1_Init(void);
 
+/**
+ * @details   Initialize EUSCI_A2 for UART operation at any baud rate,
+ * @details   8 bit word length, no parity bits, one stop bit
+ * @param  brw   UCAxBRW, usually BAUD_BRW(baud) from Baud.h
+ * @param  mctlw UCAxMCTLW, usually BAUD_MCTLW(baud) from Baud.h
+ * @return none
+ * @note   assumes 48 MHz bus and 12 MHz SMCLK
+ * @note   the stock CC2650 SNP image runs at 115200 only, so AP_Init() uses UART1_Init()
+ * @brief  Initialize EUSCI A2 at any baud rate
+ */
+void UART1_InitRate(uint16_t brw, uint16_t mctlw);
+
+/**
+ * \brief Initialize EUSCI A2 at a baud rate, see Baud.h; a constant rate is
+ * converted to register settings by the compiler
+ */
+#define UART1_InitBaud(baud) UART1_InitRate(BAUD_BRW(baud), BAUD_MCTLW(baud))
+
 /**
  * @details   Receive a character from EUSCI_A2 UART
  * @details   Interrupt synchronization,
@@ -105,8 +123,8 @@ uint8_t UART1_InChar(void);
 
 /**
  * @details   Transmit a character to EUSCI_A2 UART
- * @details   Busy-wait synchronization,
- * @details   blocking, wait for UART to be ready
+ * @details   Interrupt synchronization,
+ * @details   blocking only if TxFifo is full
  * @param  data is the ASCII code for data to send
  * @return none
  * @note   UART1_Init must be called once prior
@@ -114,6 +132,53 @@ uint8_t UART1_InChar(void);
  */
 void UART1_OutChar(uint8_t data);
 
+/**
+ * @details   Queue a block of bytes for EUSCI_A2 UART and return.
+ * @details   The transmit interrupt sends them in the background,
+ * @details   blocking only while the block does not fit in TxFifo
+ * @param  pt is a pointer to the data
+ * @param  size is the number of bytes
+ * @return none
+ * @note   UART1_Init must be called once prior
+ * @brief  Transmit a block out of MSP432
+ */
+void UART1_OutBuffer(const uint8_t *pt, uint32_t size);
+
+/**
+ * @details   Send a block of bytes for EUSCI_A2 UART straight from memory
+ * @details   and return.  The transmit interrupt reads them after any
+ * @details   bytes already in TxFifo, so nothing is copied.  The block
+ * @details   must not change until UART1_OutStatus() is 0 or the task
+ * @details   set by UART1_SetTxDone() runs.  Spins only while an
+ * @details   earlier block is still going out.  An empty block sends
+ * @details   nothing and does not run the task.
+ * @param  pt is a pointer to the data
+ * @param  size is the number of bytes
+ * @return none
+ * @note   UART1_Init must be called once prior
+ * @brief  Transmit a block out of MSP432 without copying it
+ */
+void UART1_OutBlock(const uint8_t *pt, uint32_t size);
+
+/**
+ * @details   Set the function run from the EUSCI_A2 interrupt when the
+ * @details   last queued byte, including its stop bit, has been sent
+ * @param  task is a pointer to a user function (0 for none)
+ * @return none
+ * @note   UART1_Init clears the function
+ * @brief  Set transmit complete function
+ */
+void UART1_SetTxDone(void(*task)(void));
+
+/**
+ * @details   Check whether EUSCI_A2 UART output is still in progress
+ * @details   non-blocking
+ * @param  none
+ * @return 0 if all output has been sent, nonzero while sending
+ * @brief  Check status of transmitter
+ */
+uint32_t UART1_OutStatus(void);
+
 /**
  * @details   Transmit a string to EUSCI_A2 UART
  * @param  pt is pointer to null-terminated ASCII string to be transferred